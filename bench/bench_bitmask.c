@@ -0,0 +1,124 @@
+// Collision mask overlap check: random pairs of the loaded asteroid shapes at
+// every scale bucket (against a partner of any bucket, the way rocks of
+// different sizes meet in the field), at offsets spanning everything from
+// disjoint bounds to full cover. Each pair is answered by the pixel-by-pixel
+// BitMask_OverlapReference, the word-parallel BitMask_Overlap and the
+// coarse-to-fine CollisionShape_Overlap; reports ns per test of each and the
+// share of pairs that hit. Exits non-zero if either fast path disagrees with
+// the reference on any pair.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_bitmask [pairs_per_bucket]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "collision_shape.h"
+
+#define BENCH_SEED 42u
+// Offsets reach this many pixels past touching bounds so near misses are
+// tested too.
+#define BENCH_MARGIN 8
+
+typedef struct OverlapPair
+{
+    const CollisionShape *a;
+    const CollisionShape *b;
+    int offset_x;
+    int offset_y;
+} OverlapPair;
+
+static unsigned NextRandom(unsigned *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static int RandomRange(unsigned *state, int lo, int hi)
+{
+    return lo + (int)(NextRandom(state) % (unsigned)(hi - lo + 1));
+}
+
+static double NsPerTest(uint64_t start, uint64_t end, int tests)
+{
+    return (tests > 0) ? (double)(end - start) / tests : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    int pairs = (argc > 1) ? atoi(argv[1]) : 2000;
+    if (pairs < 1) pairs = 2000;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem system;
+    Asteroids_Init(&system, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (system.asset_count == 0)
+    {
+        fprintf(stderr, "bench_bitmask: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+    OverlapPair *tests = malloc((size_t)pairs * sizeof(OverlapPair));
+    int *expected = malloc((size_t)pairs * sizeof(int));
+    if (tests == NULL || expected == NULL)
+    {
+        fprintf(stderr, "bench_bitmask: out of memory\n");
+        return 1;
+    }
+
+    unsigned state = BENCH_SEED;
+    int mismatches = 0;
+    printf("assets=%d pairs/bucket=%d\n", system.asset_count, pairs);
+    printf("%-6s %6s %8s %13s %11s %9s %10s\n", "bucket", "scale", "hits", "reference_ns", "overlap_ns",
+           "shape_ns", "mismatch");
+    for (int bucket = 0; bucket < ASTEROID_SCALE_BUCKETS; bucket++)
+    {
+        for (int i = 0; i < pairs; i++)
+        {
+            OverlapPair *pair = &tests[i];
+            pair->a = &system.assets[RandomRange(&state, 0, system.asset_count - 1)].shapes[bucket];
+            int partner_bucket = RandomRange(&state, 0, ASTEROID_SCALE_BUCKETS - 1);
+            pair->b = &system.assets[RandomRange(&state, 0, system.asset_count - 1)].shapes[partner_bucket];
+            pair->offset_x = RandomRange(&state, -pair->a->fine.width - BENCH_MARGIN, pair->b->fine.width + BENCH_MARGIN);
+            pair->offset_y = RandomRange(&state, -pair->a->fine.height - BENCH_MARGIN, pair->b->fine.height + BENCH_MARGIN);
+        }
+
+        int hits = 0;
+        uint64_t t0 = Clock_NowNs();
+        for (int i = 0; i < pairs; i++)
+        {
+            const OverlapPair *pair = &tests[i];
+            expected[i] = BitMask_OverlapReference(&pair->a->fine, &pair->b->fine, pair->offset_x, pair->offset_y);
+            hits += expected[i];
+        }
+        uint64_t t1 = Clock_NowNs();
+        int bucket_mismatches = 0;
+        for (int i = 0; i < pairs; i++)
+        {
+            const OverlapPair *pair = &tests[i];
+            int hit = BitMask_Overlap(&pair->a->fine, &pair->b->fine, pair->offset_x, pair->offset_y);
+            bucket_mismatches += (hit != 0) != (expected[i] != 0);
+        }
+        uint64_t t2 = Clock_NowNs();
+        for (int i = 0; i < pairs; i++)
+        {
+            const OverlapPair *pair = &tests[i];
+            int hit = CollisionShape_Overlap(pair->a, pair->b, pair->offset_x, pair->offset_y, NULL);
+            bucket_mismatches += (hit != 0) != (expected[i] != 0);
+        }
+        uint64_t t3 = Clock_NowNs();
+
+        printf("%-6d %6.2f %7.1f%% %13.1f %11.1f %9.1f %10d\n", bucket, Asteroids_BucketScale(bucket),
+               100.0 * hits / pairs, NsPerTest(t0, t1, pairs), NsPerTest(t1, t2, pairs), NsPerTest(t2, t3, pairs),
+               bucket_mismatches);
+        mismatches += bucket_mismatches;
+    }
+    printf("overlap vs reference: %s\n", (mismatches == 0) ? "OK" : "MISMATCH");
+
+    free(tests);
+    free(expected);
+    Asteroids_Unload(&system);
+    AssetPack_Unmount();
+    return (mismatches == 0) ? 0 : 1;
+}
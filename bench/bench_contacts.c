@@ -0,0 +1,184 @@
+// Contact response benchmark: a crowded field of rocks that keep running into
+// each other, stepped at the fixed sim rate with bouncing collisions.
+// Reports ms per update (mean, p95, max) against the SIM_DT tick budget,
+// contacts per tick, how many rocks were in a contact at some point, how deep
+// the rocks still overlap at the end and how much of the starting kinetic
+// energy is left. The same run on one thread and on `threads` must end
+// bit-identical. Exits non-zero if a rock is lost, the runs differ, or the
+// mean update does not fit in the tick budget.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_contacts [asteroids] [seconds] [threads]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "job_system.h"
+#include "world.h"
+
+#define BENCH_SEED 42u
+// Twice headless --asteroids' density: most rocks touch a neighbour within a
+// few seconds.
+#define BENCH_AREA_PER_ROCK (212.0f * 212.0f)
+#define BENCH_SPEED 60.0f
+
+typedef struct BenchResult
+{
+    double *tick_ms;
+    int ticks;
+    long long contacts;
+    int collided;
+    int count;
+    float mean_depth;
+    float max_depth;
+    double start_energy;
+    double end_energy;
+    uint64_t checksum;
+} BenchResult;
+
+static int CompareDoubles(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static double KineticEnergy(const AsteroidSystem *system)
+{
+    const AsteroidColumns *c = &system->columns;
+    double energy = 0.0;
+    for (int i = 0; i < system->pool.count; i++)
+    {
+        int area = system->assets[c->asset_index[i]].shapes[c->scale_bucket[i]].area;
+        energy += 0.5 * area * ((double)c->vel_x[i] * c->vel_x[i] + (double)c->vel_y[i] * c->vel_y[i]);
+    }
+    return energy;
+}
+
+static uint64_t Checksum(const AsteroidSystem *system)
+{
+    const AsteroidColumns *c = &system->columns;
+    const float *columns[] = { c->pos_x, c->pos_y, c->vel_x, c->vel_y };
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t k = 0; k < sizeof(columns) / sizeof(columns[0]); k++)
+    {
+        const unsigned char *bytes = (const unsigned char *)columns[k];
+        for (size_t i = 0; i < (size_t)system->pool.count * sizeof(float); i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+static BenchResult Run(const AsteroidSystem *source, JobSystem *jobs, int asteroids, double seconds)
+{
+    BenchResult result = {0};
+    AsteroidSystem system;
+    Asteroids_InitShared(&system, source, BENCH_SEED);
+    system.jobs = jobs;
+    system.stream_sectors = 0;
+    system.speed = BENCH_SPEED;
+    Vector2 center = { 0.0f, 0.0f };
+    Asteroids_SpawnField(&system, center, asteroids, sqrtf((float)asteroids * BENCH_AREA_PER_ROCK / PI));
+    result.start_energy = KineticEnergy(&system);
+
+    result.ticks = (int)lround(seconds / SIM_DT);
+    result.tick_ms = (double *)malloc((size_t)result.ticks * sizeof(double));
+    // Nothing spawns or dies, so slot indices name rocks for the whole run.
+    unsigned char *touched = (unsigned char *)calloc((size_t)system.pool.slot_count, 1);
+    for (int t = 0; t < result.ticks; t++)
+    {
+        uint64_t t0 = Clock_NowNs();
+        Asteroids_Update(&system, SIM_DT, center);
+        result.tick_ms[t] = (double)(Clock_NowNs() - t0) / 1e6;
+        result.contacts += system.collision_count;
+        for (int i = 0; i < system.collision_count; i++)
+        {
+            touched[system.collisions[i].a.index] = 1;
+            touched[system.collisions[i].b.index] = 1;
+        }
+    }
+    for (int slot = 0; slot < system.pool.slot_count; slot++) result.collided += touched[slot];
+    free(touched);
+
+    // Depths of the last update's contacts: what the solver left over.
+    double depth_sum = 0.0;
+    for (int i = 0; i < system.collision_count; i++)
+    {
+        depth_sum += system.collisions[i].depth;
+        if (system.collisions[i].depth > result.max_depth) result.max_depth = system.collisions[i].depth;
+    }
+    result.mean_depth = (system.collision_count > 0) ? (float)(depth_sum / system.collision_count) : 0.0f;
+    result.count = Asteroids_Count(&system);
+    result.end_energy = KineticEnergy(&system);
+    result.checksum = Checksum(&system);
+    Asteroids_Unload(&system);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int asteroids = (argc > 1) ? atoi(argv[1]) : 10000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 5.0;
+    int threads = (argc > 3) ? atoi(argv[3]) : 4;
+    if (asteroids < 1) asteroids = 10000;
+    if (seconds <= 0.0) seconds = 5.0;
+    if (threads < 1) threads = 1;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem source;
+    Asteroids_Init(&source, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (source.asset_count == 0)
+    {
+        fprintf(stderr, "bench_contacts: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+
+    JobSystem serial;
+    JobSystem_Init(&serial, 1);
+    BenchResult reference = Run(&source, &serial, asteroids, seconds);
+    JobSystem_Shutdown(&serial);
+
+    JobSystem jobs;
+    JobSystem_Init(&jobs, threads);
+    BenchResult result = Run(&source, &jobs, asteroids, seconds);
+    threads = JobSystem_ThreadCount(&jobs);
+    JobSystem_Shutdown(&jobs);
+
+    double budget_ms = SIM_DT * 1000.0;
+    BenchResult *runs[] = { &reference, &result };
+    const int run_threads[] = { 1, threads };
+    int within_budget = 1;
+    printf("asteroids=%d seconds=%.1f ticks=%d budget=%.2f ms/tick\n", asteroids, seconds, result.ticks, budget_ms);
+    printf("%-8s %9s %9s %9s %13s %8s %7s %10s %10s %8s\n", "threads", "mean_ms", "p95_ms", "max_ms", "contacts/tick",
+           "collided", "rocks", "mean_depth", "max_depth", "energy");
+    for (int r = 0; r < 2; r++)
+    {
+        BenchResult *run = runs[r];
+        double sum = 0.0;
+        for (int t = 0; t < run->ticks; t++) sum += run->tick_ms[t];
+        double mean = sum / run->ticks;
+        qsort(run->tick_ms, (size_t)run->ticks, sizeof(double), CompareDoubles);
+        printf("%-8d %9.3f %9.3f %9.3f %13.1f %8d %7d %10.2f %10.2f %7.0f%%\n", run_threads[r], mean,
+               run->tick_ms[(int)(0.95 * (run->ticks - 1))], run->tick_ms[run->ticks - 1],
+               (double)run->contacts / run->ticks, run->collided, run->count, run->mean_depth, run->max_depth,
+               (run->start_energy > 0.0) ? 100.0 * run->end_energy / run->start_energy : 0.0);
+        if (run == &result && mean > budget_ms) within_budget = 0;
+    }
+
+    int kept = reference.count == asteroids && result.count == asteroids;
+    int deterministic = reference.checksum == result.checksum;
+    printf("rocks kept: %s, 1 vs %d threads: %s, mean update within budget: %s\n", kept ? "OK" : "LOST", threads,
+           deterministic ? "identical" : "MISMATCH", within_budget ? "OK" : "OVER");
+
+    free(reference.tick_ms);
+    free(result.tick_ms);
+    Asteroids_Unload(&source);
+    AssetPack_Unmount();
+    return (kept && deterministic && within_budget) ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+// Asteroid subsystem benchmark over parameterised fields: Asteroids_Update
+// (integration, broadphase, mask narrowphase, compaction, query index),
+// Asteroids_FindClosest and Asteroids_SpawnField, for 128 to 100k rocks at
+// several densities, scale mixes and asset counts. Reports ns/tick,
+// ns/entity, pair tests per tick and heap allocations as JSON on stdout (a
+// readable table goes to stderr) so CI can diff runs between commits.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_engine [work_scale] [threads]
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "job_system.h"
+#include "world.h"
+
+#define BENCH_SEED 42u
+// Rock-ticks per scenario at work_scale 1, within the tick limits below.
+#define BENCH_WORK 2000000.0
+#define BENCH_MIN_TICKS 20
+#define BENCH_MAX_TICKS 120
+#define BENCH_WARMUP_TICKS 5
+#define BENCH_QUERIES_PER_TICK 64
+#define BENCH_QUERY_RANGE 520.0f
+// Field area per rock at density 1 (headless --asteroids uses the same).
+#define BENCH_AREA_PER_ROCK (300.0f * 300.0f)
+
+typedef enum BenchScale
+{
+    BENCH_SCALE_MIXED,
+    BENCH_SCALE_SMALL,
+    BENCH_SCALE_LARGE
+} BenchScale;
+
+static const char *const BENCH_SCALE_NAMES[] = { "mixed", "small", "large" };
+
+typedef struct BenchScenario
+{
+    int count;
+    float density;
+    BenchScale scale;
+    // 0 for every loaded asset.
+    int assets;
+} BenchScenario;
+
+// With BENCH_COUNT_ALLOCS the target links with -Wl,--wrap for the allocator
+// entry points, so every malloc/calloc/realloc in the process lands here.
+#ifdef BENCH_COUNT_ALLOCS
+static atomic_llong alloc_calls;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *data, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *data, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+    return __real_realloc(data, size);
+}
+
+static long long AllocCalls(void)
+{
+    return atomic_load_explicit(&alloc_calls, memory_order_relaxed);
+}
+#else
+static long long AllocCalls(void)
+{
+    return -1;
+}
+#endif
+
+static volatile uint32_t sink;
+
+static float Random01(unsigned *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
+
+// Forces every rock to one end of the scale range, keeping the collision
+// shape bucket consistent with the drawn scale.
+static void ApplyScale(AsteroidSystem *system, BenchScale scale)
+{
+    if (scale == BENCH_SCALE_MIXED) return;
+    int bucket = (scale == BENCH_SCALE_SMALL) ? 0 : ASTEROID_SCALE_BUCKETS - 1;
+    AsteroidColumns *c = &system->columns;
+    for (int i = 0; i < system->pool.count; i++)
+    {
+        c->scale_bucket[i] = bucket;
+        c->scale[i] = Asteroids_BucketScale(bucket);
+    }
+}
+
+static void RunScenario(const AsteroidSystem *source, JobSystem *jobs, const BenchScenario *scenario,
+                        double work_scale, int first)
+{
+    float radius = sqrtf((float)scenario->count * BENCH_AREA_PER_ROCK / scenario->density / PI);
+    Vector2 center = { 0.0f, 0.0f };
+    int ticks = (int)(BENCH_WORK * work_scale / scenario->count);
+    if (ticks < BENCH_MIN_TICKS) ticks = BENCH_MIN_TICKS;
+    if (ticks > BENCH_MAX_TICKS) ticks = BENCH_MAX_TICKS;
+
+    AsteroidSystem system;
+    Asteroids_InitShared(&system, source, BENCH_SEED);
+    system.jobs = jobs;
+    if (scenario->assets > 0 && scenario->assets < system.rock_count) system.rock_count = scenario->assets;
+    // Only the field: no sectors streaming in mid-measurement.
+    system.stream_sectors = 0;
+
+    long long allocs_before = AllocCalls();
+    uint64_t t0 = Clock_NowNs();
+    Asteroids_SpawnField(&system, center, scenario->count, radius);
+    uint64_t spawn_ns = Clock_NowNs() - t0;
+    long long spawn_allocs = (allocs_before < 0) ? -1 : AllocCalls() - allocs_before;
+    ApplyScale(&system, scenario->scale);
+
+    for (int t = 0; t < BENCH_WARMUP_TICKS; t++) Asteroids_Update(&system, SIM_DT, center);
+
+    long long candidate_pairs = 0;
+    long long narrowphase_tests = 0;
+    long long collisions = 0;
+    long long entity_ticks = 0;
+    uint64_t update_ns = 0;
+    uint64_t query_ns = 0;
+    unsigned rng = 12345u;
+    allocs_before = AllocCalls();
+    for (int t = 0; t < ticks; t++)
+    {
+        entity_ticks += system.pool.count;
+        t0 = Clock_NowNs();
+        Asteroids_Update(&system, SIM_DT, center);
+        update_ns += Clock_NowNs() - t0;
+        candidate_pairs += system.stats.broadphase.candidate_pairs;
+        narrowphase_tests += system.stats.narrowphase_tests;
+        collisions += system.stats.collisions;
+
+        Vector2 points[BENCH_QUERIES_PER_TICK];
+        for (int q = 0; q < BENCH_QUERIES_PER_TICK; q++)
+        {
+            points[q] = (Vector2){ (Random01(&rng) * 2.0f - 1.0f) * radius, (Random01(&rng) * 2.0f - 1.0f) * radius };
+        }
+        t0 = Clock_NowNs();
+        for (int q = 0; q < BENCH_QUERIES_PER_TICK; q++)
+        {
+            sink += Asteroids_FindClosest(&system, points[q], BENCH_QUERY_RANGE, NULL).index;
+        }
+        query_ns += Clock_NowNs() - t0;
+    }
+    long long tick_allocs = (allocs_before < 0) ? -1 : AllocCalls() - allocs_before;
+
+    char name[64];
+    snprintf(name, sizeof(name), "n%d_d%.2f_%s_a%d", scenario->count, scenario->density,
+             BENCH_SCALE_NAMES[scenario->scale], system.rock_count);
+    double ns_per_tick = (double)update_ns / ticks;
+    double ns_per_entity = (entity_ticks > 0) ? (double)update_ns / (double)entity_ticks : 0.0;
+    double ns_per_query = (double)query_ns / ((double)ticks * BENCH_QUERIES_PER_TICK);
+    double spawn_ns_per_entity = (double)spawn_ns / scenario->count;
+    double allocs_per_tick = (tick_allocs < 0) ? -1.0 : (double)tick_allocs / ticks;
+
+    fprintf(stderr, "%-26s %4d ticks  %10.0f ns/tick  %7.1f ns/entity  %9.1f cand/tick  %8.1f tests/tick  "
+            "%7.0f ns/closest  %6.1f ns/spawn  allocs/tick=%.2f spawn_allocs=%lld\n",
+            name, ticks, ns_per_tick, ns_per_entity, (double)candidate_pairs / ticks, (double)narrowphase_tests / ticks,
+            ns_per_query, spawn_ns_per_entity, allocs_per_tick, spawn_allocs);
+    printf("%s    {\"name\": \"%s\", \"count\": %d, \"density\": %.2f, \"scale\": \"%s\", \"assets\": %d, "
+           "\"ticks\": %d, \"final_count\": %d, \"ns_per_tick\": %.1f, \"ns_per_entity\": %.2f, "
+           "\"candidate_pairs_per_tick\": %.2f, \"narrowphase_tests_per_tick\": %.2f, \"collisions_per_tick\": %.2f, "
+           "\"closest_ns_per_query\": %.1f, \"spawn_ns_per_entity\": %.2f, \"allocs_per_tick\": %.3f, "
+           "\"spawn_allocs\": %lld}",
+           first ? "" : ",\n", name, scenario->count, scenario->density, BENCH_SCALE_NAMES[scenario->scale],
+           system.rock_count, ticks, system.pool.count, ns_per_tick, ns_per_entity,
+           (double)candidate_pairs / ticks, (double)narrowphase_tests / ticks, (double)collisions / ticks, ns_per_query,
+           spawn_ns_per_entity, allocs_per_tick, spawn_allocs);
+    fflush(stdout);
+
+    Asteroids_Unload(&system);
+}
+
+int main(int argc, char **argv)
+{
+    double work_scale = (argc > 1) ? atof(argv[1]) : 1.0;
+    int threads = (argc > 2) ? atoi(argv[2]) : 1;
+    if (work_scale <= 0.0) work_scale = 1.0;
+    if (threads < 1) threads = 1;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem source;
+    Asteroids_Init(&source, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (source.asset_count == 0)
+    {
+        fprintf(stderr, "bench_engine: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+    JobSystem jobs;
+    JobSystem_Init(&jobs, threads);
+
+    // Size sweep at the default mix, then density, scale and asset-count
+    // variations around a mid-size field.
+    BenchScenario scenarios[32];
+    int scenario_count = 0;
+    const int counts[] = { 128, 1024, 10000, 100000 };
+    const float densities[] = { 0.5f, 1.0f, 4.0f };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        for (size_t d = 0; d < sizeof(densities) / sizeof(densities[0]); d++)
+        {
+            scenarios[scenario_count++] = (BenchScenario){ counts[c], densities[d], BENCH_SCALE_MIXED, 0 };
+        }
+    }
+    scenarios[scenario_count++] = (BenchScenario){ 10000, 1.0f, BENCH_SCALE_SMALL, 0 };
+    scenarios[scenario_count++] = (BenchScenario){ 10000, 1.0f, BENCH_SCALE_LARGE, 0 };
+    scenarios[scenario_count++] = (BenchScenario){ 10000, 1.0f, BENCH_SCALE_MIXED, 1 };
+    scenarios[scenario_count++] = (BenchScenario){ 10000, 1.0f, BENCH_SCALE_MIXED, 4 };
+
+    printf("{\"benchmark\": \"bench_engine\", \"threads\": %d, \"work_scale\": %.3f, \"asset_count\": %d, "
+           "\"counts_allocs\": %s, \"scenarios\": [\n",
+           JobSystem_ThreadCount(&jobs), work_scale, source.rock_count, (AllocCalls() >= 0) ? "true" : "false");
+    for (int i = 0; i < scenario_count; i++) RunScenario(&source, &jobs, &scenarios[i], work_scale, i == 0);
+    printf("\n]}\n");
+
+    JobSystem_Shutdown(&jobs);
+    Asteroids_Unload(&source);
+    AssetPack_Unmount();
+    return 0;
+}
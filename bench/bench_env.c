@@ -0,0 +1,104 @@
+// Vectorised env throughput: env-steps/sec for a range of world counts and
+// thread counts, with random actions. The checksum covers every observation,
+// reward and done flag, so it must match across thread counts.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_env [env_steps_per_run] [threads]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "clock.h"
+#include "job_system.h"
+#include "rng.h"
+#include "vec_env.h"
+
+#define BENCH_SEED 42u
+#define BENCH_FIELD_ASTEROIDS 16
+
+static uint64_t HashFloats(uint64_t hash, const float *values, int count)
+{
+    const unsigned char *bytes = (const unsigned char *)values;
+    for (size_t i = 0; i < (size_t)count * sizeof(float); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static int RunConfig(int world_count, int threads, long long env_steps)
+{
+    VecEnvConfig config = { world_count, threads, BENCH_SEED, 600, BENCH_FIELD_ASTEROIDS };
+    VecEnv env;
+    if (!VecEnv_Create(&env, &config))
+    {
+        fprintf(stderr, "bench_env: could not create worlds (run from the repository root)\n");
+        return 0;
+    }
+
+    float *obs = malloc((size_t)world_count * VEC_ENV_OBS_DIM * sizeof(float));
+    float *rewards = malloc((size_t)world_count * sizeof(float));
+    float *dones = malloc((size_t)world_count * sizeof(float));
+    int *actions = malloc((size_t)world_count * sizeof(int));
+    Rng rng = Rng_Create(BENCH_SEED, 99u);
+
+    VecEnv_Reset(&env, BENCH_SEED, obs);
+    int calls = (int)((env_steps + world_count - 1) / world_count);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    double reward_sum = 0.0;
+    int episodes = 0;
+
+    // Only VecEnv_Step is timed; drawing actions and hashing are not.
+    uint64_t step_ns = 0;
+    for (int c = 0; c < calls; c++)
+    {
+        for (int i = 0; i < world_count; i++) actions[i] = Rng_RangeInt(&rng, 0, VEC_ENV_ACTION_COUNT - 1);
+        uint64_t t0 = Clock_NowNs();
+        VecEnv_Step(&env, actions, obs, rewards, dones);
+        step_ns += Clock_NowNs() - t0;
+        hash = HashFloats(hash, obs, world_count * VEC_ENV_OBS_DIM);
+        hash = HashFloats(hash, rewards, world_count);
+        hash = HashFloats(hash, dones, world_count);
+        for (int i = 0; i < world_count; i++)
+        {
+            reward_sum += rewards[i];
+            episodes += dones[i] != 0.0f;
+        }
+    }
+
+    double seconds = (double)step_ns / 1e9;
+    double steps = (double)calls * world_count;
+    printf("%6d worlds  %2d threads  %10.0f env-steps/s  %7.2f us/step  episodes=%d reward=%.1f  checksum=%016llx\n",
+           world_count, JobSystem_ThreadCount(&env.jobs), (seconds > 0.0) ? steps / seconds : 0.0,
+           (steps > 0.0) ? seconds * 1e6 / steps : 0.0, episodes, reward_sum, (unsigned long long)hash);
+
+    VecEnv_Destroy(&env);
+    free(obs);
+    free(rewards);
+    free(dones);
+    free(actions);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    long long env_steps = (argc > 1) ? atoll(argv[1]) : 200000;
+    int threads = (argc > 2) ? atoi(argv[2]) : JobSystem_DefaultThreadCount();
+    if (env_steps <= 0) env_steps = 200000;
+    if (threads < 1) threads = 1;
+
+    // Cooked masks when available; the PNG path works too, just slower to start.
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    printf("obs_dim=%d actions=%d field=%d episode=600 ticks\n",
+           VEC_ENV_OBS_DIM, VEC_ENV_ACTION_COUNT, BENCH_FIELD_ASTEROIDS);
+    const int world_counts[] = { 1, 16, 64, 256, 1024 };
+    for (size_t i = 0; i < sizeof(world_counts) / sizeof(world_counts[0]); i++)
+    {
+        if (!RunConfig(world_counts[i], 1, env_steps)) return 1;
+        if (threads > 1 && !RunConfig(world_counts[i], threads, env_steps)) return 1;
+    }
+    AssetPack_Unmount();
+    return 0;
+}
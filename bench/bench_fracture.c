@@ -0,0 +1,150 @@
+// Fracture benchmark: what cutting the rocks costs at load (Voronoi cells,
+// components, piece images and their shapes, per rock, from the pack's
+// pixels) against what breaking one costs at runtime, which only copies
+// fragments out of the tables. Destroys every rock of a field, then every
+// fragment, and checks the counts: each rock leaves exactly its asset's
+// fragments, fragments leave nothing, and no asset hands out more than its
+// rock's hit points. Exits non-zero if any check fails.
+// Run from the repository root (loads the asteroid masks and the pack).
+// Usage: bench_fracture [asteroids]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "fracture.h"
+
+#define BENCH_SEED 42u
+#define BENCH_AREA_PER_ROCK (300.0f * 300.0f)
+
+// Cuts every rock in the mounted pack from its pixels, the way a load
+// without cooked tables does. Returns ms per rock, or -1 if there is no pack.
+static double CutCost(int *out_rocks)
+{
+    const AssetPack *pack = AssetPack_Mounted();
+    *out_rocks = 0;
+    if (pack == NULL) return -1.0;
+    size_t dir_len = strlen(ASTEROID_DEFAULT_DIRECTORY);
+    uint64_t total_ns = 0;
+    for (uint32_t i = 0; i < pack->header->entry_count; i++)
+    {
+        const AssetPackEntry *entry = &pack->entries[i];
+        const char *name = AssetPack_EntryName(pack, entry);
+        if (strncmp(name, ASTEROID_DEFAULT_DIRECTORY, dir_len) != 0 || strchr(name + dir_len + 1, '/') != NULL) continue;
+        Image image = AssetPack_ImageView(pack, entry);
+        if (image.data == NULL) continue;
+
+        uint64_t t0 = Clock_NowNs();
+        FractureTable table;
+        if (Fracture_Build(&table, &image, ASTEROID_MASK_THRESHOLD))
+        {
+            for (int p = 0; p < table.piece_count; p++)
+            {
+                Image piece = Fracture_PieceImage(&table, &image, p);
+                CollisionShape shapes[ASTEROID_SCALE_BUCKETS];
+                if (piece.data != NULL && Asteroids_BakeShapes(shapes, &piece))
+                {
+                    for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++) CollisionShape_Free(&shapes[b]);
+                }
+                if (piece.data != NULL) UnloadImage(piece);
+            }
+            Fracture_Free(&table);
+        }
+        total_ns += Clock_NowNs() - t0;
+        (*out_rocks)++;
+    }
+    return (*out_rocks > 0) ? (double)total_ns / 1e6 / *out_rocks : -1.0;
+}
+
+// Applies lethal damage to every handle; returns ns per destroy.
+static double DestroyAll(AsteroidSystem *system, const AsteroidHandle *handles, int count, int *out_destroyed)
+{
+    *out_destroyed = 0;
+    uint64_t t0 = Clock_NowNs();
+    for (int i = 0; i < count; i++) *out_destroyed += Asteroids_ApplyDamage(system, handles[i], 1e9f);
+    return (count > 0) ? (double)(Clock_NowNs() - t0) / count : 0.0;
+}
+
+static int CollectHandles(const AsteroidSystem *system, AsteroidHandle **handles)
+{
+    int count = Asteroids_Count(system);
+    *handles = (AsteroidHandle *)malloc((size_t)(count > 0 ? count : 1) * sizeof(AsteroidHandle));
+    for (int i = 0; i < count; i++) (*handles)[i] = Asteroids_HandleAt(system, i);
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    int asteroids = (argc > 1) ? atoi(argv[1]) : 10000;
+    if (asteroids < 1) asteroids = 10000;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem system;
+    Asteroids_Init(&system, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (system.rock_count == 0)
+    {
+        fprintf(stderr, "bench_fracture: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+
+    // The tables: pieces per rock and the share of each rock they keep.
+    int tables_ok = 1;
+    int min_pieces = 1 << 30;
+    int max_pieces = 0;
+    float min_share = 1.0f;
+    for (int r = 0; r < system.rock_count; r++)
+    {
+        const AsteroidAsset *rock = &system.assets[r];
+        float share = 0.0f;
+        for (int f = 0; f < rock->fragment_count; f++)
+        {
+            const AsteroidAsset *fragment = &system.assets[rock->first_fragment + f];
+            if (fragment->parent != r || fragment->fragment_count != 0) tables_ok = 0;
+            share += fragment->area_share;
+        }
+        if (share > 1.0001f) tables_ok = 0;
+        if (share < min_share) min_share = share;
+        if (rock->fragment_count < min_pieces) min_pieces = rock->fragment_count;
+        if (rock->fragment_count > max_pieces) max_pieces = rock->fragment_count;
+    }
+    int cut_rocks = 0;
+    double cut_ms = CutCost(&cut_rocks);
+    printf("rocks=%d fragments=%d pieces/rock=%d..%d min_area_kept=%.0f%%\n", system.rock_count,
+           system.asset_count - system.rock_count, min_pieces, max_pieces, 100.0f * min_share);
+    if (cut_ms >= 0.0) printf("cut at load: %.2f ms/rock (%d rocks)\n", cut_ms, cut_rocks);
+    else printf("cut at load: no pack mounted, not measured\n");
+
+    system.stream_sectors = 0;
+    Vector2 center = { 0.0f, 0.0f };
+    Asteroids_SpawnField(&system, center, asteroids, sqrtf((float)asteroids * BENCH_AREA_PER_ROCK / PI));
+    long long expected = 0;
+    for (int i = 0; i < system.pool.count; i++) expected += system.assets[system.columns.asset_index[i]].fragment_count;
+
+    AsteroidHandle *handles = NULL;
+    int rocks = CollectHandles(&system, &handles);
+    int destroyed = 0;
+    double rock_ns = DestroyAll(&system, handles, rocks, &destroyed);
+    int fragments = Asteroids_Count(&system);
+    free(handles);
+
+    int pieces = CollectHandles(&system, &handles);
+    int fragments_destroyed = 0;
+    double fragment_ns = DestroyAll(&system, handles, pieces, &fragments_destroyed);
+    int left = Asteroids_Count(&system);
+    free(handles);
+
+    printf("break: %.0f ns/rock (%d rocks -> %d fragments), %.0f ns/fragment (%d destroyed, %d left)\n", rock_ns,
+           destroyed, fragments, fragment_ns, fragments_destroyed, left);
+    if (cut_ms > 0.0) printf("break vs cut: %.0fx cheaper\n", cut_ms * 1e6 / rock_ns);
+
+    int counts_ok = destroyed == rocks && fragments == expected && fragments_destroyed == pieces && left == 0;
+    printf("tables: %s, counts: %s\n", tables_ok ? "OK" : "BAD", counts_ok ? "OK" : "MISMATCH");
+
+    Asteroids_Unload(&system);
+    AssetPack_Unmount();
+    return (tables_ok && counts_ok) ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Compares the old array-of-structs asteroid loops against the SoA kernels.
+// Usage: bench_kernels [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asteroid_kernels.h"
+#include "clock.h"
+
+// Layout of the old Asteroid struct (Vector2 position/velocity, scale, bucket,
+// asset index, hp, hp_max) so the AoS loops stride over the same bytes.
+typedef struct AosAsteroid
+{
+    float pos_x, pos_y;
+    float vel_x, vel_y;
+    float scale;
+    int scale_bucket;
+    int asset_index;
+    float hp;
+    float hp_max;
+} AosAsteroid;
+
+typedef struct BenchData
+{
+    int count;
+    AosAsteroid *aos;
+    float *pos_x;
+    float *pos_y;
+    float *vel_x;
+    float *vel_y;
+    unsigned char *flags;
+} BenchData;
+
+static volatile float sink_float;
+static volatile int sink_int;
+
+static float Random01(unsigned *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
+
+static void BenchData_Init(BenchData *data, int count)
+{
+    data->count = count;
+    data->aos = calloc((size_t)count, sizeof(AosAsteroid));
+    data->pos_x = malloc((size_t)count * sizeof(float));
+    data->pos_y = malloc((size_t)count * sizeof(float));
+    data->vel_x = malloc((size_t)count * sizeof(float));
+    data->vel_y = malloc((size_t)count * sizeof(float));
+    data->flags = malloc((size_t)count);
+
+    unsigned state = 12345u;
+    for (int i = 0; i < count; i++)
+    {
+        float px = Random01(&state) * 5000.0f;
+        float py = Random01(&state) * 3000.0f;
+        float vx = Random01(&state) * 200.0f - 100.0f;
+        float vy = Random01(&state) * 200.0f - 100.0f;
+        data->aos[i].pos_x = data->pos_x[i] = px;
+        data->aos[i].pos_y = data->pos_y[i] = py;
+        data->aos[i].vel_x = data->vel_x[i] = vx;
+        data->aos[i].vel_y = data->vel_y[i] = vy;
+        data->aos[i].hp = data->aos[i].hp_max = 100.0f;
+        data->aos[i].scale = 1.0f;
+    }
+}
+
+static void BenchData_Free(BenchData *data)
+{
+    free(data->aos);
+    free(data->pos_x);
+    free(data->pos_y);
+    free(data->vel_x);
+    free(data->vel_y);
+    free(data->flags);
+}
+
+static void AosIntegrate(AosAsteroid *a, int count, float dt)
+{
+    for (int i = 0; i < count; i++)
+    {
+        a[i].pos_x += a[i].vel_x * dt;
+        a[i].pos_y += a[i].vel_y * dt;
+    }
+}
+
+static int AosDespawn(const AosAsteroid *a, int count, float cx, float cy, float radius_sq, unsigned char *flags)
+{
+    int flagged = 0;
+    for (int i = 0; i < count; i++)
+    {
+        float dx = a[i].pos_x - cx;
+        float dy = a[i].pos_y - cy;
+        flags[i] = (unsigned char)(dx * dx + dy * dy > radius_sq);
+        flagged += flags[i];
+    }
+    return flagged;
+}
+
+static int AosFindClosest(const AosAsteroid *a, int count, float x, float y, float max_dist_sq)
+{
+    int best_index = -1;
+    float best_dist_sq = max_dist_sq;
+    for (int i = 0; i < count; i++)
+    {
+        float dx = a[i].pos_x - x;
+        float dy = a[i].pos_y - y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 <= best_dist_sq)
+        {
+            best_dist_sq = d2;
+            best_index = i;
+        }
+    }
+    return best_index;
+}
+
+static double NsPerEntity(uint64_t start, uint64_t end, int iterations, int count)
+{
+    return (double)(end - start) / ((double)iterations * (double)count);
+}
+
+static void RunSize(int count, int iterations)
+{
+    BenchData data;
+    BenchData_Init(&data, count);
+    const float dt = 1.0f / 60.0f;
+    const float radius_sq = 2000.0f * 2000.0f;
+
+    uint64_t t0 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) AosIntegrate(data.aos, count, dt);
+    uint64_t t1 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) AsteroidKernels_Integrate(data.pos_x, data.pos_y, data.vel_x, data.vel_y, count, dt);
+    uint64_t t2 = Clock_NowNs();
+    printf("%8d  integrate     aos %6.3f  soa %6.3f ns/entity\n",
+           count, NsPerEntity(t0, t1, iterations, count), NsPerEntity(t1, t2, iterations, count));
+
+    int flagged = 0;
+    t0 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) flagged += AosDespawn(data.aos, count, 2500.0f, 1500.0f, radius_sq, data.flags);
+    t1 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) flagged += AsteroidKernels_DespawnFlags(data.pos_x, data.pos_y, count, 2500.0f, 1500.0f, radius_sq, data.flags);
+    t2 = Clock_NowNs();
+    sink_int = flagged;
+    printf("%8d  despawn       aos %6.3f  soa %6.3f ns/entity\n",
+           count, NsPerEntity(t0, t1, iterations, count), NsPerEntity(t1, t2, iterations, count));
+
+    int aos_best = 0;
+    int soa_best = 0;
+    t0 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) aos_best += AosFindClosest(data.aos, count, 2500.0f, 1500.0f, radius_sq);
+    t1 = Clock_NowNs();
+    for (int it = 0; it < iterations; it++) soa_best += AsteroidKernels_FindClosest(data.pos_x, data.pos_y, count, 2500.0f, 1500.0f, radius_sq, NULL);
+    t2 = Clock_NowNs();
+    sink_int = aos_best + soa_best;
+    printf("%8d  find_closest  aos %6.3f  soa %6.3f ns/entity%s\n",
+           count, NsPerEntity(t0, t1, iterations, count), NsPerEntity(t1, t2, iterations, count),
+           aos_best == soa_best ? "" : "  MISMATCH");
+
+    sink_float = data.pos_x[0] + data.aos[0].pos_x;
+    BenchData_Free(&data);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = (argc > 1) ? atoi(argv[1]) : 0;
+    const int sizes[] = { 1000, 10000, 100000 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        // Keep the work per size roughly constant unless overridden.
+        int n = iterations > 0 ? iterations : 20000000 / sizes[i];
+        RunSize(sizes[i], n);
+    }
+    return 0;
+}
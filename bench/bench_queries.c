@@ -0,0 +1,251 @@
+// Compares closest-asteroid lookups: the linear SIMD scan against the spatial
+// query index (including its per-tick rebuild), plus radius/rect query cost.
+// Then casts as many random rays through a field of real asteroid masks with
+// Asteroids_Raycast and against every asteroid's mask by brute force,
+// reporting us per ray and how many rays fit in one SIM_DT tick. Exits
+// non-zero if the index disagrees with the scan or a ray with brute force.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_queries [queries]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "asteroid_kernels.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "spatial_hash.h"
+#include "spatial_query.h"
+#include "world.h"
+
+#define QUERY_CELL_SIZE 256.0f
+#define QUERY_RANGE 520.0f
+#define QUERY_SEED 42u
+// Hits at the same pixel may differ by float rounding between the two walks.
+#define RAY_DISTANCE_EPSILON 0.001f
+
+typedef struct Closest
+{
+    int item;
+    float dist_sq;
+} Closest;
+
+static volatile int sink_int;
+
+static float Random01(unsigned *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (float)(*state >> 8) / 16777216.0f;
+}
+
+static float VisitClosest(void *user, int item, float dist_sq)
+{
+    Closest *best = (Closest *)user;
+    if (dist_sq < best->dist_sq || (dist_sq == best->dist_sq && item > best->item))
+    {
+        best->item = item;
+        best->dist_sq = dist_sq;
+    }
+    return best->dist_sq;
+}
+
+static void VisitCount(void *user, int item, float dist_sq)
+{
+    (void)item;
+    (void)dist_sq;
+    (*(int *)user)++;
+}
+
+// First hit along the ray over every asteroid's mask, ties to the higher dense
+// index as in Asteroids_Raycast. Returns the dense index, or -1 on a miss.
+static int BruteForceRaycast(const AsteroidSystem *system, Vector2 origin, Vector2 dir, float max_dist,
+                             float *out_dist)
+{
+    const AsteroidColumns *c = &system->columns;
+    int best_index = -1;
+    float best_t = max_dist;
+    for (int i = 0; i < Asteroids_Count(system); i++)
+    {
+        const CollisionShape *shape = &system->assets[c->asset_index[i]].shapes[c->scale_bucket[i]];
+        float left = c->pos_x[i] - 0.5f * (float)shape->fine.width;
+        float top = c->pos_y[i] - 0.5f * (float)shape->fine.height;
+        float t = CollisionShape_Raycast(shape, origin.x - left, origin.y - top, dir.x, dir.y, max_dist);
+        if (t >= 0.0f && t <= best_t)
+        {
+            best_t = t;
+            best_index = i;
+        }
+    }
+    *out_dist = best_t;
+    return best_index;
+}
+
+// Casts `queries` random rays from inside a field of `count` rocks. Returns
+// the rays whose hit differs from brute force.
+static int RunRaycast(const AsteroidSystem *source, int count, int queries)
+{
+    AsteroidSystem system;
+    Asteroids_InitShared(&system, source, QUERY_SEED);
+    system.stream_sectors = 0;
+    float field_radius = 300.0f * sqrtf((float)count / PI);
+    Asteroids_SpawnField(&system, (Vector2){ 0.0f, 0.0f }, count, field_radius);
+    Vector2 *origins = malloc((size_t)queries * sizeof(Vector2));
+    Vector2 *dirs = malloc((size_t)queries * sizeof(Vector2));
+    AsteroidRayHit *hits = malloc((size_t)queries * sizeof(AsteroidRayHit));
+    int *hit = malloc((size_t)queries * sizeof(int));
+    unsigned state = 999u;
+    for (int q = 0; q < queries; q++)
+    {
+        float r = field_radius * sqrtf(Random01(&state));
+        float a = 2.0f * PI * Random01(&state);
+        float d = 2.0f * PI * Random01(&state);
+        origins[q] = (Vector2){ r * cosf(a), r * sinf(a) };
+        dirs[q] = (Vector2){ cosf(d), sinf(d) };
+    }
+
+    uint64_t t0 = Clock_NowNs();
+    for (int q = 0; q < queries; q++) hit[q] = Asteroids_Raycast(&system, origins[q], dirs[q], QUERY_RANGE, &hits[q]);
+    uint64_t t1 = Clock_NowNs();
+    int mismatches = 0;
+    int hit_count = 0;
+    for (int q = 0; q < queries; q++)
+    {
+        float dist;
+        int index = BruteForceRaycast(&system, origins[q], dirs[q], QUERY_RANGE, &dist);
+        hit_count += hit[q];
+        if (index < 0 || !hit[q])
+        {
+            mismatches += (index >= 0) != (hit[q] != 0);
+            continue;
+        }
+        AsteroidHandle expected = Asteroids_HandleAt(&system, index);
+        if (expected.index != hits[q].handle.index || expected.generation != hits[q].handle.generation || fabsf(dist - hits[q].distance) > RAY_DISTANCE_EPSILON)
+        {
+            mismatches++;
+        }
+    }
+    uint64_t t2 = Clock_NowNs();
+
+    double ray_us = (double)(t1 - t0) / queries / 1000.0;
+    printf("%8d  raycast      %8.3f us  brute %8.3f us  | hit %5.1f%%  | %8.0f rays/tick%s\n", count, ray_us,
+           (double)(t2 - t1) / queries / 1000.0, 100.0 * hit_count / queries, SIM_DT * 1e6 / ray_us,
+           mismatches ? "  MISMATCH" : "");
+
+    free(origins);
+    free(dirs);
+    free(hits);
+    free(hit);
+    Asteroids_Unload(&system);
+    return mismatches;
+}
+
+// Returns the closest queries whose index answer differs from the scan.
+static int RunSize(int count, int queries)
+{
+    // Same density as the headless field: one rock per 300x300 px.
+    float side = 300.0f * sqrtf((float)count);
+    float *pos_x = malloc((size_t)count * sizeof(float));
+    float *pos_y = malloc((size_t)count * sizeof(float));
+    float *query_x = malloc((size_t)queries * sizeof(float));
+    float *query_y = malloc((size_t)queries * sizeof(float));
+    unsigned state = 777u;
+    for (int i = 0; i < count; i++)
+    {
+        pos_x[i] = Random01(&state) * side;
+        pos_y[i] = Random01(&state) * side;
+    }
+    for (int q = 0; q < queries; q++)
+    {
+        query_x[q] = Random01(&state) * side;
+        query_y[q] = Random01(&state) * side;
+    }
+
+    SpatialHash index;
+    SpatialHash_Init(&index);
+    const int builds = 50;
+    uint64_t t0 = Clock_NowNs();
+    for (int b = 0; b < builds; b++)
+    {
+        SpatialHash_Begin(&index, count, QUERY_CELL_SIZE);
+        for (int i = 0; i < count; i++) SpatialHash_Insert(&index, i, pos_x[i], pos_y[i], 0.0f);
+        SpatialHash_Finish(&index);
+    }
+    uint64_t t1 = Clock_NowNs();
+    double build_us = (double)(t1 - t0) / builds / 1000.0;
+
+    const float range_sq = QUERY_RANGE * QUERY_RANGE;
+    int mismatches = 0;
+    int *scan_result = malloc((size_t)queries * sizeof(int));
+
+    t0 = Clock_NowNs();
+    for (int q = 0; q < queries; q++)
+    {
+        scan_result[q] = AsteroidKernels_FindClosest(pos_x, pos_y, count, query_x[q], query_y[q], range_sq, NULL);
+    }
+    t1 = Clock_NowNs();
+    for (int q = 0; q < queries; q++)
+    {
+        Closest best = { -1, range_sq };
+        SpatialQuery_Nearest(&index, query_x[q], query_y[q], range_sq, VisitClosest, &best);
+        if (best.item != scan_result[q]) mismatches++;
+    }
+    uint64_t t2 = Clock_NowNs();
+
+    int hits = 0;
+    for (int q = 0; q < queries; q++)
+    {
+        SpatialQuery_Radius(&index, query_x[q], query_y[q], QUERY_RANGE, VisitCount, &hits);
+    }
+    uint64_t t3 = Clock_NowNs();
+    for (int q = 0; q < queries; q++)
+    {
+        SpatialQuery_Rect(&index, query_x[q] - 640.0f, query_y[q] - 360.0f, query_x[q] + 640.0f, query_y[q] + 360.0f,
+                          VisitCount, &hits);
+    }
+    uint64_t t4 = Clock_NowNs();
+    sink_int = hits;
+
+    printf("%8d  closest scan %8.3f us  index %6.3f us  | radius %6.3f us  rect %6.3f us  | rebuild %8.1f us%s\n",
+           count,
+           (double)(t1 - t0) / queries / 1000.0, (double)(t2 - t1) / queries / 1000.0,
+           (double)(t3 - t2) / queries / 1000.0, (double)(t4 - t3) / queries / 1000.0,
+           build_us, mismatches ? "  MISMATCH" : "");
+
+    SpatialHash_Free(&index);
+    free(scan_result);
+    free(pos_x);
+    free(pos_y);
+    free(query_x);
+    free(query_y);
+    return mismatches;
+}
+
+int main(int argc, char **argv)
+{
+    int queries = (argc > 1) ? atoi(argv[1]) : 2000;
+    if (queries <= 0) queries = 2000;
+    const int sizes[] = { 1000, 10000, 100000 };
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem source;
+    Asteroids_Init(&source, ASTEROID_DEFAULT_DIRECTORY, 0, QUERY_SEED);
+    if (source.asset_count == 0)
+    {
+        fprintf(stderr, "bench_queries: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+
+    int mismatches = 0;
+    printf("per query (range %.0f px), rebuild once per tick\n", QUERY_RANGE);
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        mismatches += RunSize(sizes[i], queries);
+        mismatches += RunRaycast(&source, sizes[i], queries);
+    }
+    printf("index vs scan, raycast vs brute force: %s\n", mismatches ? "MISMATCH" : "OK");
+
+    Asteroids_Unload(&source);
+    AssetPack_Unmount();
+    return mismatches ? 1 : 0;
+}
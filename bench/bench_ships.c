@@ -0,0 +1,222 @@
+// Flow-field ship benchmark: a drifting asteroid field with two goals in it
+// and `ships` AI ships starting on a ring around it, each seeking one of the
+// goals, stepped at the fixed sim rate. Reports ms per tick for the
+// navigation update (obstacle submission and field repair, both goals) and
+// for steering every ship, against the SIM_DT tick budget, plus the cells the
+// repairs touched and what a full rebuild of a field costs instead. Every
+// CHECK_INTERVAL ticks each field is compared with one rebuilt from scratch
+// from the same obstacles, and the same run on one thread and on `threads`
+// must end bit-identical. Exits non-zero if a repaired field differs from its
+// rebuild, the runs differ, or navigation plus steering does not fit in the
+// tick budget.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_ships [ships] [seconds] [threads] [asteroids]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "job_system.h"
+#include "ships.h"
+#include "world.h"
+
+#define BENCH_SEED 42u
+#define BENCH_AREA_PER_ROCK (300.0f * 300.0f)
+#define BENCH_SHIP_HALF_SIZE 24.0f
+#define CHECK_INTERVAL 30
+
+typedef struct BenchResult
+{
+    double nav_ms;
+    double steer_ms;
+    double rebuild_ms;
+    int rebuilds;
+    int ticks;
+    long long changed_cells;
+    long long cleared_cells;
+    long long settled_cells;
+    long long blocked;
+    int arrived;
+    int cells;
+    int fields_ok;
+    uint64_t checksum;
+} BenchResult;
+
+static uint64_t Checksum(const ShipSystem *ships)
+{
+    const float *columns[] = { ships->columns.pos_x, ships->columns.pos_y, ships->columns.angle };
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t k = 0; k < sizeof(columns) / sizeof(columns[0]); k++)
+    {
+        const unsigned char *bytes = (const unsigned char *)columns[k];
+        for (size_t i = 0; i < (size_t)Ships_Count(ships) * sizeof(float); i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// Rebuilds each field from scratch out of the obstacles the last navigation
+// update submitted and compares costs and blocked cells. Returns 1 if every
+// field matches; adds the rebuild time to the result.
+static int CheckFields(const ShipSystem *ships, BenchResult *result)
+{
+    int ok = 1;
+    for (int f = 0; f < ships->field_count; f++)
+    {
+        const FlowField *field = &ships->fields[f];
+        FlowField fresh;
+        if (!FlowField_Init(&fresh, field->goal, field->cell_size, field->width, field->height)) return 0;
+        uint64_t t0 = Clock_NowNs();
+        FlowField_BeginObstacles(&fresh);
+        for (int i = 0; i < ships->obstacle_count; i++)
+        {
+            const float *disk = &ships->obstacles[i * 3];
+            FlowField_AddDisk(&fresh, disk[0], disk[1], disk[2]);
+        }
+        FlowField_CommitObstacles(&fresh, 1);
+        result->rebuild_ms += (double)(Clock_NowNs() - t0) / 1e6;
+        result->rebuilds++;
+
+        size_t cells = (size_t)field->width * (size_t)field->height;
+        if (memcmp(fresh.cost, field->cost, cells * sizeof(int32_t)) != 0 ||
+            memcmp(fresh.blocked, field->blocked, cells) != 0)
+        {
+            ok = 0;
+        }
+        FlowField_Free(&fresh);
+    }
+    return ok;
+}
+
+static BenchResult Run(const AsteroidSystem *source, JobSystem *jobs, int ship_count, int asteroids, double seconds)
+{
+    BenchResult result = {0};
+    result.fields_ok = 1;
+    AsteroidSystem system;
+    Asteroids_InitShared(&system, source, BENCH_SEED);
+    system.jobs = jobs;
+    system.stream_sectors = 0;
+    Vector2 center = { 0.0f, 0.0f };
+    float field_radius = sqrtf((float)asteroids * BENCH_AREA_PER_ROCK / PI);
+    Asteroids_SpawnField(&system, center, asteroids, field_radius);
+
+    // Both grids reach past the ring the ships start on.
+    ShipSystem ships;
+    Vector2 half_size = { BENCH_SHIP_HALF_SIZE, BENCH_SHIP_HALF_SIZE };
+    Ships_Init(&ships, half_size, (Rectangle){0});
+    ships.jobs = jobs;
+    float ring = field_radius * 1.1f;
+    int cells = (int)ceilf(2.0f * (ring + field_radius * 0.5f + 4.0f * SHIPS_FIELD_CELL_SIZE) / SHIPS_FIELD_CELL_SIZE);
+    Vector2 goals[2] = { center, { field_radius * 0.5f, 0.0f } };
+    for (int g = 0; g < 2; g++)
+    {
+        if (Ships_AddGoal(&ships, goals[g], cells, cells) < 0) result.fields_ok = 0;
+    }
+    for (int i = 0; i < ship_count && ships.field_count == 2; i++)
+    {
+        float angle = 2.0f * PI * (float)i / (float)ship_count;
+        Vector2 position = { ring * cosf(angle), ring * sinf(angle) };
+        ShipHandle handle = Ships_Spawn(&ships, position, i & 1);
+        if (i % 4 == 0) Ships_SetBoost(&ships, handle, 1);
+    }
+    for (int f = 0; f < ships.field_count; f++) result.cells += ships.fields[f].width * ships.fields[f].height;
+
+    result.ticks = (int)lround(seconds / SIM_DT);
+    for (int t = 0; t < result.ticks; t++)
+    {
+        Asteroids_Update(&system, SIM_DT, center);
+
+        uint64_t t0 = Clock_NowNs();
+        Ships_UpdateNavigation(&ships, &system);
+        uint64_t t1 = Clock_NowNs();
+        Ships_Update(&ships, SIM_DT);
+        uint64_t t2 = Clock_NowNs();
+        result.nav_ms += (double)(t1 - t0) / 1e6;
+        result.steer_ms += (double)(t2 - t1) / 1e6;
+
+        // The first commit is a full build; count the repairs only.
+        for (int f = 0; f < ships.field_count && t > 0; f++)
+        {
+            result.changed_cells += ships.fields[f].stats.changed_cells;
+            result.cleared_cells += ships.fields[f].stats.cleared_cells;
+            result.settled_cells += ships.fields[f].stats.settled_cells;
+        }
+        result.blocked += ships.stats.blocked;
+        if (t % CHECK_INTERVAL == CHECK_INTERVAL - 1 && !CheckFields(&ships, &result)) result.fields_ok = 0;
+    }
+    result.arrived = ships.stats.arrived;
+    result.checksum = Checksum(&ships);
+    Ships_Unload(&ships);
+    Asteroids_Unload(&system);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int ship_count = (argc > 1) ? atoi(argv[1]) : 4000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 5.0;
+    int threads = (argc > 3) ? atoi(argv[3]) : 4;
+    int asteroids = (argc > 4) ? atoi(argv[4]) : 1000;
+    if (ship_count < 1) ship_count = 4000;
+    if (seconds <= 0.0) seconds = 5.0;
+    if (threads < 1) threads = 1;
+    if (asteroids < 1) asteroids = 1000;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem source;
+    Asteroids_Init(&source, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (source.asset_count == 0)
+    {
+        fprintf(stderr, "bench_ships: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+
+    JobSystem serial;
+    JobSystem_Init(&serial, 1);
+    BenchResult reference = Run(&source, &serial, ship_count, asteroids, seconds);
+    JobSystem_Shutdown(&serial);
+
+    JobSystem jobs;
+    JobSystem_Init(&jobs, threads);
+    BenchResult result = Run(&source, &jobs, ship_count, asteroids, seconds);
+    threads = JobSystem_ThreadCount(&jobs);
+    JobSystem_Shutdown(&jobs);
+
+    double budget_ms = SIM_DT * 1000.0;
+    BenchResult *runs[] = { &reference, &result };
+    const int run_threads[] = { 1, threads };
+    int within_budget = 1;
+    printf("ships=%d asteroids=%d seconds=%.1f ticks=%d cells=%d budget=%.2f ms/tick\n", ship_count, asteroids,
+           seconds, result.ticks, result.cells, budget_ms);
+    printf("%-8s %8s %9s %11s %13s %13s %13s %8s %8s\n", "threads", "nav_ms", "steer_ms", "rebuild_ms",
+           "changed/tick", "cleared/tick", "settled/tick", "blocked", "arrived");
+    for (int r = 0; r < 2; r++)
+    {
+        BenchResult *run = runs[r];
+        int repairs = (run->ticks > 1) ? run->ticks - 1 : 1;
+        double nav = run->nav_ms / run->ticks;
+        double steer = run->steer_ms / run->ticks;
+        printf("%-8d %8.3f %9.3f %11.3f %13.1f %13.1f %13.1f %7.2f%% %8d\n", run_threads[r], nav, steer,
+               (run->rebuilds > 0) ? run->rebuild_ms / run->rebuilds : 0.0, (double)run->changed_cells / repairs,
+               (double)run->cleared_cells / repairs, (double)run->settled_cells / repairs,
+               100.0 * (double)run->blocked / ((double)run->ticks * ship_count), run->arrived);
+        if (run == &result && nav + steer > budget_ms) within_budget = 0;
+    }
+
+    int fields_ok = reference.fields_ok && result.fields_ok;
+    int deterministic = reference.checksum == result.checksum;
+    printf("repair vs rebuild: %s, 1 vs %d threads: %s, navigation + steering within budget: %s\n",
+           fields_ok ? "identical" : "MISMATCH", threads, deterministic ? "identical" : "MISMATCH",
+           within_budget ? "OK" : "OVER");
+
+    Asteroids_Unload(&source);
+    AssetPack_Unmount();
+    return (fields_ok && deterministic && within_budget) ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// World save-state benchmark: WorldState_Capture / WorldState_Restore
+// latency for a 10k-asteroid headless world against a World_Reset plus
+// re-spawn, encoded sizes of full and delta states, and a determinism check
+// (restore, step, compare checksums with an uninterrupted run; exits non-zero
+// on a mismatch). Run from the repository root (loads the asteroid masks).
+// Usage: bench_snapshot [asteroids] [iterations]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "clock.h"
+#include "world.h"
+#include "world_state.h"
+
+#define BENCH_SEED 42u
+// Few warmup ticks: the field thins out as rocks collide.
+#define BENCH_WARMUP_TICKS 2
+#define BENCH_CHECK_TICKS 120
+// Delta distances in ticks: next tick, one second, ten seconds.
+static const int BENCH_DELTA_TICKS[] = { 1, 60, 600 };
+
+static void SpawnField(World *world, int asteroids)
+{
+    // Same field setup as headless --asteroids.
+    float radius = sqrtf((float)asteroids * 90000.0f / PI);
+    Asteroids_SpawnField(&world->asteroids, world->player.position, asteroids, radius);
+}
+
+static void Step(World *world, int ticks)
+{
+    InputSnapshot input = Input_Neutral((Vector2){ world->player.position.x, world->player.position.y - 1.0f });
+    for (int t = 0; t < ticks; t++) World_Step(world, &input, SIM_DT);
+}
+
+int main(int argc, char **argv)
+{
+    int asteroids = (argc > 1) ? atoi(argv[1]) : 10000;
+    int iterations = (argc > 2) ? atoi(argv[2]) : 200;
+    if (asteroids < 1) asteroids = 10000;
+    if (iterations < 1) iterations = 200;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    static World world;
+    World_Init(&world, BENCH_SEED, 1, NULL);
+    if (world.asteroids.asset_count <= 0)
+    {
+        fprintf(stderr, "bench_snapshot: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+    SpawnField(&world, asteroids);
+    Step(&world, BENCH_WARMUP_TICKS);
+    int captured = Asteroids_Count(&world.asteroids);
+
+    WorldState state = {0};
+    WorldState scratch = {0};
+    if (!WorldState_Capture(&state, &world))
+    {
+        fprintf(stderr, "bench_snapshot: capture failed\n");
+        return 1;
+    }
+
+    // Capture and restore in a loop; the first capture above sized the buffer.
+    uint64_t t0 = Clock_NowNs();
+    for (int i = 0; i < iterations; i++) WorldState_Capture(&scratch, &world);
+    double capture_ns = (double)(Clock_NowNs() - t0) / iterations;
+    t0 = Clock_NowNs();
+    int restore_ok = 1;
+    for (int i = 0; i < iterations; i++) restore_ok &= WorldState_Restore(&world, &state);
+    double restore_ns = (double)(Clock_NowNs() - t0) / iterations;
+
+    // The alternative to a snapshot: reseed and rebuild the field.
+    int reset_iterations = (iterations < 20) ? iterations : 20;
+    t0 = Clock_NowNs();
+    for (int i = 0; i < reset_iterations; i++)
+    {
+        World_Reset(&world, BENCH_SEED);
+        SpawnField(&world, asteroids);
+    }
+    double reset_ns = (double)(Clock_NowNs() - t0) / reset_iterations;
+
+    // Determinism: run on from the snapshot twice, the second time through a
+    // restore after unrelated ticks.
+    restore_ok &= WorldState_Restore(&world, &state);
+    Step(&world, BENCH_CHECK_TICKS);
+    uint64_t expected = World_Checksum(&world);
+    Step(&world, 37);
+    restore_ok &= WorldState_Restore(&world, &state);
+    Step(&world, BENCH_CHECK_TICKS);
+    uint64_t restored = World_Checksum(&world);
+
+    // Round trip through the encoder, full and against a base.
+    unsigned char *encoded = NULL;
+    size_t encoded_capacity = 0;
+    t0 = Clock_NowNs();
+    size_t full_size = WorldState_Encode(&state, NULL, &encoded, &encoded_capacity);
+    double encode_ns = (double)(Clock_NowNs() - t0);
+    int decode_ok = WorldState_Decode(&scratch, NULL, encoded, full_size) && scratch.size == state.size;
+    printf("asteroids=%d state_bytes=%zu capture_ns=%.0f restore_ns=%.0f reset_spawn_ns=%.0f (%.1fx)\n",
+           captured, state.size, capture_ns, restore_ns, reset_ns,
+           (restore_ns > 0.0) ? reset_ns / restore_ns : 0.0);
+    printf("full: %zu bytes encode_ns=%.0f\n", full_size, encode_ns);
+
+    restore_ok &= WorldState_Restore(&world, &state);
+    int elapsed = 0;
+    for (size_t d = 0; d < sizeof(BENCH_DELTA_TICKS) / sizeof(BENCH_DELTA_TICKS[0]); d++)
+    {
+        Step(&world, BENCH_DELTA_TICKS[d] - elapsed);
+        elapsed = BENCH_DELTA_TICKS[d];
+        WorldState_Capture(&scratch, &world);
+        t0 = Clock_NowNs();
+        size_t delta_size = WorldState_Encode(&scratch, &state, &encoded, &encoded_capacity);
+        double delta_ns = (double)(Clock_NowNs() - t0);
+        WorldState decoded = {0};
+        int ok = WorldState_Decode(&decoded, &state, encoded, delta_size) && decoded.size == scratch.size;
+        decode_ok &= ok;
+        WorldState_Free(&decoded);
+        printf("delta +%d ticks: %zu bytes (%.1f%% of state) encode_ns=%.0f\n", BENCH_DELTA_TICKS[d], delta_size,
+               100.0 * (double)delta_size / (double)scratch.size, delta_ns);
+    }
+
+    int deterministic = restored == expected;
+    printf("determinism: %s (%016llx vs %016llx)\n", deterministic ? "OK" : "MISMATCH",
+           (unsigned long long)restored, (unsigned long long)expected);
+    if (!restore_ok) printf("restore: FAILED\n");
+    if (!decode_ok) printf("decode: FAILED\n");
+
+    free(encoded);
+    WorldState_Free(&scratch);
+    WorldState_Free(&state);
+    World_Unload(&world);
+    AssetPack_Unmount();
+    return (deterministic && restore_ok && decode_ok) ? 0 : 1;
+}
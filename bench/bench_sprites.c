@@ -0,0 +1,268 @@
+// Sprite batching: draw calls and submit+flush cost for a 10k-asteroid
+// field, through the recording backend (no window or GPU needed). Asset
+// textures are stand-in ids, so only the batching is measured. Then the same
+// number of animated sprites, with frames resolved per batch from clip start
+// times against per-instance SpriteAnim updates. Exits non-zero if the batch
+// counts are not the expected ones or the batched frame indices differ from
+// SpriteClip_FrameAt.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_sprites [asteroids] [frames]
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "rng.h"
+#include "sprite_atlas.h"
+#include "sprite_batch.h"
+#include "spritesheet.h"
+
+#define BENCH_SEED 42u
+#define BENCH_FIELD_RADIUS 6000.0f
+#define BENCH_FRAME_DT (1.0f / 60.0f)
+// Stand-in 8-frame flare sheet.
+#define BENCH_ANIM_FRAME 48
+#define BENCH_ANIM_FRAMES 8
+
+typedef struct BenchCase
+{
+    const char *name;
+    int sort;
+    int atlas;
+    int cull;
+} BenchCase;
+
+static void UseAssetTextures(AsteroidSystem *system)
+{
+    system->atlas = (SpriteAtlas){0};
+    for (int i = 0; i < system->asset_count; i++)
+    {
+        AsteroidAsset *asset = &system->assets[i];
+        asset->texture = (Texture2D){ 100u + (unsigned)i, asset->width, asset->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        asset->region = (Rectangle){ 0.0f, 0.0f, (float)asset->width, (float)asset->height };
+    }
+}
+
+static int UseAtlas(AsteroidSystem *system)
+{
+    int count = system->asset_count;
+    int *sizes = malloc((size_t)count * 2 * sizeof(int));
+    Rectangle *regions = malloc((size_t)count * sizeof(Rectangle));
+    int width = 0;
+    int height = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sizes[i] = system->assets[i].width;
+        sizes[count + i] = system->assets[i].height;
+    }
+    int packed = SpriteAtlas_Pack(sizes, sizes + count, count, SPRITE_ATLAS_PADDING, SPRITE_ATLAS_MAX_SIZE, regions,
+                                  &width, &height);
+    if (packed)
+    {
+        system->atlas.texture = (Texture2D){ 1u, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+        system->atlas.width = width;
+        system->atlas.height = height;
+        for (int i = 0; i < count; i++)
+        {
+            system->assets[i].texture = (Texture2D){0};
+            system->assets[i].region = regions[i];
+        }
+        printf("atlas %dx%d for %d assets\n", width, height, count);
+    }
+    free(sizes);
+    free(regions);
+    return packed;
+}
+
+static int RunCase(AsteroidSystem *system, const BenchCase *bench, int frames)
+{
+    if (bench->atlas)
+    {
+        if (!UseAtlas(system)) return 0;
+    }
+    else
+    {
+        UseAssetTextures(system);
+    }
+
+    SpriteBatch batch;
+    SpriteBatch_Init(&batch, SPRITE_BACKEND_RECORD);
+    batch.sort = bench->sort;
+    uint64_t ns = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        uint64_t t0 = Clock_NowNs();
+        SpriteBatch_BeginFrame(&batch);
+        // A 1280x720 view at the field centre.
+        if (bench->cull) SpriteBatch_SetView(&batch, (Rectangle){ -640.0f, -360.0f, 1280.0f, 720.0f });
+        Asteroids_Draw(system, &batch);
+        SpriteBatch_Flush(&batch);
+        ns += Clock_NowNs() - t0;
+    }
+
+    printf("%-22s submitted=%6d culled=%6d drawn=%6d batches=%5d  %7.1f us/frame  %5.1f ns/sprite\n", bench->name,
+           batch.stats.submitted, batch.stats.culled, batch.stats.drawn, batch.stats.batches,
+           (double)ns / 1e3 / frames,
+           (batch.stats.submitted > 0) ? (double)ns / frames / batch.stats.submitted : 0.0);
+
+    int ok = 1;
+    int expected = bench->atlas ? 1 : system->asset_count;
+    if (bench->sort && batch.stats.drawn > 0 && batch.stats.batches > expected)
+    {
+        fprintf(stderr, "bench_sprites: %s: %d batches, expected at most %d\n", bench->name, batch.stats.batches, expected);
+        ok = 0;
+    }
+    if (batch.stats.drawn + batch.stats.culled != batch.stats.submitted || batch.call_count != batch.stats.batches)
+    {
+        fprintf(stderr, "bench_sprites: %s: inconsistent stats\n", bench->name);
+        ok = 0;
+    }
+    SpriteBatch_Free(&batch);
+    return ok;
+}
+
+// Batched indices have to match single-instance sampling exactly, including
+// before the start and far into a loop.
+static int CheckClip(const SpriteClip *clip, const float *starts, int count, int *indices)
+{
+    static const float times[] = { 0.0f, 0.5f, 3.3f, 17.0f, 600.25f, 86400.0f };
+    for (size_t t = 0; t < sizeof(times) / sizeof(times[0]); t++)
+    {
+        SpriteClip_ResolveFrames(clip, times[t], starts, count, indices);
+        for (int i = 0; i < count; i++)
+        {
+            if (indices[i] != SpriteClip_FrameAt(clip, times[t] - starts[i]))
+            {
+                fprintf(stderr, "bench_sprites: clip frame mismatch at t=%.2f start=%.4f: %d vs %d\n", times[t],
+                        starts[i], indices[i], SpriteClip_FrameAt(clip, times[t] - starts[i]));
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static int RunAnimCase(int instances, int frames)
+{
+    // Frame table only: the stand-in texture is never uploaded or unloaded.
+    SpriteSheet sheet = SpriteSheet_FromTexture(
+        (Texture2D){ 200u, BENCH_ANIM_FRAME * BENCH_ANIM_FRAMES, BENCH_ANIM_FRAME, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 },
+        BENCH_ANIM_FRAME, BENCH_ANIM_FRAME);
+    SpriteClip loop = SpriteClip_Make(&sheet, 0, 0, 0.08f, SPRITE_CLIP_LOOP);
+    SpriteClip once = SpriteClip_Make(&sheet, 2, 5, 0.05f, SPRITE_CLIP_ONCE);
+
+    float *starts = malloc((size_t)instances * sizeof(float));
+    float *xs = malloc((size_t)instances * sizeof(float));
+    float *ys = malloc((size_t)instances * sizeof(float));
+    int *indices = malloc((size_t)instances * sizeof(int));
+    SpriteAnim *anims = malloc((size_t)instances * sizeof(SpriteAnim));
+    Rng rng = Rng_Create(BENCH_SEED, 7u);
+    Rng_FillFloats(&rng, starts, instances, 0.0f, 10.0f);
+    Rng_FillFloats(&rng, xs, instances, -BENCH_FIELD_RADIUS, BENCH_FIELD_RADIUS);
+    Rng_FillFloats(&rng, ys, instances, -BENCH_FIELD_RADIUS, BENCH_FIELD_RADIUS);
+    int ok = CheckClip(&loop, starts, instances, indices) && CheckClip(&once, starts, instances, indices);
+
+    SpriteBatch batch;
+    SpriteBatch_Init(&batch, SPRITE_BACKEND_RECORD);
+    Vector2 origin = { BENCH_ANIM_FRAME * 0.5f, BENCH_ANIM_FRAME * 0.5f };
+
+    // Stateless: one resolve pass per frame, then submit.
+    uint64_t resolve_ns = 0;
+    uint64_t clip_ns = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        uint64_t t0 = Clock_NowNs();
+        SpriteBatch_BeginFrame(&batch);
+        SpriteClip_ResolveFrames(&loop, 10.0f + (float)f * BENCH_FRAME_DT, starts, instances, indices);
+        resolve_ns += Clock_NowNs() - t0;
+        for (int i = 0; i < instances; i++)
+        {
+            Rectangle dest = { xs[i], ys[i], BENCH_ANIM_FRAME, BENCH_ANIM_FRAME };
+            SpriteBatch_Submit(&batch, sheet.texture, sheet.frames[indices[i]], dest, origin, 0.0f, WHITE,
+                               SPRITE_LAYER_ENGINE);
+        }
+        SpriteBatch_Flush(&batch);
+        clip_ns += Clock_NowNs() - t0;
+    }
+
+    // Per-instance clocks, ticked every frame.
+    for (int i = 0; i < instances; i++)
+    {
+        SpriteAnim_Init(&anims[i], &sheet, loop.frame_time);
+        SpriteAnim_Update(&anims[i], 10.0f - starts[i]);
+    }
+    uint64_t update_ns = 0;
+    uint64_t anim_ns = 0;
+    for (int f = 0; f < frames; f++)
+    {
+        uint64_t t0 = Clock_NowNs();
+        SpriteBatch_BeginFrame(&batch);
+        for (int i = 0; i < instances; i++) SpriteAnim_Update(&anims[i], BENCH_FRAME_DT);
+        update_ns += Clock_NowNs() - t0;
+        for (int i = 0; i < instances; i++)
+        {
+            Rectangle dest = { xs[i], ys[i], BENCH_ANIM_FRAME, BENCH_ANIM_FRAME };
+            SpriteBatch_Submit(&batch, sheet.texture, anims[i].frame, dest, origin, 0.0f, WHITE, SPRITE_LAYER_ENGINE);
+        }
+        SpriteBatch_Flush(&batch);
+        anim_ns += Clock_NowNs() - t0;
+    }
+
+    printf("%-22s instances=%6d  resolve %6.1f us/frame (%4.2f ns/sprite)  frame %7.1f us\n", "anim clips batched",
+           instances, (double)resolve_ns / 1e3 / frames, (double)resolve_ns / frames / instances,
+           (double)clip_ns / 1e3 / frames);
+    printf("%-22s instances=%6d  update  %6.1f us/frame (%4.2f ns/sprite)  frame %7.1f us\n", "anim per-instance",
+           instances, (double)update_ns / 1e3 / frames, (double)update_ns / frames / instances,
+           (double)anim_ns / 1e3 / frames);
+    printf("clip frames: %s\n", ok ? "OK" : "MISMATCH");
+
+    SpriteBatch_Free(&batch);
+    free(anims);
+    free(indices);
+    free(ys);
+    free(xs);
+    free(starts);
+    free(sheet.frames);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int asteroids = (argc > 1) ? atoi(argv[1]) : 10000;
+    int frames = (argc > 2) ? atoi(argv[2]) : 200;
+    if (asteroids <= 0) asteroids = 10000;
+    if (frames <= 0) frames = 200;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem system;
+    Asteroids_Init(&system, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (system.asset_count == 0)
+    {
+        fprintf(stderr, "bench_sprites: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+    Asteroids_SpawnField(&system, (Vector2){ 0.0f, 0.0f }, asteroids, BENCH_FIELD_RADIUS);
+    printf("asteroids=%d assets=%d frames=%d\n", Asteroids_Count(&system), system.asset_count, frames);
+
+    const BenchCase cases[] = {
+        { "per-texture unsorted", 0, 0, 0 },
+        { "per-texture sorted", 1, 0, 0 },
+        { "atlas sorted", 1, 1, 0 },
+        { "atlas sorted culled", 1, 1, 1 },
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        ok &= RunCase(&system, &cases[i], frames);
+    }
+    ok &= RunAnimCase(asteroids, frames);
+
+    // The stand-in textures were never uploaded.
+    UseAssetTextures(&system);
+    for (int i = 0; i < system.asset_count; i++) system.assets[i].texture = (Texture2D){0};
+    Asteroids_Unload(&system);
+    AssetPack_Unmount();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+// Swept collision benchmark: the same fast-moving field run for the same
+// simulated time at 1/120 s steps (the reference) and at 1/60 to 1/15 s, with
+// swept and with end-position-only collision. Compares each run's collision
+// events (which pairs of rocks hit, and when) with the reference and reports
+// throughput in simulated seconds per wall second. Exits non-zero if a swept
+// run misses, adds or mistimes (by more than one reference step) more than
+// BENCH_MAX_MISMATCH of the reference events. Rocks are destroyed on contact
+// (ASTEROID_RESPONSE_DESTROY), so every event is a first impact and the sets
+// only depend on detection.
+// Run from the repository root (loads the asteroid masks).
+// Usage: bench_swept [asteroids] [seconds] [threads]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "job_system.h"
+#include "world.h"
+
+#define BENCH_SEED 42u
+// Fast enough that rocks move further than their size in a long step.
+#define BENCH_SPEED 900.0f
+#define BENCH_AREA_PER_ROCK (300.0f * 300.0f)
+#define BENCH_REFERENCE_HZ 120
+// Positions accumulate float rounding differently at different step lengths,
+// so a contact that only grazes a pixel can come and go (and with it the
+// rocks' later hits, or the same pair meets a few pixels further on);
+// everything else has to match, to within one reference step.
+#define BENCH_MAX_MISMATCH 0.01
+#define BENCH_MAX_TIME_ERROR (1.0 / BENCH_REFERENCE_HZ)
+
+typedef struct BenchEvent
+{
+    uint32_t a;
+    uint32_t b;
+    double time;
+} BenchEvent;
+
+typedef struct BenchRun
+{
+    BenchEvent *events;
+    int event_count;
+    int event_capacity;
+    double wall_seconds;
+    int ticks;
+} BenchRun;
+
+typedef struct BenchCompare
+{
+    int matched;
+    int missing;
+    int extra;
+    // Matched, but more than BENCH_MAX_TIME_ERROR apart.
+    int late;
+    double max_time_error;
+} BenchCompare;
+
+static int CompareEvents(const void *a, const void *b)
+{
+    const BenchEvent *ea = (const BenchEvent *)a;
+    const BenchEvent *eb = (const BenchEvent *)b;
+    if (ea->a != eb->a) return (ea->a < eb->a) ? -1 : 1;
+    return (ea->b > eb->b) - (ea->b < eb->b);
+}
+
+static void AddEvent(BenchRun *run, const AsteroidCollision *collision, double tick_start)
+{
+    if (run->event_count == run->event_capacity)
+    {
+        int capacity = (run->event_capacity > 0) ? run->event_capacity * 2 : 256;
+        BenchEvent *grown = (BenchEvent *)realloc(run->events, (size_t)capacity * sizeof(BenchEvent));
+        if (grown == NULL) return;
+        run->events = grown;
+        run->event_capacity = capacity;
+    }
+    // Field rocks keep their handles for the whole run (nothing spawns), so
+    // slot indices identify rocks across runs.
+    uint32_t a = collision->a.index;
+    uint32_t b = collision->b.index;
+    run->events[run->event_count++] = (BenchEvent){ (a < b) ? a : b, (a < b) ? b : a, tick_start + collision->time };
+}
+
+static BenchRun Run(const AsteroidSystem *source, JobSystem *jobs, int asteroids, double seconds, int hz, int swept)
+{
+    BenchRun run = {0};
+    AsteroidSystem system;
+    Asteroids_InitShared(&system, source, BENCH_SEED);
+    system.jobs = jobs;
+    system.stream_sectors = 0;
+    system.swept_collisions = swept;
+    system.collision_response = ASTEROID_RESPONSE_DESTROY;
+    system.speed = BENCH_SPEED;
+    Vector2 center = { 0.0f, 0.0f };
+    Asteroids_SpawnField(&system, center, asteroids, sqrtf((float)asteroids * BENCH_AREA_PER_ROCK / PI));
+
+    float dt = 1.0f / (float)hz;
+    run.ticks = (int)lround(seconds * hz);
+    uint64_t t0 = Clock_NowNs();
+    for (int t = 0; t < run.ticks; t++)
+    {
+        Asteroids_Update(&system, dt, center);
+        // Without sweeping, a hit is only seen at the end of the step.
+        double tick_start = (double)t / hz;
+        for (int i = 0; i < system.collision_count; i++)
+        {
+            AddEvent(&run, &system.collisions[i], swept ? tick_start : tick_start + dt);
+        }
+    }
+    run.wall_seconds = (double)(Clock_NowNs() - t0) / 1e9;
+    Asteroids_Unload(&system);
+    qsort(run.events, (size_t)run.event_count, sizeof(BenchEvent), CompareEvents);
+    return run;
+}
+
+static BenchCompare Compare(const BenchRun *reference, const BenchRun *run)
+{
+    BenchCompare result = {0};
+    int i = 0;
+    int j = 0;
+    while (i < reference->event_count || j < run->event_count)
+    {
+        int order = (i == reference->event_count) ? 1
+                  : (j == run->event_count) ? -1
+                  : CompareEvents(&reference->events[i], &run->events[j]);
+        if (order == 0)
+        {
+            double error = fabs(reference->events[i].time - run->events[j].time);
+            if (error > result.max_time_error) result.max_time_error = error;
+            result.late += error > BENCH_MAX_TIME_ERROR;
+            result.matched++;
+            i++;
+            j++;
+        }
+        else if (order < 0)
+        {
+            result.missing++;
+            i++;
+        }
+        else
+        {
+            result.extra++;
+            j++;
+        }
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int asteroids = (argc > 1) ? atoi(argv[1]) : 4000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 4.0;
+    int threads = (argc > 3) ? atoi(argv[3]) : 1;
+    if (asteroids < 1) asteroids = 4000;
+    if (seconds <= 0.0) seconds = 4.0;
+    if (threads < 1) threads = 1;
+
+    AssetPack_Mount(ASSET_PACK_DEFAULT_PATH);
+    AsteroidSystem source;
+    Asteroids_Init(&source, ASTEROID_DEFAULT_DIRECTORY, 0, BENCH_SEED);
+    if (source.asset_count == 0)
+    {
+        fprintf(stderr, "bench_swept: no asteroid assets (run from the repository root)\n");
+        return 1;
+    }
+    JobSystem jobs;
+    JobSystem_Init(&jobs, threads);
+
+    BenchRun reference = Run(&source, &jobs, asteroids, seconds, BENCH_REFERENCE_HZ, 1);
+    printf("asteroids=%d seconds=%.1f speed=%.0f threads=%d reference: %d Hz swept, %d events, %.2f sim s/s\n",
+           asteroids, seconds, BENCH_SPEED, JobSystem_ThreadCount(&jobs), BENCH_REFERENCE_HZ, reference.event_count,
+           seconds / reference.wall_seconds);
+    printf("%-5s %-8s %7s %8s %8s %6s %5s %12s %10s %10s\n", "hz", "mode", "events", "matched", "missing", "extra",
+           "late", "time_err_ms", "ns/tick", "sim s/s");
+
+    static const int hzs[] = { 60, 30, 20, 15 };
+    int ok = 1;
+    for (size_t h = 0; h < sizeof(hzs) / sizeof(hzs[0]); h++)
+    {
+        for (int swept = 1; swept >= 0; swept--)
+        {
+            BenchRun run = Run(&source, &jobs, asteroids, seconds, hzs[h], swept);
+            BenchCompare cmp = Compare(&reference, &run);
+            printf("%-5d %-8s %7d %8d %8d %6d %5d %12.3f %10.0f %10.2f\n", hzs[h], swept ? "swept" : "discrete",
+                   run.event_count, cmp.matched, cmp.missing, cmp.extra, cmp.late, cmp.max_time_error * 1000.0,
+                   run.wall_seconds * 1e9 / run.ticks, seconds / run.wall_seconds);
+            if (swept && cmp.missing + cmp.extra + cmp.late > BENCH_MAX_MISMATCH * reference.event_count) ok = 0;
+            free(run.events);
+        }
+    }
+    printf("swept events at 1/60-1/15 s: %s (tolerance %.0f%%, late beyond %.2f ms)\n", ok ? "OK" : "MISMATCH",
+           BENCH_MAX_MISMATCH * 100.0, BENCH_MAX_TIME_ERROR * 1000.0);
+
+    free(reference.events);
+    JobSystem_Shutdown(&jobs);
+    Asteroids_Unload(&source);
+    AssetPack_Unmount();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+#include "asset_loader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asset_pack.h"
+#include "clock.h"
+#include "memory.h"
+
+// Worker side: pixels from the pack (a view, no decode) or the PNG, then the
+// request's own CPU work.
+static void DecodeRequest(AssetRequest *request)
+{
+    double start = Clock_NowSeconds();
+    const AssetPackEntry *entry = AssetPack_Lookup(request->path);
+    if (entry != NULL)
+    {
+        request->image = AssetPack_ImageView(AssetPack_Mounted(), entry);
+        request->from_pack = request->image.data != NULL;
+    }
+    if (request->image.data == NULL)
+    {
+        request->image = LoadImage(request->path);
+        if (request->image.data != NULL) ImageFormat(&request->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    }
+
+    int ok = request->image.data != NULL;
+    if (ok && request->on_decoded != NULL) ok = request->on_decoded(request->user, request->tag, request);
+    request->decode_ms = (Clock_NowSeconds() - start) * 1000.0;
+    atomic_store_explicit(&request->state, ok ? ASSET_DECODED : ASSET_FAILED, memory_order_release);
+}
+
+static void DecodeRange(void *user, int begin, int end)
+{
+    AssetLoader *loader = (AssetLoader *)user;
+    for (int i = begin; i < end; i++)
+    {
+        DecodeRequest(&loader->requests[i]);
+    }
+}
+
+static void ReleaseImage(AssetRequest *request)
+{
+    if (request->image.data != NULL && !request->from_pack) UnloadImage(request->image);
+    request->image = (Image){0};
+}
+
+void AssetLoader_Init(AssetLoader *loader, JobSystem *jobs)
+{
+    memset(loader, 0, sizeof(*loader));
+    loader->jobs = jobs;
+    JobCounter_Init(&loader->decoding);
+}
+
+int AssetLoader_Request(AssetLoader *loader, const char *path, AssetDecodedFn on_decoded,
+                        AssetReadyFn on_ready, void *user, int tag)
+{
+    // Jobs hold pointers into the array, so it only grows before Start.
+    if (loader->started) return -1;
+    if (!Memory_GrowArray((void **)&loader->requests, &loader->request_capacity, loader->request_count + 1,
+                          sizeof(AssetRequest), 32))
+    {
+        return -1;
+    }
+    AssetRequest *request = &loader->requests[loader->request_count];
+    memset(request, 0, sizeof(*request));
+    snprintf(request->path, sizeof(request->path), "%s", path);
+    request->on_decoded = on_decoded;
+    request->on_ready = on_ready;
+    request->user = user;
+    request->tag = tag;
+    atomic_init(&request->state, ASSET_PENDING);
+    return loader->request_count++;
+}
+
+int AssetLoader_RequestTexture(AssetLoader *loader, const char *path, Texture2D *target)
+{
+    int index = AssetLoader_Request(loader, path, NULL, NULL, NULL, 0);
+    if (index >= 0) loader->requests[index].texture_target = target;
+    return index;
+}
+
+int AssetLoader_RequestSheet(AssetLoader *loader, const char *path, int frame_width, int frame_height,
+                             SpriteSheet *sheet, SpriteAnim *anim, float frame_time)
+{
+    int index = AssetLoader_Request(loader, path, NULL, NULL, NULL, 0);
+    if (index < 0) return index;
+    AssetRequest *request = &loader->requests[index];
+    request->sheet_target = sheet;
+    request->anim_target = anim;
+    request->frame_width = frame_width;
+    request->frame_height = frame_height;
+    request->frame_time = frame_time;
+    return index;
+}
+
+void AssetLoader_Start(AssetLoader *loader)
+{
+    if (loader->started) return;
+    loader->started = 1;
+    loader->start_time = Clock_NowSeconds();
+    // One job per asset: decode times vary a lot (a 2 KB laser sprite next to
+    // a full-screen background), so let stealing balance them.
+    for (int i = 0; i < loader->request_count; i++)
+    {
+        JobSystem_Submit(loader->jobs, DecodeRange, loader, i, i + 1, &loader->decoding);
+    }
+}
+
+// Main thread: hand the result to its target and the callback, once.
+static void Resolve(AssetLoader *loader, AssetRequest *request, int state)
+{
+    if (request->texture_target != NULL && state == ASSET_READY) *request->texture_target = request->texture;
+    if (request->sheet_target != NULL)
+    {
+        *request->sheet_target = SpriteSheet_FromTexture(request->texture, request->frame_width, request->frame_height);
+        if (request->anim_target != NULL) SpriteAnim_Init(request->anim_target, request->sheet_target, request->frame_time);
+    }
+    if (request->on_ready != NULL) request->on_ready(request->user, request->tag, request);
+
+    TraceLog(LOG_INFO, "asset: %s decode %.2f ms%s upload %.2f ms%s", request->path, request->decode_ms,
+             request->from_pack ? " (pack)" : "", request->upload_ms, (state == ASSET_READY) ? "" : " FAILED");
+
+    loader->resolved++;
+    if (loader->resolved == loader->request_count)
+    {
+        loader->done_ms = (Clock_NowSeconds() - loader->start_time) * 1000.0;
+        TraceLog(LOG_INFO, "assets: %d loaded in %.1f ms", loader->request_count, loader->done_ms);
+    }
+}
+
+int AssetLoader_Pump(AssetLoader *loader, double budget_ms)
+{
+    if (!loader->started) return loader->request_count;
+
+    double start = Clock_NowSeconds();
+    int uploads = 0;
+    for (int i = 0; i < loader->request_count; i++)
+    {
+        AssetRequest *request = &loader->requests[i];
+        if (request->resolved) continue;
+        int state = atomic_load_explicit(&request->state, memory_order_acquire);
+        if (state == ASSET_DECODED && request->cpu_only)
+        {
+            state = ASSET_READY;
+            atomic_store_explicit(&request->state, state, memory_order_relaxed);
+        }
+        else if (state == ASSET_DECODED)
+        {
+            if (uploads > 0 && (Clock_NowSeconds() - start) * 1000.0 >= budget_ms) break;
+
+            double upload_start = Clock_NowSeconds();
+            request->texture = LoadTextureFromImage(request->image);
+            ReleaseImage(request);
+            request->upload_ms = (Clock_NowSeconds() - upload_start) * 1000.0;
+            uploads++;
+
+            state = (request->texture.id != 0) ? ASSET_READY : ASSET_FAILED;
+            atomic_store_explicit(&request->state, state, memory_order_relaxed);
+        }
+        if (state == ASSET_READY || state == ASSET_FAILED)
+        {
+            ReleaseImage(request);
+            request->resolved = 1;
+            Resolve(loader, request, state);
+        }
+    }
+    return loader->request_count - loader->resolved;
+}
+
+void AssetLoader_Progress(const AssetLoader *loader, int *out_resolved, int *out_total)
+{
+    if (out_resolved != NULL) *out_resolved = loader->resolved;
+    if (out_total != NULL) *out_total = loader->request_count;
+}
+
+void AssetLoader_Free(AssetLoader *loader)
+{
+    if (loader->started) JobSystem_Wait(loader->jobs, &loader->decoding);
+    for (int i = 0; i < loader->request_count; i++)
+    {
+        ReleaseImage(&loader->requests[i]);
+    }
+    free(loader->requests);
+    memset(loader, 0, sizeof(*loader));
+}
@@ -0,0 +1,108 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <stdatomic.h>
+
+#include "raylib.h"
+#include "job_system.h"
+#include "spritesheet.h"
+
+// Asynchronous texture loader for the windowed game. Decoding (or mapping,
+// when the asset pack holds the file) and per-request CPU work such as mask
+// baking run as jobs; only the GPU upload happens on the main thread, in
+// AssetLoader_Pump, a frame-budgeted slice at a time. Each request names
+// where its result goes (a texture slot, a sprite sheet, or a callback), so
+// a request is a handle that simply fills in once ready and the game can
+// draw frames while the rest streams in.
+//
+// Usage: Request* everything, AssetLoader_Start, then AssetLoader_Pump once
+// per frame until it returns 0. With a single-threaded (or NULL) job system
+// Start decodes everything inline before returning.
+
+#define ASSET_LOADER_PATH_MAX 256
+// Upload time per Pump call; at least one upload always happens.
+#define ASSET_LOADER_UPLOAD_BUDGET_MS 4.0
+
+enum
+{
+    ASSET_PENDING,
+    ASSET_DECODED,
+    ASSET_READY,
+    ASSET_FAILED
+};
+
+typedef struct AssetRequest AssetRequest;
+
+// Runs in the decode job, on a worker thread, with request->image decoded
+// (e.g. to bake collision masks into storage the caller owns). Returning 0
+// fails the request.
+typedef int (*AssetDecodedFn)(void *user, int tag, const AssetRequest *request);
+// Runs on the main thread once the request is READY or FAILED.
+typedef void (*AssetReadyFn)(void *user, int tag, const AssetRequest *request);
+
+struct AssetRequest
+{
+    char path[ASSET_LOADER_PATH_MAX];
+    AssetDecodedFn on_decoded;
+    AssetReadyFn on_ready;
+    void *user;
+    int tag;
+    atomic_int state;
+    // Filled by the decode job. The image is a view into the asset pack when
+    // from_pack is set; either way it is released after the upload.
+    Image image;
+    int from_pack;
+    double decode_ms;
+    // Filled by the upload.
+    Texture2D texture;
+    double upload_ms;
+    // Set right after Request to skip the upload: the request resolves READY
+    // with no texture once decoded (on_decoded keeps what it needs).
+    int cpu_only;
+    // Set once the targets and on_ready have been handed the result.
+    int resolved;
+    // Targets of the RequestTexture / RequestSheet helpers.
+    Texture2D *texture_target;
+    SpriteSheet *sheet_target;
+    SpriteAnim *anim_target;
+    int frame_width;
+    int frame_height;
+    float frame_time;
+};
+
+typedef struct AssetLoader
+{
+    JobSystem *jobs;
+    AssetRequest *requests;
+    int request_count;
+    int request_capacity;
+    JobCounter decoding;
+    int started;
+    int resolved;
+    double start_time;
+    double done_ms;
+} AssetLoader;
+
+// jobs may be NULL (decode inline in Start); the loader does not own it.
+void AssetLoader_Init(AssetLoader *loader, JobSystem *jobs);
+// Generic request: decode path, call on_decoded (may be NULL) on the worker,
+// upload, then call on_ready (may be NULL). Returns the request index, or -1
+// once the loader has started or on allocation failure.
+int AssetLoader_Request(AssetLoader *loader, const char *path, AssetDecodedFn on_decoded,
+                        AssetReadyFn on_ready, void *user, int tag);
+// *target receives the texture when it is uploaded.
+int AssetLoader_RequestTexture(AssetLoader *loader, const char *path, Texture2D *target);
+// *sheet is rebuilt from the texture once uploaded (frame sizes as in
+// SpriteSheet_Load, <= 0 for square frames) and *anim (may be NULL) restarted
+// on it.
+int AssetLoader_RequestSheet(AssetLoader *loader, const char *path, int frame_width, int frame_height,
+                             SpriteSheet *sheet, SpriteAnim *anim, float frame_time);
+void AssetLoader_Start(AssetLoader *loader);
+// Uploads decoded assets for up to budget_ms and runs their callbacks.
+// Returns the number of requests not yet resolved.
+int AssetLoader_Pump(AssetLoader *loader, double budget_ms);
+void AssetLoader_Progress(const AssetLoader *loader, int *out_resolved, int *out_total);
+// Waits for outstanding decode jobs and frees anything not handed out.
+void AssetLoader_Free(AssetLoader *loader);
+
+#endif
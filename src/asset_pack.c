@@ -0,0 +1,253 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "asset_pack.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static AssetPack mounted_pack;
+static int mounted = 0;
+
+// offset + size lies inside the mapping (overflow-safe).
+static int InRange(const AssetPack *pack, uint64_t offset, uint64_t size)
+{
+    return offset <= pack->size && size <= pack->size - offset;
+}
+
+int AssetPack_Open(AssetPack *pack, const char *path)
+{
+    memset(pack, 0, sizeof(*pack));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(AssetPackHeader))
+    {
+        close(fd);
+        return 0;
+    }
+    void *base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    pack->base = (const unsigned char *)base;
+    pack->size = (size_t)info.st_size;
+    pack->header = (const AssetPackHeader *)base;
+
+    const AssetPackHeader *header = pack->header;
+    if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION ||
+        header->file_size != (uint64_t)pack->size ||
+        !InRange(pack, header->entries_offset, (uint64_t)header->entry_count * sizeof(AssetPackEntry)) ||
+        !InRange(pack, header->strings_offset, header->strings_size) || header->strings_size == 0 ||
+        pack->base[header->strings_offset + header->strings_size - 1] != '\0')
+    {
+        AssetPack_Close(pack);
+        return 0;
+    }
+    pack->entries = (const AssetPackEntry *)(pack->base + header->entries_offset);
+    pack->strings = (const char *)(pack->base + header->strings_offset);
+
+    for (uint32_t i = 0; i < header->entry_count; i++)
+    {
+        if (pack->entries[i].name_offset >= header->strings_size)
+        {
+            AssetPack_Close(pack);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void AssetPack_Close(AssetPack *pack)
+{
+    if (pack->base != NULL) munmap((void *)pack->base, pack->size);
+    memset(pack, 0, sizeof(*pack));
+}
+
+const char *AssetPack_EntryName(const AssetPack *pack, const AssetPackEntry *entry)
+{
+    return pack->strings + entry->name_offset;
+}
+
+const AssetPackEntry *AssetPack_Find(const AssetPack *pack, const char *name)
+{
+    if (pack == NULL || pack->header == NULL) return NULL;
+    int lo = 0;
+    int hi = (int)pack->header->entry_count - 1;
+    while (lo <= hi)
+    {
+        int mid = lo + (hi - lo) / 2;
+        int order = strcmp(AssetPack_EntryName(pack, &pack->entries[mid]), name);
+        if (order == 0) return &pack->entries[mid];
+        if (order < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+static Image ImageViewAt(const AssetPack *pack, int width, int height, uint64_t offset)
+{
+    Image image = {0};
+    uint64_t bytes = (uint64_t)width * (uint64_t)height * 4u;
+    if (width <= 0 || height <= 0 || !InRange(pack, offset, bytes)) return image;
+    image.data = (void *)(pack->base + offset);
+    image.width = width;
+    image.height = height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return image;
+}
+
+Image AssetPack_ImageView(const AssetPack *pack, const AssetPackEntry *entry)
+{
+    return ImageViewAt(pack, entry->width, entry->height, entry->pixels_offset);
+}
+
+// Bounds are either those of an empty mask (see BitMask_Alloc) or inside it.
+static int MaskBoundsValid(const AssetPackMask *src)
+{
+    if (src->min_x == src->width && src->min_y == src->height && src->max_x == -1 && src->max_y == -1) return 1;
+    return src->min_x >= 0 && src->min_x <= src->max_x && src->max_x < src->width &&
+           src->min_y >= 0 && src->min_y <= src->max_y && src->max_y < src->height;
+}
+
+static int MaskView(const AssetPack *pack, const AssetPackMask *src, BitMask *mask)
+{
+    uint64_t bytes = (uint64_t)src->words_per_row * (uint64_t)(src->height > 0 ? src->height : 0) * sizeof(uint64_t);
+    if (src->width < 0 || src->height < 0 || src->words_per_row < 0 || !InRange(pack, src->bits_offset, bytes)) return 0;
+    if (src->bits_offset % sizeof(uint64_t) != 0) return 0;
+    // Every pixel of a row must lie in its words.
+    if ((int64_t)src->words_per_row * 64 < (int64_t)src->width) return 0;
+    if (!MaskBoundsValid(src)) return 0;
+    mask->width = src->width;
+    mask->height = src->height;
+    mask->words_per_row = src->words_per_row;
+    mask->bits = (bytes > 0) ? (uint64_t *)(pack->base + src->bits_offset) : NULL;
+    mask->min_x = src->min_x;
+    mask->min_y = src->min_y;
+    mask->max_x = src->max_x;
+    mask->max_y = src->max_y;
+    return 1;
+}
+
+static int SdfView(const AssetPack *pack, const AssetPackSdf *src, CollisionShape *shape)
+{
+    if (src->width == 0 && src->height == 0) return 1;
+    if (src->width < 2 || src->height < 2) return 0;
+    uint64_t bytes = (uint64_t)src->width * (uint64_t)src->height * sizeof(int16_t);
+    if (!InRange(pack, src->offset, bytes) || src->offset % sizeof(int16_t) != 0) return 0;
+    shape->sdf = (int16_t *)(pack->base + src->offset);
+    shape->sdf_x = src->x;
+    shape->sdf_y = src->y;
+    shape->sdf_width = src->width;
+    shape->sdf_height = src->height;
+    return 1;
+}
+
+static int ShapeViewsAt(const AssetPack *pack, uint32_t shape_count, uint64_t offset, CollisionShape *shapes, int count)
+{
+    if (count <= 0 || shape_count != (uint32_t)count) return 0;
+    if (!InRange(pack, offset, (uint64_t)count * sizeof(AssetPackShape))) return 0;
+
+    const AssetPackShape *src = (const AssetPackShape *)(pack->base + offset);
+    for (int s = 0; s < count; s++)
+    {
+        CollisionShape *shape = &shapes[s];
+        memset(shape, 0, sizeof(*shape));
+        if (!MaskView(pack, &src[s].fine, &shape->fine)) return 0;
+        for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+        {
+            CollisionLevel *level = &shape->levels[l];
+            level->block = src[s].levels[l][0].block;
+            if (level->block <= 0) return 0;
+            // Level masks are indexed by fine pixel / block: their sizes
+            // must follow from the fine mask's (see BuildLevel).
+            int cw = (shape->fine.width + level->block - 1) / level->block;
+            int ch = (shape->fine.height + level->block - 1) / level->block;
+            if (src[s].levels[l][0].width != cw || src[s].levels[l][0].height != ch ||
+                src[s].levels[l][1].width != cw + 1 || src[s].levels[l][1].height != ch + 1 ||
+                src[s].levels[l][2].width != cw || src[s].levels[l][2].height != ch)
+            {
+                return 0;
+            }
+            if (!MaskView(pack, &src[s].levels[l][0], &level->any) ||
+                !MaskView(pack, &src[s].levels[l][1], &level->any_dilated) ||
+                !MaskView(pack, &src[s].levels[l][2], &level->all))
+            {
+                return 0;
+            }
+        }
+        shape->circle_x = src[s].circle_x;
+        shape->circle_y = src[s].circle_y;
+        shape->circle_radius = src[s].circle_radius;
+        shape->area = src[s].area;
+        if (!SdfView(pack, &src[s].sdf, shape)) return 0;
+        if (src[s].outline_count < 0 || src[s].outline_count > COLLISION_SHAPE_OUTLINE) return 0;
+        shape->outline_count = src[s].outline_count;
+        memcpy(shape->outline_x, src[s].outline_x, sizeof(shape->outline_x));
+        memcpy(shape->outline_y, src[s].outline_y, sizeof(shape->outline_y));
+    }
+    return 1;
+}
+
+int AssetPack_ShapeViews(const AssetPack *pack, const AssetPackEntry *entry, CollisionShape *shapes, int count)
+{
+    return ShapeViewsAt(pack, entry->shape_count, entry->shapes_offset, shapes, count);
+}
+
+const AssetPackFracture *AssetPack_Fracture(const AssetPack *pack, const AssetPackEntry *entry)
+{
+    if (entry->fracture_offset == 0 || !InRange(pack, entry->fracture_offset, sizeof(AssetPackFracture))) return NULL;
+    if (entry->fracture_offset % sizeof(uint64_t) != 0) return NULL;
+    const AssetPackFracture *fracture = (const AssetPackFracture *)(pack->base + entry->fracture_offset);
+    if (fracture->piece_count < 0 || fracture->piece_count > FRACTURE_MAX_PIECES) return NULL;
+    return fracture;
+}
+
+Image AssetPack_FragmentImageView(const AssetPack *pack, const AssetPackFragment *fragment)
+{
+    return ImageViewAt(pack, fragment->width, fragment->height, fragment->pixels_offset);
+}
+
+int AssetPack_FragmentShapeViews(const AssetPack *pack, const AssetPackFragment *fragment, CollisionShape *shapes,
+                                 int count)
+{
+    return ShapeViewsAt(pack, fragment->shape_count, fragment->shapes_offset, shapes, count);
+}
+
+int AssetPack_Mount(const char *path)
+{
+    AssetPack_Unmount();
+    mounted = AssetPack_Open(&mounted_pack, path);
+    return mounted;
+}
+
+void AssetPack_Unmount(void)
+{
+    if (mounted) AssetPack_Close(&mounted_pack);
+    mounted = 0;
+}
+
+const AssetPack *AssetPack_Mounted(void)
+{
+    return mounted ? &mounted_pack : NULL;
+}
+
+const AssetPackEntry *AssetPack_Lookup(const char *path)
+{
+    return mounted ? AssetPack_Find(&mounted_pack, path) : NULL;
+}
+
+Texture2D AssetPack_LoadTexture(const char *path)
+{
+    const AssetPackEntry *entry = AssetPack_Lookup(path);
+    if (entry != NULL)
+    {
+        Image view = AssetPack_ImageView(&mounted_pack, entry);
+        if (view.data != NULL) return LoadTextureFromImage(view);
+    }
+    return LoadTexture(path);
+}
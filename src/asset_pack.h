@@ -0,0 +1,176 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "raylib.h"
+#include "collision_shape.h"
+#include "fracture.h"
+
+// Cooked asset pack, written offline by cook_assets and memory-mapped at
+// startup. Everything the loaders would otherwise decode or bake is stored
+// ready to use: raw RGBA8 pixels, SpriteSheet frame tables, pre-built
+// collision shapes and asteroid fracture tables. Readers get views straight into the mapping, nothing is
+// copied or parsed.
+//
+// Layout (all offsets from the start of the file, blobs 64-byte aligned):
+//   AssetPackHeader
+//   AssetPackEntry[entry_count]    sorted by name (strcmp), for binary search
+//   string table                   NUL-terminated names
+//   blobs                          pixels, AssetPackShape arrays, mask bits,
+//                                  distance fields, AssetPackFracture tables
+//
+// Names are the paths the loaders are called with (e.g.
+// "Assets/Textures/Background/Space Background.png"). The pack is only valid
+// on the endianness and struct layout it was cooked with; the version is
+// bumped whenever any of the structs below change.
+
+#define ASSET_PACK_MAGIC 0x4b504753u /* "SGPK" */
+#define ASSET_PACK_VERSION 3u
+#define ASSET_PACK_ALIGN 64
+#define ASSET_PACK_DEFAULT_PATH "Assets/assets.pack"
+
+typedef struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    // Asteroids_ShapeKey() of the cooker; shapes and fracture tables are only
+    // used when the runtime's key matches (same buckets, threshold, pyramid,
+    // fracture parameters).
+    uint32_t shape_key;
+    uint64_t file_size;
+    uint64_t entries_offset;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+} AssetPackHeader;
+
+typedef struct AssetPackMask
+{
+    int32_t width;
+    int32_t height;
+    int32_t words_per_row;
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+    int32_t block;
+    uint64_t bits_offset;
+} AssetPackMask;
+
+// CollisionShape::sdf and its placement; int16 samples.
+typedef struct AssetPackSdf
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint64_t offset;
+} AssetPackSdf;
+
+typedef struct AssetPackShape
+{
+    AssetPackMask fine;
+    // any, any_dilated, all per pyramid level.
+    AssetPackMask levels[COLLISION_SHAPE_LEVELS][3];
+    float circle_x;
+    float circle_y;
+    float circle_radius;
+    int32_t area;
+    AssetPackSdf sdf;
+    float outline_x[COLLISION_SHAPE_OUTLINE];
+    float outline_y[COLLISION_SHAPE_OUTLINE];
+    int32_t outline_count;
+    uint32_t reserved;
+} AssetPackShape;
+
+// A FracturePiece with its cut-out pixels (width * height RGBA8) and
+// shape_count shapes.
+typedef struct AssetPackFragment
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    int32_t area;
+    float centroid_x;
+    float centroid_y;
+    uint32_t shape_count;
+    uint64_t pixels_offset;
+    uint64_t shapes_offset;
+} AssetPackFragment;
+
+// FractureTable without the labels.
+typedef struct AssetPackFracture
+{
+    int32_t area;
+    float centroid_x;
+    float centroid_y;
+    int32_t piece_count;
+    AssetPackFragment pieces[FRACTURE_MAX_PIECES];
+} AssetPackFracture;
+
+typedef struct AssetPackEntry
+{
+    uint32_t name_offset;
+    uint32_t name_length;
+    int32_t width;
+    int32_t height;
+    // width * height RGBA8 pixels.
+    uint64_t pixels_offset;
+    // SpriteSheet frame table: frame size and grid.
+    int32_t frame_width;
+    int32_t frame_height;
+    int32_t frame_columns;
+    int32_t frame_rows;
+    uint32_t shape_count;
+    uint32_t reserved;
+    uint64_t shapes_offset;
+    // AssetPackFracture, or 0 if the asset has none.
+    uint64_t fracture_offset;
+} AssetPackEntry;
+
+typedef struct AssetPack
+{
+    const unsigned char *base;
+    size_t size;
+    const AssetPackHeader *header;
+    const AssetPackEntry *entries;
+    const char *strings;
+} AssetPack;
+
+// Maps and validates a pack. Returns 0 (pack left empty) if the file is
+// missing, truncated or from another version.
+int AssetPack_Open(AssetPack *pack, const char *path);
+void AssetPack_Close(AssetPack *pack);
+const AssetPackEntry *AssetPack_Find(const AssetPack *pack, const char *name);
+const char *AssetPack_EntryName(const AssetPack *pack, const AssetPackEntry *entry);
+// RGBA8 image whose data points into the mapping: never UnloadImage it.
+// data is NULL if the entry's pixels are out of range.
+Image AssetPack_ImageView(const AssetPack *pack, const AssetPackEntry *entry);
+// Fills shapes[0 .. count) with views into the mapping. The bits are not
+// owned: never CollisionShape_Free these. Returns 0 if the entry does not
+// hold exactly count valid shapes.
+int AssetPack_ShapeViews(const AssetPack *pack, const AssetPackEntry *entry, CollisionShape *shapes, int count);
+// The entry's fracture table, or NULL if it has none or it is out of range.
+const AssetPackFracture *AssetPack_Fracture(const AssetPack *pack, const AssetPackEntry *entry);
+// Same as the two above, for one piece of a fracture table.
+Image AssetPack_FragmentImageView(const AssetPack *pack, const AssetPackFragment *fragment);
+int AssetPack_FragmentShapeViews(const AssetPack *pack, const AssetPackFragment *fragment, CollisionShape *shapes,
+                                 int count);
+
+// Process-wide pack consulted by the asset loaders. Views (and asteroid
+// masks loaded from it) point into the mapping, so unmount only after
+// everything loaded while it was mounted has been unloaded.
+int AssetPack_Mount(const char *path);
+void AssetPack_Unmount(void);
+// NULL when no pack is mounted.
+const AssetPack *AssetPack_Mounted(void);
+// Entry for path in the mounted pack, or NULL.
+const AssetPackEntry *AssetPack_Lookup(const char *path);
+// LoadTexture that uploads from the mounted pack when it holds path (no PNG
+// decode) and falls back to the file otherwise.
+Texture2D AssetPack_LoadTexture(const char *path);
+
+#endif
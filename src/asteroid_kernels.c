@@ -0,0 +1,193 @@
+#include "asteroid_kernels.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Expands a 4-bit movemask into four 0/1 bytes (little-endian).
+static const uint32_t flag_bytes[16] = {
+    0x00000000u, 0x00000001u, 0x00000100u, 0x00000101u,
+    0x00010000u, 0x00010001u, 0x00010100u, 0x00010101u,
+    0x01000000u, 0x01000001u, 0x01000100u, 0x01000101u,
+    0x01010000u, 0x01010001u, 0x01010100u, 0x01010101u
+};
+
+void AsteroidKernels_Integrate(float *pos_x, float *pos_y, const float *vel_x, const float *vel_y,
+                               int count, float dt)
+{
+    int i = 0;
+#if defined(__AVX__)
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 px = _mm256_loadu_ps(pos_x + i);
+        __m256 py = _mm256_loadu_ps(pos_y + i);
+        px = _mm256_add_ps(px, _mm256_mul_ps(_mm256_loadu_ps(vel_x + i), dt8));
+        py = _mm256_add_ps(py, _mm256_mul_ps(_mm256_loadu_ps(vel_y + i), dt8));
+        _mm256_storeu_ps(pos_x + i, px);
+        _mm256_storeu_ps(pos_y + i, py);
+    }
+#elif defined(__SSE2__)
+    const __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(pos_x + i);
+        __m128 py = _mm_loadu_ps(pos_y + i);
+        px = _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(vel_x + i), dt4));
+        py = _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(vel_y + i), dt4));
+        _mm_storeu_ps(pos_x + i, px);
+        _mm_storeu_ps(pos_y + i, py);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float step_x = vel_x[i] * dt;
+        float step_y = vel_y[i] * dt;
+        pos_x[i] = pos_x[i] + step_x;
+        pos_y[i] = pos_y[i] + step_y;
+    }
+}
+
+int AsteroidKernels_DespawnFlags(const float *pos_x, const float *pos_y, int count,
+                                 float center_x, float center_y, float radius_sq,
+                                 unsigned char *out_flags)
+{
+    int flagged = 0;
+    int i = 0;
+#if defined(__AVX__)
+    const __m256 cx8 = _mm256_set1_ps(center_x);
+    const __m256 cy8 = _mm256_set1_ps(center_y);
+    const __m256 r8 = _mm256_set1_ps(radius_sq);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(pos_x + i), cx8);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(pos_y + i), cy8);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(d2, r8, _CMP_GT_OQ));
+        memcpy(out_flags + i, &flag_bytes[bits & 15], 4);
+        memcpy(out_flags + i + 4, &flag_bytes[bits >> 4], 4);
+        flagged += __builtin_popcount((unsigned int)bits);
+    }
+#elif defined(__SSE2__)
+    const __m128 cx4 = _mm_set1_ps(center_x);
+    const __m128 cy4 = _mm_set1_ps(center_y);
+    const __m128 r4 = _mm_set1_ps(radius_sq);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(pos_x + i), cx4);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(pos_y + i), cy4);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int bits = _mm_movemask_ps(_mm_cmpgt_ps(d2, r4));
+        memcpy(out_flags + i, &flag_bytes[bits], 4);
+        flagged += __builtin_popcount((unsigned int)bits);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float dx = pos_x[i] - center_x;
+        float dy = pos_y[i] - center_y;
+        float d2 = dx * dx + dy * dy;
+        out_flags[i] = (unsigned char)(d2 > radius_sq);
+        flagged += out_flags[i];
+    }
+    return flagged;
+}
+
+int AsteroidKernels_FindClosest(const float *pos_x, const float *pos_y, int count,
+                                float x, float y, float max_dist_sq, float *out_dist_sq)
+{
+    float best_dist_sq = max_dist_sq;
+    int best_index = -1;
+    int i = 0;
+
+    // Each lane keeps its own best (later index wins ties inside a lane), then
+    // lanes are reduced with the same rule: smallest distance, highest index.
+#if defined(__AVX__)
+    if (count >= 8)
+    {
+        const __m256 x8 = _mm256_set1_ps(x);
+        const __m256 y8 = _mm256_set1_ps(y);
+        __m256 best_d = _mm256_set1_ps(max_dist_sq);
+        __m256 best_i = _mm256_set1_ps(-1.0f);
+        __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        const __m256 step = _mm256_set1_ps(8.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(pos_x + i), x8);
+            __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(pos_y + i), y8);
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 better = _mm256_cmp_ps(d2, best_d, _CMP_LE_OQ);
+            best_d = _mm256_blendv_ps(best_d, d2, better);
+            best_i = _mm256_blendv_ps(best_i, index, better);
+            index = _mm256_add_ps(index, step);
+        }
+        float lane_d[8];
+        float lane_i[8];
+        _mm256_storeu_ps(lane_d, best_d);
+        _mm256_storeu_ps(lane_i, best_i);
+        for (int k = 0; k < 8; k++)
+        {
+            int lane_index = (int)lane_i[k];
+            if (lane_index < 0) continue;
+            if (lane_d[k] < best_dist_sq || (lane_d[k] == best_dist_sq && lane_index > best_index))
+            {
+                best_dist_sq = lane_d[k];
+                best_index = lane_index;
+            }
+        }
+    }
+#elif defined(__SSE2__)
+    if (count >= 4)
+    {
+        const __m128 x4 = _mm_set1_ps(x);
+        const __m128 y4 = _mm_set1_ps(y);
+        __m128 best_d = _mm_set1_ps(max_dist_sq);
+        __m128i best_i = _mm_set1_epi32(-1);
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(4);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 dx = _mm_sub_ps(_mm_loadu_ps(pos_x + i), x4);
+            __m128 dy = _mm_sub_ps(_mm_loadu_ps(pos_y + i), y4);
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 better = _mm_cmple_ps(d2, best_d);
+            __m128i better_i = _mm_castps_si128(better);
+            best_d = _mm_or_ps(_mm_and_ps(better, d2), _mm_andnot_ps(better, best_d));
+            best_i = _mm_or_si128(_mm_and_si128(better_i, index), _mm_andnot_si128(better_i, best_i));
+            index = _mm_add_epi32(index, step);
+        }
+        float lane_d[4];
+        int lane_i[4];
+        _mm_storeu_ps(lane_d, best_d);
+        _mm_storeu_si128((__m128i *)lane_i, best_i);
+        for (int k = 0; k < 4; k++)
+        {
+            if (lane_i[k] < 0) continue;
+            if (lane_d[k] < best_dist_sq || (lane_d[k] == best_dist_sq && lane_i[k] > best_index))
+            {
+                best_dist_sq = lane_d[k];
+                best_index = lane_i[k];
+            }
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float dx = pos_x[i] - x;
+        float dy = pos_y[i] - y;
+        float d2 = dx * dx + dy * dy;
+        if (d2 <= best_dist_sq)
+        {
+            best_dist_sq = d2;
+            best_index = i;
+        }
+    }
+
+    if (out_dist_sq != NULL) *out_dist_sq = best_dist_sq;
+    return best_index;
+}
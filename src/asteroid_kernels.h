@@ -0,0 +1,24 @@
+#ifndef ASTEROID_KERNELS_H
+#define ASTEROID_KERNELS_H
+
+// Hot loops over the asteroid SoA columns. Each kernel has an SSE2 path
+// (baseline on x86-64), an AVX path when built with -mavx2, and a scalar tail
+// doing the exact same float operations, so results do not depend on which
+// path ran.
+
+// pos += vel * dt
+void AsteroidKernels_Integrate(float *pos_x, float *pos_y, const float *vel_x, const float *vel_y,
+                               int count, float dt);
+
+// out_flags[i] = 1 when (pos - center)^2 > radius_sq, else 0. Returns the
+// number of flagged entries.
+int AsteroidKernels_DespawnFlags(const float *pos_x, const float *pos_y, int count,
+                                 float center_x, float center_y, float radius_sq,
+                                 unsigned char *out_flags);
+
+// Index of the closest point with dist^2 <= max_dist_sq, or -1. Ties go to the
+// highest index (same as a forward scan with <=).
+int AsteroidKernels_FindClosest(const float *pos_x, const float *pos_y, int count,
+                                float x, float y, float max_dist_sq, float *out_dist_sq);
+
+#endif
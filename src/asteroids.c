@@ -6,12 +6,71 @@
 #include <stdlib.h>
 #include <string.h>
 
-static float RandomFloat(float min, float max)
+#include "memory.h"
+#include "asset_pack.h"
+#include "asteroid_kernels.h"
+#include "fracture.h"
+#include "rng.h"
+#include "profiler.h"
+
+#define ASTEROID_NAME_MAX 256
+
+// Uniform draws consumed per spawned asteroid, in this order. Every spawn
+// takes exactly ASTEROID_SPAWN_DRAWS values from the spawn stream, so asteroid
+// j of a batch reads values [j * DRAWS, (j + 1) * DRAWS) wherever it is built.
+enum
+{
+    SPAWN_PLACE_ANGLE,
+    SPAWN_PLACE_DIST,
+    SPAWN_DRIFT_ANGLE,
+    SPAWN_TEXTURE,
+    SPAWN_SPEED,
+    SPAWN_BUCKET,
+    SPAWN_HP,
+    ASTEROID_SPAWN_DRAWS
+};
+
+// Random stream ids under the world seed.
+#define ASTEROID_STREAM_SPAWN 1u
+#define ASTEROID_STREAM_FX 2u
+// Sector streams are keyed by cell under the seed mixed with this.
+#define ASTEROID_SECTOR_SALT 0x5345435400000000ull /* "SECT" */
+
+// Uniform draws per sector sub-cell, in this order; sub-cell i reads values
+// [i * DRAWS, (i + 1) * DRAWS) of its sector's stream.
+enum
+{
+    SECTOR_DRAW_FILL,
+    SECTOR_DRAW_X,
+    SECTOR_DRAW_Y,
+    SECTOR_DRAW_DRIFT_ANGLE,
+    SECTOR_DRAW_TEXTURE,
+    SECTOR_DRAW_SPEED,
+    SECTOR_DRAW_BUCKET,
+    SECTOR_DRAW_HP,
+    SECTOR_DRAWS
+};
+
+// Chance that a sub-cell holds a rock (about 5.6 per sector).
+#define ASTEROID_SECTOR_FILL 0.35f
+// Sectors within view_radius + LOAD_MARGIN of the player are requested; they
+// leave beyond view_radius + EVICT_MARGIN, so hovering on a border does not
+// churn.
+#define ASTEROID_SECTOR_LOAD_MARGIN (0.5f * SECTOR_SIZE)
+#define ASTEROID_SECTOR_EVICT_MARGIN (1.0f * SECTOR_SIZE)
+
+static float Lerp(float min, float max, float t)
 {
-    float t = (float)GetRandomValue(0, 10000) / 10000.0f;
     return min + (max - min) * t;
 }
 
+// Maps a [0, 1) draw to an index in [0, count).
+static int DrawIndex(float t, int count)
+{
+    int index = (int)(t * (float)count);
+    return (index < count) ? index : count - 1;
+}
+
 static int HasPngExtension(const char *name)
 {
     size_t len = strlen(name);
@@ -19,105 +78,691 @@ static int HasPngExtension(const char *name)
     return (name[len - 4] == '.' && name[len - 3] == 'p' && name[len - 2] == 'n' && name[len - 1] == 'g');
 }
 
-static void LoadAsteroidTextures(AsteroidSystem *system, const char *directory)
+static void FreeAssetMasks(AsteroidAsset *asset)
+{
+    // Mapped shapes are views into the asset pack.
+    if (asset->mapped) return;
+    for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++)
+    {
+        CollisionShape_Free(&asset->shapes[b]);
+    }
+}
+
+int Asteroids_BakeShapes(CollisionShape shapes[ASTEROID_SCALE_BUCKETS], const Image *image)
 {
+    const unsigned char *alpha = (const unsigned char *)image->data + 3;
+    for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++)
+    {
+        if (!CollisionShape_Build(&shapes[b], alpha, image->width, image->height,
+                                  4, image->width * 4, ASTEROID_MASK_THRESHOLD, Asteroids_BucketScale(b)))
+        {
+            for (int i = 0; i < b; i++) CollisionShape_Free(&shapes[i]);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+uint32_t Asteroids_ShapeKey(void)
+{
+    const float params[] = {
+        (float)ASTEROID_SCALE_BUCKETS, ASTEROID_SCALE_MIN, ASTEROID_SCALE_STEP, (float)ASTEROID_MASK_THRESHOLD,
+        (float)COLLISION_SHAPE_LEVELS, (float)COLLISION_SHAPE_BLOCK_COARSE, (float)COLLISION_SHAPE_BLOCK_FINE,
+        (float)COLLISION_SDF_UNIT, (float)COLLISION_SDF_MARGIN, (float)COLLISION_SHAPE_OUTLINE,
+        (float)FRACTURE_SEEDS, (float)FRACTURE_MIN_AREA, (float)FRACTURE_MAX_PIECES, (float)FRACTURE_SEED
+    };
+    uint32_t hash = 2166136261u;
+    const unsigned char *bytes = (const unsigned char *)params;
+    for (size_t i = 0; i < sizeof(params); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int CompareNames(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+// Zeroed slot for the next asset; only counted once AddAsset is called.
+static AsteroidAsset *NewAsset(AsteroidSystem *system)
+{
+    if (!Memory_GrowArray((void **)&system->assets, &system->asset_capacity, system->asset_count + 1, sizeof(AsteroidAsset), 16))
+    {
+        return NULL;
+    }
+    AsteroidAsset *asset = &system->assets[system->asset_count];
+    *asset = (AsteroidAsset){0};
+    return asset;
+}
+
+static void AddAsset(AsteroidSystem *system)
+{
+    const AsteroidAsset *asset = &system->assets[system->asset_count++];
+    for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++)
+    {
+        system->mask_bytes += CollisionShape_Bytes(&asset->shapes[b]);
+        const CollisionShape *shape = &asset->shapes[b];
+        if (shape->circle_radius > system->max_radius) system->max_radius = shape->circle_radius;
+
+        // Farthest a solid pixel can sit from the asteroid's position
+        // (the mask centre), padded by a pixel.
+        float off_x = shape->circle_x - 0.5f * (float)shape->fine.width;
+        float off_y = shape->circle_y - 0.5f * (float)shape->fine.height;
+        float reach = sqrtf(off_x * off_x + off_y * off_y) + shape->circle_radius + 1.0f;
+        if (reach > system->max_reach) system->max_reach = reach;
+    }
+}
+
+// Pack entry names that stand for a PNG directly inside directory.
+static int IsDirectoryPng(const char *name, const char *directory, size_t dir_len)
+{
+    if (strncmp(name, directory, dir_len) != 0 || name[dir_len] != '/') return 0;
+    return strchr(name + dir_len + 1, '/') == NULL && HasPngExtension(name);
+}
+
+// Sorted names of the PNGs in directory. readdir order is
+// filesystem-dependent; sorting keeps asset indices (and any seeded run that
+// picks them) identical on every machine.
+static int ScanPngNames(const char *directory, char (**out_names)[ASTEROID_NAME_MAX])
+{
+    *out_names = NULL;
     DIR *dir = opendir(directory);
-    if (dir == NULL) return;
+    if (dir == NULL) return 0;
 
+    char (*names)[ASTEROID_NAME_MAX] = NULL;
+    int name_count = 0;
+    int name_capacity = 0;
     struct dirent *entry = NULL;
     while ((entry = readdir(dir)) != NULL)
     {
-        if (system->asset_count >= ASTEROID_TEXTURE_MAX) break;
         if (entry->d_name[0] == '.') continue;
         if (!HasPngExtension(entry->d_name)) continue;
+        if (!Memory_GrowArray((void **)&names, &name_capacity, name_count + 1, sizeof(names[0]), 32)) break;
+        snprintf(names[name_count], sizeof(names[name_count]), "%s", entry->d_name);
+        name_count++;
+    }
+    closedir(dir);
+    if (name_count > 0) qsort(names, (size_t)name_count, sizeof(names[0]), CompareNames);
+    *out_names = names;
+    return name_count;
+}
+
+// Collision shapes for an asset: views into the mounted pack when entry is
+// set and was cooked with the same parameters, else baked from the pixels
+// (which for a pack entry still skips the PNG decode).
+static int LoadAssetShapes(AsteroidAsset *asset, const AssetPackEntry *entry, const Image *image)
+{
+    const AssetPack *pack = AssetPack_Mounted();
+    if (entry != NULL && pack != NULL && pack->header->shape_key == Asteroids_ShapeKey() &&
+        AssetPack_ShapeViews(pack, entry, asset->shapes, ASTEROID_SCALE_BUCKETS))
+    {
+        asset->mapped = 1;
+        return 1;
+    }
+    return Asteroids_BakeShapes(asset->shapes, image);
+}
 
+static void ReleaseAssetImage(AsteroidAsset *asset)
+{
+    if (asset->image.data != NULL && !asset->image_is_view) UnloadImage(asset->image);
+    asset->image = (Image){0};
+    asset->image_is_view = 0;
+}
+
+static void ReleaseStagedFragments(AsteroidAsset *rock)
+{
+    for (int f = 0; rock->staged_fragments != NULL && f < rock->fragment_count; f++)
+    {
+        ReleaseAssetImage(&rock->staged_fragments[f]);
+        FreeAssetMasks(&rock->staged_fragments[f]);
+    }
+    free(rock->staged_fragments);
+    rock->staged_fragments = NULL;
+    rock->fragment_count = 0;
+}
+
+// Stages a rock's fragment assets (image and shapes each): views of the
+// pack's cooked fracture table when entry has one with the same parameters,
+// else cut from the rock's pixels. A rock that cannot be cut just has none.
+static void StageFragments(AsteroidAsset *rock, const AssetPackEntry *entry, const Image *image)
+{
+    const AssetPack *pack = AssetPack_Mounted();
+    const AssetPackFracture *cooked = NULL;
+    if (entry != NULL && pack != NULL && pack->header->shape_key == Asteroids_ShapeKey())
+    {
+        cooked = AssetPack_Fracture(pack, entry);
+    }
+    FractureTable table;
+    if (cooked == NULL && !Fracture_Build(&table, image, ASTEROID_MASK_THRESHOLD)) return;
+
+    int piece_count = (cooked != NULL) ? cooked->piece_count : table.piece_count;
+    int area = (cooked != NULL) ? cooked->area : table.area;
+    Vector2 centroid = (cooked != NULL) ? (Vector2){ cooked->centroid_x, cooked->centroid_y }
+                                        : (Vector2){ table.centroid_x, table.centroid_y };
+    AsteroidAsset *fragments = (piece_count > 0) ? calloc((size_t)piece_count, sizeof(AsteroidAsset)) : NULL;
+    int staged = 0;
+    for (int p = 0; p < piece_count && fragments != NULL; p++)
+    {
+        AsteroidAsset *fragment = &fragments[staged];
+        FracturePiece piece;
+        if (cooked != NULL)
+        {
+            const AssetPackFragment *src = &cooked->pieces[p];
+            piece = (FracturePiece){ src->x, src->y, src->width, src->height, src->area,
+                                     src->centroid_x, src->centroid_y };
+            fragment->image = AssetPack_FragmentImageView(pack, src);
+            fragment->image_is_view = 1;
+            if (fragment->image.data == NULL) continue;
+            fragment->mapped = AssetPack_FragmentShapeViews(pack, src, fragment->shapes, ASTEROID_SCALE_BUCKETS);
+        }
+        else
+        {
+            piece = table.pieces[p];
+            fragment->image = Fracture_PieceImage(&table, image, p);
+            if (fragment->image.data == NULL) continue;
+        }
+        if (!fragment->mapped && !Asteroids_BakeShapes(fragment->shapes, &fragment->image))
+        {
+            ReleaseAssetImage(fragment);
+            continue;
+        }
+
+        fragment->width = piece.width;
+        fragment->height = piece.height;
+        fragment->offset = (Vector2){ (float)piece.x + 0.5f * (float)piece.width - 0.5f * (float)image->width,
+                                      (float)piece.y + 0.5f * (float)piece.height - 0.5f * (float)image->height };
+        float dx = piece.centroid_x - centroid.x;
+        float dy = piece.centroid_y - centroid.y;
+        float length = sqrtf(dx * dx + dy * dy);
+        fragment->drift = (length > 0.0f) ? (Vector2){ dx / length, dy / length } : (Vector2){ 0.0f, 0.0f };
+        fragment->area_share = (float)piece.area / (float)area;
+        staged++;
+    }
+    if (cooked == NULL) Fracture_Free(&table);
+    rock->staged_fragments = fragments;
+    rock->fragment_count = staged;
+}
+
+// Once every rock is in: appends each one's staged fragments after all of
+// them, so rock indices do not depend on how rocks break.
+static void AppendFragments(AsteroidSystem *system)
+{
+    system->rock_count = system->asset_count;
+    for (int r = 0; r < system->rock_count; r++)
+    {
+        AsteroidAsset staged = system->assets[r];
+        system->assets[r].staged_fragments = NULL;
+        system->assets[r].parent = -1;
+        system->assets[r].first_fragment = system->asset_count;
+        system->assets[r].fragment_count = 0;
+        for (int f = 0; f < staged.fragment_count; f++)
+        {
+            // May move the assets; index, do not hold pointers.
+            AsteroidAsset *asset = NewAsset(system);
+            if (asset == NULL)
+            {
+                ReleaseAssetImage(&staged.staged_fragments[f]);
+                FreeAssetMasks(&staged.staged_fragments[f]);
+                continue;
+            }
+            *asset = staged.staged_fragments[f];
+            asset->parent = r;
+            AddAsset(system);
+            system->assets[r].fragment_count++;
+        }
+        free(staged.staged_fragments);
+    }
+}
+
+// Gives every asset a texture and source region: one shared atlas when they
+// all fit, else a texture each. The CPU images are released either way.
+static void UploadAssetTextures(AsteroidSystem *system, int load_textures)
+{
+    int count = system->asset_count;
+    Image *images = load_textures ? malloc((size_t)count * sizeof(Image)) : NULL;
+    Rectangle *regions = load_textures ? malloc((size_t)count * sizeof(Rectangle)) : NULL;
+    int atlas = 0;
+    if (images != NULL && regions != NULL && count > 0)
+    {
+        for (int i = 0; i < count; i++) images[i] = system->assets[i].image;
+        atlas = SpriteAtlas_Build(&system->atlas, images, count, regions);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        AsteroidAsset *asset = &system->assets[i];
+        if (atlas)
+        {
+            asset->region = regions[i];
+        }
+        else
+        {
+            // Not drawn if the upload fails; it still spawns, so the set of
+            // assets never depends on the GPU.
+            if (load_textures) asset->texture = LoadTextureFromImage(asset->image);
+            asset->region = (Rectangle){ 0.0f, 0.0f, (float)asset->width, (float)asset->height };
+        }
+        ReleaseAssetImage(asset);
+    }
+    free(images);
+    free(regions);
+}
+
+// Every PNG directly inside `directory` from the mounted pack. Pack entries
+// are sorted by full path, so this is the same order as the sorted directory
+// scan below. Returns 0 if the pack has none (the caller then scans PNGs).
+static int LoadAsteroidsFromPack(AsteroidSystem *system, const char *directory)
+{
+    const AssetPack *pack = AssetPack_Mounted();
+    if (pack == NULL) return 0;
+
+    size_t dir_len = strlen(directory);
+    int loaded = 0;
+    for (uint32_t i = 0; i < pack->header->entry_count; i++)
+    {
+        const AssetPackEntry *entry = &pack->entries[i];
+        if (!IsDirectoryPng(AssetPack_EntryName(pack, entry), directory, dir_len)) continue;
+
+        Image view = AssetPack_ImageView(pack, entry);
+        if (view.data == NULL) continue;
+        AsteroidAsset *asset = NewAsset(system);
+        if (asset == NULL) break;
+        if (!LoadAssetShapes(asset, entry, &view)) continue;
+        StageFragments(asset, entry, &view);
+
+        asset->image = view;
+        asset->image_is_view = 1;
+        asset->width = view.width;
+        asset->height = view.height;
+        AddAsset(system);
+        loaded++;
+    }
+    return loaded > 0;
+}
+
+static void LoadAsteroidTextures(AsteroidSystem *system, const char *directory, int load_textures)
+{
+    if (LoadAsteroidsFromPack(system, directory))
+    {
+        AppendFragments(system);
+        UploadAssetTextures(system, load_textures);
+        return;
+    }
+
+    char (*names)[ASTEROID_NAME_MAX] = NULL;
+    int name_count = ScanPngNames(directory, &names);
+    for (int n = 0; n < name_count; n++)
+    {
         char path[512];
-        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        snprintf(path, sizeof(path), "%s/%s", directory, names[n]);
 
         Image image = LoadImage(path);
         if (image.data == NULL) continue;
         ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
 
-        int pixel_count = image.width * image.height;
-        unsigned char *mask = (unsigned char *)malloc((size_t)pixel_count);
-        if (mask == NULL)
+        AsteroidAsset *asset = NewAsset(system);
+        if (asset == NULL)
+        {
+            UnloadImage(image);
+            break;
+        }
+        if (!Asteroids_BakeShapes(asset->shapes, &image))
         {
             UnloadImage(image);
             continue;
         }
+        StageFragments(asset, NULL, &image);
 
-        Color *pixels = (Color *)image.data;
-        for (int i = 0; i < pixel_count; i++)
+        // Kept for the upload rather than decoding the PNG again.
+        asset->image = image;
+        asset->width = image.width;
+        asset->height = image.height;
+        AddAsset(system);
+    }
+    AppendFragments(system);
+    UploadAssetTextures(system, load_textures);
+
+    free(names);
+}
+
+// Async loading. Each request owns one slot of loading_assets: the decode job
+// fills its shapes, image and fragments on a worker. Nothing reaches `assets` until the
+// last request resolves, and then in request (name) order, so the set and its
+// indices match Asteroids_Init; the textures (normally one atlas) are
+// uploaded then.
+
+static int BakeLoadingAsset(void *user, int slot, const AssetRequest *request)
+{
+    AsteroidAsset *asset = &((AsteroidSystem *)user)->loading_assets[slot];
+    const AssetPackEntry *entry = request->from_pack ? AssetPack_Lookup(request->path) : NULL;
+    if (!LoadAssetShapes(asset, entry, &request->image)) return 0;
+
+    // The loader releases its image after the request resolves; pack views
+    // stay valid while the pack is mounted.
+    asset->image_is_view = request->from_pack;
+    asset->image = request->from_pack ? request->image : ImageCopy(request->image);
+    if (asset->image.data == NULL)
+    {
+        FreeAssetMasks(asset);
+        return 0;
+    }
+    StageFragments(asset, entry, &asset->image);
+    asset->width = request->image.width;
+    asset->height = request->image.height;
+    return 1;
+}
+
+static void PublishLoadingAssets(AsteroidSystem *system)
+{
+    for (int slot = 0; slot < system->loading_total; slot++)
+    {
+        AsteroidAsset *loaded = &system->loading_assets[slot];
+        if (loaded->width <= 0) continue;
+        AsteroidAsset *asset = NewAsset(system);
+        if (asset == NULL)
         {
-            mask[i] = (pixels[i].a >= 20) ? 1 : 0;
+            ReleaseAssetImage(loaded);
+            FreeAssetMasks(loaded);
+            ReleaseStagedFragments(loaded);
+            continue;
         }
+        *asset = *loaded;
+        AddAsset(system);
+    }
+    AppendFragments(system);
+    free(system->loading_assets);
+    system->loading_assets = NULL;
+    system->loading_total = 0;
+    system->loading_resolved = 0;
+    UploadAssetTextures(system, 1);
+}
+
+static void OnLoadingAssetReady(void *user, int slot, const AssetRequest *request)
+{
+    (void)slot;
+    (void)request;
+    AsteroidSystem *system = (AsteroidSystem *)user;
+    if (++system->loading_resolved == system->loading_total) PublishLoadingAssets(system);
+}
+
+static void RequestAsteroidAssets(AsteroidSystem *system, const char *directory, AssetLoader *loader)
+{
+    char (*paths)[ASSET_LOADER_PATH_MAX] = NULL;
+    int path_count = 0;
+    int path_capacity = 0;
 
-        Texture2D tex = LoadTexture(path);
-        if (tex.id == 0)
+    // Same sources, same order as LoadAsteroidTextures.
+    const AssetPack *pack = AssetPack_Mounted();
+    size_t dir_len = strlen(directory);
+    for (uint32_t i = 0; pack != NULL && i < pack->header->entry_count; i++)
+    {
+        const char *name = AssetPack_EntryName(pack, &pack->entries[i]);
+        if (!IsDirectoryPng(name, directory, dir_len)) continue;
+        if (!Memory_GrowArray((void **)&paths, &path_capacity, path_count + 1, sizeof(paths[0]), 32)) break;
+        snprintf(paths[path_count++], sizeof(paths[0]), "%s", name);
+    }
+    if (path_count == 0)
+    {
+        char (*names)[ASTEROID_NAME_MAX] = NULL;
+        int name_count = ScanPngNames(directory, &names);
+        for (int n = 0; n < name_count; n++)
         {
-            free(mask);
-            UnloadImage(image);
-            continue;
+            if (!Memory_GrowArray((void **)&paths, &path_capacity, path_count + 1, sizeof(paths[0]), 32)) break;
+            snprintf(paths[path_count++], sizeof(paths[0]), "%s/%s", directory, names[n]);
         }
+        free(names);
+    }
 
-        AsteroidAsset *asset = &system->assets[system->asset_count];
-        asset->texture = tex;
-        asset->mask = mask;
-        asset->width = image.width;
-        asset->height = image.height;
-        system->asset_count++;
+    system->loading_assets = (path_count > 0) ? calloc((size_t)path_count, sizeof(AsteroidAsset)) : NULL;
+    for (int p = 0; p < path_count && system->loading_assets != NULL; p++)
+    {
+        int slot = system->loading_total;
+        int index = AssetLoader_Request(loader, paths[p], BakeLoadingAsset, OnLoadingAssetReady, system, slot);
+        if (index < 0) break;
+        // Uploaded together once all are in (see UploadAssetTextures).
+        loader->requests[index].cpu_only = 1;
+        system->loading_total++;
+    }
+    free(paths);
+}
+
+// Grows the pool and every per-asteroid array together; amortised, so steady
+// state spawning never allocates.
+static int ReserveAsteroids(AsteroidSystem *system, int needed)
+{
+    if (!EntityPool_Reserve(&system->pool, needed)) return 0;
+    int capacity = system->pool.dense_capacity;
+    if (capacity <= system->asteroid_capacity) return 1;
+
+    AsteroidColumns *c = &system->columns;
+    void **float_columns[] = {
+        (void **)&c->pos_x, (void **)&c->pos_y, (void **)&c->vel_x, (void **)&c->vel_y,
+        (void **)&c->hp, (void **)&c->hp_max, (void **)&c->scale,
+        (void **)&system->solve_vel_x, (void **)&system->solve_vel_y, (void **)&system->solve_time
+    };
+    void **int_columns[] = { (void **)&c->scale_bucket, (void **)&c->asset_index, (void **)&c->origin };
 
-        UnloadImage(image);
+    for (size_t i = 0; i < sizeof(float_columns) / sizeof(float_columns[0]); i++)
+    {
+        int column_capacity = system->asteroid_capacity;
+        if (!Memory_GrowArray(float_columns[i], &column_capacity, capacity, sizeof(float), capacity)) return 0;
+    }
+    for (size_t i = 0; i < sizeof(int_columns) / sizeof(int_columns[0]); i++)
+    {
+        int column_capacity = system->asteroid_capacity;
+        if (!Memory_GrowArray(int_columns[i], &column_capacity, capacity, sizeof(int), capacity)) return 0;
     }
+    int destroyed_capacity = system->asteroid_capacity;
+    if (!Memory_GrowArray((void **)&system->destroyed, &destroyed_capacity, capacity, sizeof(unsigned char), capacity)) return 0;
+    system->asteroid_capacity = capacity;
+    return 1;
+}
 
-    closedir(dir);
+static void FreeColumns(AsteroidColumns *c)
+{
+    free(c->pos_x);
+    free(c->pos_y);
+    free(c->vel_x);
+    free(c->vel_y);
+    free(c->hp);
+    free(c->hp_max);
+    free(c->scale);
+    free(c->scale_bucket);
+    free(c->asset_index);
+    free(c->origin);
+    *c = (AsteroidColumns){0};
 }
 
-static void SpawnAsteroid(AsteroidSystem *system, Camera2D camera, Vector2 player_pos)
+// Fills dense slot i from one spawn's draws (see ASTEROID_SPAWN_DRAWS).
+static void WriteSpawn(AsteroidSystem *system, int i, Vector2 spawn_pos, const float *draw)
 {
-    if (system->asset_count <= 0) return;
-    if (system->asteroid_count >= ASTEROID_MAX) return;
+    float drift_angle = draw[SPAWN_DRIFT_ANGLE] * 2.0f * PI;
+    float speed = Lerp(system->speed * 0.5f, system->speed * 1.1f, draw[SPAWN_SPEED]);
 
-    float screen_w = (float)GetScreenWidth();
-    float screen_h = (float)GetScreenHeight();
-    float half_w = screen_w * 0.5f;
-    float half_h = screen_h * 0.5f;
-    float view_radius = (half_w > half_h) ? half_w : half_h;
+    AsteroidColumns *c = &system->columns;
+    c->asset_index[i] = DrawIndex(draw[SPAWN_TEXTURE], system->rock_count);
+    c->pos_x[i] = spawn_pos.x;
+    c->pos_y[i] = spawn_pos.y;
+    c->vel_x[i] = cosf(drift_angle) * speed;
+    c->vel_y[i] = sinf(drift_angle) * speed;
+    c->scale_bucket[i] = DrawIndex(draw[SPAWN_BUCKET], ASTEROID_SCALE_BUCKETS);
+    c->scale[i] = Asteroids_BucketScale(c->scale_bucket[i]);
+    c->hp_max[i] = Lerp(60.0f, 120.0f, draw[SPAWN_HP]);
+    c->hp[i] = c->hp_max[i];
+    c->origin[i] = -1;
+}
+
+typedef struct SpawnFieldJob
+{
+    AsteroidSystem *system;
+    Rng rng;
+    uint64_t first_draw;
+    int first_index;
+    Vector2 center;
+    float radius;
+} SpawnFieldJob;
+
+// Draws and builds asteroids [begin, end) of a field batch. Each one reads
+// its own slice of the spawn stream, so the split does not matter.
+static void SpawnFieldRange(void *user, int begin, int end)
+{
+    const SpawnFieldJob *job = (const SpawnFieldJob *)user;
+    AsteroidSystem *system = job->system;
+    float *draws = system->spawn_draws + (size_t)begin * ASTEROID_SPAWN_DRAWS;
+    Rng_FillFloatsAt(&job->rng, job->first_draw + (uint64_t)begin * ASTEROID_SPAWN_DRAWS, draws,
+                     (end - begin) * ASTEROID_SPAWN_DRAWS, 0.0f, 1.0f);
+
+    for (int j = begin; j < end; j++)
+    {
+        const float *draw = system->spawn_draws + (size_t)j * ASTEROID_SPAWN_DRAWS;
+        float angle = draw[SPAWN_PLACE_ANGLE] * 2.0f * PI;
+        float dist = job->radius * sqrtf(draw[SPAWN_PLACE_DIST]);
+        Vector2 pos = { job->center.x + cosf(angle) * dist, job->center.y + sinf(angle) * dist };
+        WriteSpawn(system, job->first_index + j, pos, draw);
+    }
+}
+
+// Job sizes: asteroids per integration / spawn job, pairs per narrowphase job.
+#define ASTEROID_MOVE_GRAIN 8192
+#define ASTEROID_SPAWN_GRAIN 2048
+#define ASTEROID_PAIR_GRAIN 256
+// Contact response: share of the approach speed kept (reversed), solver
+// passes over each update's contacts, overlap left alone (pixels) and the
+// share of the rest pushed apart per update.
+#define ASTEROID_RESTITUTION 0.8f
+#define ASTEROID_SOLVER_PASSES 4
+#define ASTEROID_CONTACT_SLOP 1.0f
+#define ASTEROID_CONTACT_PUSH 0.5f
+// Speed (pixels per second) a fragment gets on top of its rock's velocity,
+// away from the rock's centroid.
+#define ASTEROID_FRAGMENT_KICK 24.0f
+
+// Roughly one asteroid per cell at typical field densities.
+#define ASTEROID_QUERY_CELL_SIZE 256.0f
 
-    float min_dist = (system->min_spawn_dist > 0.0f) ? system->min_spawn_dist : (view_radius + 320.0f);
-    float max_dist = (system->max_spawn_dist > 0.0f) ? system->max_spawn_dist : (min_dist + 800.0f);
+static void RebuildQueryIndex(AsteroidSystem *system)
+{
+    SpatialHash *index = &system->query_index;
+    const AsteroidColumns *c = &system->columns;
+    SpatialHash_Begin(index, system->pool.count, ASTEROID_QUERY_CELL_SIZE);
+    for (int i = 0; i < system->pool.count; i++)
+    {
+        SpatialHash_Insert(index, i, c->pos_x[i], c->pos_y[i], 0.0f);
+    }
+    SpatialHash_Finish(index);
+}
 
-    float angle = RandomFloat(0.0f, 2.0f * PI);
-    float dist = RandomFloat(min_dist, max_dist);
-    Vector2 spawn_pos = { player_pos.x + cosf(angle) * dist, player_pos.y + sinf(angle) * dist };
+void Asteroids_SpawnField(AsteroidSystem *system, Vector2 center, int count, float radius)
+{
+    if (system->rock_count <= 0 || count <= 0) return;
+    if (!ReserveAsteroids(system, system->pool.count + count)) return;
+    if (!Memory_GrowArray((void **)&system->spawn_draws, &system->spawn_draw_capacity,
+                          count * ASTEROID_SPAWN_DRAWS, sizeof(float), 256))
+    {
+        return;
+    }
 
-    float drift_angle = RandomFloat(0.0f, 2.0f * PI);
-    Vector2 dir = { cosf(drift_angle), sinf(drift_angle) };
+    // Handles are handed out serially; the columns are then drawn and written
+    // in parallel from one block of the spawn stream.
+    SpawnFieldJob job = { system, system->spawn_rng, system->spawn_rng.counter, system->pool.count, center, radius };
+    for (int i = 0; i < count; i++) EntityPool_Create(&system->pool);
+    JobSystem_ParallelFor(system->jobs, count, ASTEROID_SPAWN_GRAIN, SpawnFieldRange, &job);
+    system->spawn_rng.counter += (uint64_t)count * ASTEROID_SPAWN_DRAWS;
+    RebuildQueryIndex(system);
+}
 
-    int tex_index = GetRandomValue(0, system->asset_count - 1);
-    Asteroid *asteroid = &system->asteroids[system->asteroid_count++];
-    asteroid->asset_index = tex_index;
-    asteroid->position = spawn_pos;
-    float speed = RandomFloat(system->speed * 0.5f, system->speed * 1.1f);
-    asteroid->velocity = (Vector2){ dir.x * speed, dir.y * speed };
-    asteroid->scale = RandomFloat(0.6f, 1.1f);
-    asteroid->hp_max = RandomFloat(60.0f, 120.0f);
-    asteroid->hp = asteroid->hp_max;
+float Asteroids_BucketScale(int bucket)
+{
+    return ASTEROID_SCALE_MIN + (float)bucket * ASTEROID_SCALE_STEP;
 }
 
-void Asteroids_Init(AsteroidSystem *system, const char *directory)
+static void InitState(AsteroidSystem *system, uint64_t seed)
 {
     *system = (AsteroidSystem){0};
-    system->spawn_interval = 1.2f;
-    system->speed = 140.0f;
-    LoadAsteroidTextures(system, directory);
+    system->spawn_rng = Rng_Create(seed, ASTEROID_STREAM_SPAWN);
+    system->fx_rng = Rng_Create(seed, ASTEROID_STREAM_FX);
+    // Slow drift: rocks stay around the sector they were generated in.
+    system->speed = 40.0f;
+    system->view_radius = 640.0f;
+    system->sector_seed = seed;
+    system->stream_sectors = 1;
+    system->swept_collisions = 1;
+    system->collision_response = ASTEROID_RESPONSE_BOUNCE;
+    SectorMap_Init(&system->sectors);
+    JobCounter_Init(&system->sector_jobs);
+    EntityPool_Init(&system->pool);
+    SpatialHash_Init(&system->broadphase);
+    SpatialHash_Init(&system->query_index);
+}
+
+void Asteroids_Init(AsteroidSystem *system, const char *directory, int load_textures, uint64_t seed)
+{
+    InitState(system, seed);
+    LoadAsteroidTextures(system, directory, load_textures);
+}
+
+void Asteroids_InitAsync(AsteroidSystem *system, const char *directory, AssetLoader *loader, uint64_t seed)
+{
+    InitState(system, seed);
+    RequestAsteroidAssets(system, directory, loader);
+}
+
+void Asteroids_InitShared(AsteroidSystem *system, const AsteroidSystem *source, uint64_t seed)
+{
+    InitState(system, seed);
+    system->assets = source->assets;
+    system->asset_count = source->asset_count;
+    system->rock_count = source->rock_count;
+    system->max_radius = source->max_radius;
+    system->max_reach = source->max_reach;
+    system->atlas = source->atlas;
+    system->shares_assets = 1;
+}
+
+void Asteroids_Reset(AsteroidSystem *system, uint64_t seed)
+{
+    JobSystem_Wait(system->jobs, &system->sector_jobs);
+    SectorMap_Clear(&system->sectors);
+    EntityPool_Clear(&system->pool);
+    system->popup_count = 0;
+    system->sector_seed = seed;
+    system->spawn_rng = Rng_Create(seed, ASTEROID_STREAM_SPAWN);
+    system->fx_rng = Rng_Create(seed, ASTEROID_STREAM_FX);
+    system->stats = (AsteroidStats){0};
+    system->collision_count = 0;
+    RebuildQueryIndex(system);
 }
 
 static void RemoveAsteroid(AsteroidSystem *system, int index)
 {
-    if (index < 0 || index >= system->asteroid_count) return;
-    system->asteroids[index] = system->asteroids[system->asteroid_count - 1];
-    system->asteroid_count--;
+    int moved = EntityPool_Remove(&system->pool, index);
+    if (moved < 0) return;
+
+    AsteroidColumns *c = &system->columns;
+    c->pos_x[index] = c->pos_x[moved];
+    c->pos_y[index] = c->pos_y[moved];
+    c->vel_x[index] = c->vel_x[moved];
+    c->vel_y[index] = c->vel_y[moved];
+    c->hp[index] = c->hp[moved];
+    c->hp_max[index] = c->hp_max[moved];
+    c->scale[index] = c->scale[moved];
+    c->scale_bucket[index] = c->scale_bucket[moved];
+    c->asset_index[index] = c->asset_index[moved];
+    c->origin[index] = c->origin[moved];
+    system->destroyed[index] = system->destroyed[moved];
+}
+
+// Removes every asteroid flagged in system->destroyed. Walks backwards so each
+// swapped-in survivor has already been visited.
+static void CompactDestroyed(AsteroidSystem *system)
+{
+    for (int i = system->pool.count - 1; i >= 0; i--)
+    {
+        if (system->destroyed[i]) RemoveAsteroid(system, i);
+    }
 }
 
 static void RemovePopup(AsteroidSystem *system, int index)
@@ -127,105 +772,668 @@ static void RemovePopup(AsteroidSystem *system, int index)
     system->popup_count--;
 }
 
-static int MaskSolid(const AsteroidAsset *asset, int x, int y)
+static const CollisionShape *AsteroidShape(const AsteroidSystem *system, int index)
 {
-    if (x < 0 || y < 0 || x >= asset->width || y >= asset->height) return 0;
-    return asset->mask[y * asset->width + x] != 0;
+    return &system->assets[system->columns.asset_index[index]].shapes[system->columns.scale_bucket[index]];
 }
 
-static int AsteroidsOverlap(const AsteroidSystem *system, const Asteroid *a, const Asteroid *b)
+// Centre of the asteroid's tight enclosing circle in world space.
+static Vector2 AsteroidCenter(const AsteroidSystem *system, const CollisionShape *shape, int index)
 {
-    const AsteroidAsset *asset_a = &system->assets[a->asset_index];
-    const AsteroidAsset *asset_b = &system->assets[b->asset_index];
+    return (Vector2){
+        system->columns.pos_x[index] - 0.5f * (float)shape->fine.width + shape->circle_x,
+        system->columns.pos_y[index] - 0.5f * (float)shape->fine.height + shape->circle_y
+    };
+}
 
-    float aw = asset_a->width * a->scale;
-    float ah = asset_a->height * a->scale;
-    float bw = asset_b->width * b->scale;
-    float bh = asset_b->height * b->scale;
+// First time in [0, span] at which the masks of a and b, moving at their
+// velocities, overlap; negative if they do not (span 0: whether they overlap
+// now).
+static float SweptImpactTime(const AsteroidSystem *system, int a, int b, float span, CollisionShapeStats *stats)
+{
+    const CollisionShape *shape_a = AsteroidShape(system, a);
+    const CollisionShape *shape_b = AsteroidShape(system, b);
+    const AsteroidColumns *c = &system->columns;
+    float vx = c->vel_x[a] - c->vel_x[b];
+    float vy = c->vel_y[a] - c->vel_y[b];
+    if (span <= 0.0f) vx = vy = 0.0f;
 
-    float dx = a->position.x - b->position.x;
-    float dy = a->position.y - b->position.y;
-    float ra = 0.5f * ((aw > ah) ? aw : ah);
-    float rb = 0.5f * ((bw > bh) ? bw : bh);
-    float max_r = ra + rb;
-    if (dx * dx + dy * dy > max_r * max_r) return 0;
+    // The enclosing circles bound the contact window: |p + v t| <= radius
+    // on [enter, leave]. The pixel margin covers the rounding below.
+    Vector2 ca = AsteroidCenter(system, shape_a, a);
+    Vector2 cb = AsteroidCenter(system, shape_b, b);
+    float px = ca.x - cb.x;
+    float py = ca.y - cb.y;
+    float radius = shape_a->circle_radius + shape_b->circle_radius + 1.0f;
+    float qa = vx * vx + vy * vy;
+    float qb = px * vx + py * vy;
+    float qc = px * px + py * py - radius * radius;
+    float enter = 0.0f;
+    float leave = 0.0f;
+    if (qa > 0.0f)
+    {
+        float disc = qb * qb - qa * qc;
+        if (disc < 0.0f) return -1.0f;
+        float root = sqrtf(disc);
+        float t0 = (-qb - root) / qa;
+        float t1 = (-qb + root) / qa;
+        if (t1 < 0.0f || t0 > span) return -1.0f;
+        enter = (t0 > 0.0f) ? t0 : 0.0f;
+        leave = (t1 < span) ? t1 : span;
+    }
+    else if (qc > 0.0f)
+    {
+        return -1.0f;
+    }
 
-    float a_left = a->position.x - aw * 0.5f;
-    float a_top = a->position.y - ah * 0.5f;
-    float b_left = b->position.x - bw * 0.5f;
-    float b_top = b->position.y - bh * 0.5f;
+    // Both masks are baked at world resolution, so A's pixel centre
+    // (a_left + x + 0.5) lands in B's pixel x + floor(a_left - b_left + 0.5):
+    // a whole-pixel shift, answered coarse-to-fine by the occupancy pyramid.
+    // While the rocks move the shift walks a line through the integer
+    // lattice; every cell it crosses is tested in order, so the result does
+    // not depend on where the step boundaries fall.
+    float a_left = c->pos_x[a] - 0.5f * (float)shape_a->fine.width;
+    float a_top = c->pos_y[a] - 0.5f * (float)shape_a->fine.height;
+    float b_left = c->pos_x[b] - 0.5f * (float)shape_b->fine.width;
+    float b_top = c->pos_y[b] - 0.5f * (float)shape_b->fine.height;
+    float dx = a_left - b_left + 0.5f;
+    float dy = a_top - b_top + 0.5f;
+    int offset_x = (int)floorf(dx + vx * enter);
+    int offset_y = (int)floorf(dy + vy * enter);
+    int step_x = (vx > 0.0f) ? 1 : -1;
+    int step_y = (vy > 0.0f) ? 1 : -1;
+    float t = enter;
+    for (;;)
+    {
+        if (CollisionShape_Overlap(shape_a, shape_b, offset_x, offset_y, stats)) return t;
+        float next_x = (vx != 0.0f) ? ((float)(offset_x + (vx > 0.0f)) - dx) / vx : INFINITY;
+        float next_y = (vy != 0.0f) ? ((float)(offset_y + (vy > 0.0f)) - dy) / vy : INFINITY;
+        if (next_x <= next_y)
+        {
+            if (next_x > leave) return -1.0f;
+            offset_x += step_x;
+            if (next_x > t) t = next_x;
+        }
+        else
+        {
+            if (next_y > leave) return -1.0f;
+            offset_y += step_y;
+            if (next_y > t) t = next_y;
+        }
+    }
+}
 
-    float left = (a_left > b_left) ? a_left : b_left;
-    float top = (a_top > b_top) ? a_top : b_top;
-    float right = ((a_left + aw) < (b_left + bw)) ? (a_left + aw) : (b_left + bw);
-    float bottom = ((a_top + ah) < (b_top + bh)) ? (a_top + ah) : (b_top + bh);
+// Normal and depth of contact at its time, with both rocks moved on by it,
+// from every outline point of each shape looked up in the other's distance
+// field. The normal is the depth-weighted sum of the penetrating points'
+// gradients, leaving out those that face back across the line of centres (a
+// point deep in a thin or hollow part of the other rock sees its far edge as
+// nearest), and the depth is the deepest of the points kept. Without a
+// penetrating point the nearest point decides. A point's circle distance
+// bounds its field distance from below, so points that cannot matter are
+// skipped without a lookup.
+static void FindContact(const AsteroidSystem *system, AsteroidContact *contact)
+{
+    const AsteroidColumns *c = &system->columns;
+    const int rocks[2] = { contact->first, contact->second };
+    const CollisionShape *shapes[2] = { AsteroidShape(system, rocks[0]), AsteroidShape(system, rocks[1]) };
+    float t = contact->time;
+    float left[2];
+    float top[2];
+    for (int r = 0; r < 2; r++)
+    {
+        left[r] = c->pos_x[rocks[r]] + c->vel_x[rocks[r]] * t - 0.5f * (float)shapes[r]->fine.width;
+        top[r] = c->pos_y[rocks[r]] + c->vel_y[rocks[r]] * t - 0.5f * (float)shapes[r]->fine.height;
+    }
+    float axis_x = (left[1] + shapes[1]->circle_x) - (left[0] + shapes[0]->circle_x);
+    float axis_y = (top[1] + shapes[1]->circle_y) - (top[0] + shapes[0]->circle_y);
+    float axis_length = sqrtf(axis_x * axis_x + axis_y * axis_y);
+    axis_x = (axis_length > 0.0f) ? axis_x / axis_length : 1.0f;
+    axis_y = (axis_length > 0.0f) ? axis_y / axis_length : 0.0f;
 
-    if (right <= left || bottom <= top) return 0;
+    float nearest = INFINITY;
+    float nearest_x = axis_x;
+    float nearest_y = axis_y;
+    float deepest = 0.0f;
+    float sum_x = 0.0f;
+    float sum_y = 0.0f;
+    for (int r = 0; r < 2; r++)
+    {
+        // Points of shape r in the field of the other, whose gradient points
+        // out of it: towards first when the other is second, so the normal
+        // from first to second is then its reverse.
+        const CollisionShape *shape = shapes[r];
+        const CollisionShape *other = shapes[1 - r];
+        float sign = (r == 0) ? -1.0f : 1.0f;
+        float dx = left[r] - left[1 - r];
+        float dy = top[r] - top[1 - r];
+        for (int k = 0; k < shape->outline_count; k++)
+        {
+            float x = dx + shape->outline_x[k];
+            float y = dy + shape->outline_y[k];
+            float cx = x - other->circle_x;
+            float cy = y - other->circle_y;
+            float bound = sqrtf(cx * cx + cy * cy) - other->circle_radius;
+            if (bound >= 0.0f && bound >= nearest) continue;
+            float nx;
+            float ny;
+            float d = CollisionShape_Distance(other, x, y, &nx, &ny);
+            nx *= sign;
+            ny *= sign;
+            if (d < nearest)
+            {
+                nearest = d;
+                nearest_x = nx;
+                nearest_y = ny;
+            }
+            if (d >= 0.0f || nx * axis_x + ny * axis_y < 0.0f) continue;
+            sum_x -= nx * d;
+            sum_y -= ny * d;
+            if (-d > deepest) deepest = -d;
+        }
+    }
 
-    int start_ax = (int)floorf((left - a_left) / a->scale);
-    int end_ax = (int)ceilf((right - a_left) / a->scale);
-    int start_ay = (int)floorf((top - a_top) / a->scale);
-    int end_ay = (int)ceilf((bottom - a_top) / a->scale);
+    float length = sqrtf(sum_x * sum_x + sum_y * sum_y);
+    if (length > 0.0f)
+    {
+        contact->normal_x = sum_x / length;
+        contact->normal_y = sum_y / length;
+        contact->depth = deepest;
+    }
+    else
+    {
+        // Touching, a flat field, or only points facing back: the nearest
+        // point's gradient, or the line of centres.
+        int facing = (nearest_x * axis_x + nearest_y * axis_y >= 0.0f) && (nearest_x != 0.0f || nearest_y != 0.0f);
+        contact->normal_x = facing ? nearest_x : axis_x;
+        contact->normal_y = facing ? nearest_y : axis_y;
+        contact->depth = (nearest < 0.0f) ? -nearest : 0.0f;
+    }
+}
 
-    if (start_ax < 0) start_ax = 0;
-    if (start_ay < 0) start_ay = 0;
-    if (end_ax > asset_a->width) end_ax = asset_a->width;
-    if (end_ay > asset_a->height) end_ay = asset_a->height;
+// Narrowphase job over pairs [begin, end): contacts go to pair_contacts,
+// stats to the running thread's slot, so jobs never share a write target.
+static void TestPairsRange(void *user, int begin, int end)
+{
+    AsteroidSystem *system = (AsteroidSystem *)user;
+    const SpatialPair *pairs = system->broadphase.pairs;
+    // Jobs may run on a worker of someone else's system (e.g. one world per
+    // job); its index in that system means nothing here, so it gets slot 0.
+    int slot = JobSystem_ThreadIndex(system->jobs);
+    CollisionShapeStats *stats = &system->thread_stats[slot];
+    for (int p = begin; p < end; p++)
+    {
+        AsteroidContact *contact = &system->pair_contacts[p];
+        contact->first = (pairs[p].a < pairs[p].b) ? pairs[p].a : pairs[p].b;
+        contact->second = (pairs[p].a < pairs[p].b) ? pairs[p].b : pairs[p].a;
+        contact->time = SweptImpactTime(system, contact->first, contact->second, system->sweep_span, stats);
+        if (contact->time >= 0.0f) FindContact(system, contact);
+    }
+}
 
-    float inv_scale_b = 1.0f / b->scale;
+// By time, ties by the rocks' dense indices: the broadphase's pair order
+// depends on its cell size, which depends on the step length.
+static int CompareContacts(const void *a, const void *b)
+{
+    const AsteroidContact *ca = (const AsteroidContact *)a;
+    const AsteroidContact *cb = (const AsteroidContact *)b;
+    if (ca->time != cb->time) return (ca->time < cb->time) ? -1 : 1;
+    if (ca->first != cb->first) return (ca->first < cb->first) ? -1 : 1;
+    return (ca->second > cb->second) - (ca->second < cb->second);
+}
 
-    for (int y = start_ay; y < end_ay; y++)
+static float InverseMass(const AsteroidSystem *system, int index)
+{
+    int area = AsteroidShape(system, index)->area;
+    return (area > 0) ? 1.0f / (float)area : 0.0f;
+}
+
+static AsteroidCollision CollisionFrom(const AsteroidSystem *system, const AsteroidContact *contact)
+{
+    return (AsteroidCollision){
+        EntityPool_HandleAt(&system->pool, contact->first), EntityPool_HandleAt(&system->pool, contact->second),
+        contact->time, { contact->normal_x, contact->normal_y }, contact->depth, contact->impulse
+    };
+}
+
+// First contact claims both rocks; later ones touching a destroyed rock are
+// dropped.
+static void DestroyContacts(AsteroidSystem *system, int contact_count)
+{
+    for (int k = 0; k < contact_count; k++)
     {
-        float world_y = a_top + (y + 0.5f) * a->scale;
-        int by = (int)floorf((world_y - b_top) * inv_scale_b);
-        if (by < 0 || by >= asset_b->height) continue;
+        const AsteroidContact *contact = &system->contacts[k];
+        if (system->destroyed[contact->first] || system->destroyed[contact->second]) continue;
+        system->destroyed[contact->first] = 1;
+        system->destroyed[contact->second] = 1;
+        system->collisions[system->collision_count++] = CollisionFrom(system, contact);
+    }
+}
 
-        float world_x = a_left + (start_ax + 0.5f) * a->scale;
-        for (int x = start_ax; x < end_ax; x++, world_x += a->scale)
+// Sequential impulses over the whole batch, a fixed number of passes in
+// contact order: each contact's impulse along its normal is clamped to push
+// only, and aims for the approach speed reversed and scaled by the
+// restitution. Rocks keep their old velocity up to their first contact of
+// the span (their positions are shifted so the integration that follows
+// lands there), then overlaps beyond the slop are pushed apart by inverse
+// mass.
+static void BounceContacts(AsteroidSystem *system, int contact_count, float span)
+{
+    AsteroidColumns *c = &system->columns;
+    AsteroidContact *contacts = system->contacts;
+    for (int k = 0; k < contact_count; k++)
+    {
+        const int rocks[2] = { contacts[k].first, contacts[k].second };
+        for (int r = 0; r < 2; r++)
         {
-            if (!MaskSolid(asset_a, x, y)) continue;
+            system->solve_vel_x[rocks[r]] = c->vel_x[rocks[r]];
+            system->solve_vel_y[rocks[r]] = c->vel_y[rocks[r]];
+            system->solve_time[rocks[r]] = span;
+        }
+    }
+    for (int k = 0; k < contact_count; k++)
+    {
+        AsteroidContact *contact = &contacts[k];
+        float *time_a = &system->solve_time[contact->first];
+        float *time_b = &system->solve_time[contact->second];
+        if (contact->time < *time_a) *time_a = contact->time;
+        if (contact->time < *time_b) *time_b = contact->time;
+        float approach = (c->vel_x[contact->second] - c->vel_x[contact->first]) * contact->normal_x +
+                         (c->vel_y[contact->second] - c->vel_y[contact->first]) * contact->normal_y;
+        contact->target = (approach < 0.0f) ? -ASTEROID_RESTITUTION * approach : 0.0f;
+        contact->impulse = 0.0f;
+    }
 
-            int bx = (int)floorf((world_x - b_left) * inv_scale_b);
-            if (bx < 0 || bx >= asset_b->width) continue;
+    for (int pass = 0; pass < ASTEROID_SOLVER_PASSES; pass++)
+    {
+        for (int k = 0; k < contact_count; k++)
+        {
+            AsteroidContact *contact = &contacts[k];
+            int a = contact->first;
+            int b = contact->second;
+            float inv_a = InverseMass(system, a);
+            float inv_b = InverseMass(system, b);
+            if (inv_a + inv_b <= 0.0f) continue;
+            float normal_speed = (c->vel_x[b] - c->vel_x[a]) * contact->normal_x +
+                                 (c->vel_y[b] - c->vel_y[a]) * contact->normal_y;
+            float impulse = contact->impulse + (contact->target - normal_speed) / (inv_a + inv_b);
+            if (impulse < 0.0f) impulse = 0.0f;
+            float delta = impulse - contact->impulse;
+            contact->impulse = impulse;
+            c->vel_x[a] -= contact->normal_x * delta * inv_a;
+            c->vel_y[a] -= contact->normal_y * delta * inv_a;
+            c->vel_x[b] += contact->normal_x * delta * inv_b;
+            c->vel_y[b] += contact->normal_y * delta * inv_b;
+        }
+    }
 
-            if (MaskSolid(asset_b, bx, by)) return 1;
+    for (int k = 0; k < contact_count; k++)
+    {
+        const int rocks[2] = { contacts[k].first, contacts[k].second };
+        for (int r = 0; r < 2; r++)
+        {
+            int i = rocks[r];
+            // Negative once shifted, so a rock in several contacts moves once.
+            float time = system->solve_time[i];
+            if (time <= 0.0f) continue;
+            c->pos_x[i] += (system->solve_vel_x[i] - c->vel_x[i]) * time;
+            c->pos_y[i] += (system->solve_vel_y[i] - c->vel_y[i]) * time;
+            system->solve_time[i] = -1.0f;
         }
     }
 
-    return 0;
+    for (int k = 0; k < contact_count; k++)
+    {
+        const AsteroidContact *contact = &contacts[k];
+        system->collisions[system->collision_count++] = CollisionFrom(system, contact);
+        if (contact->depth <= ASTEROID_CONTACT_SLOP) continue;
+        int a = contact->first;
+        int b = contact->second;
+        float inv_a = InverseMass(system, a);
+        float inv_b = InverseMass(system, b);
+        if (inv_a + inv_b <= 0.0f) continue;
+        float push = ASTEROID_CONTACT_PUSH * (contact->depth - ASTEROID_CONTACT_SLOP) / (inv_a + inv_b);
+        c->pos_x[a] -= contact->normal_x * push * inv_a;
+        c->pos_y[a] -= contact->normal_y * push * inv_a;
+        c->pos_x[b] += contact->normal_x * push * inv_b;
+        c->pos_y[b] += contact->normal_y * push * inv_b;
+    }
+}
+
+// Finds the contacts of the coming span seconds of motion from the current
+// positions (span 0: overlaps where the asteroids are now), responds to them
+// (see collision_response) and lists them in system->collisions.
+static void ResolveCollisions(AsteroidSystem *system, float span)
+{
+    const AsteroidColumns *c = &system->columns;
+    int count = system->pool.count;
+    memset(system->destroyed, 0, (size_t)count);
+    system->collision_count = 0;
+
+    // Each rock enters the broadphase as the circle around its whole sweep.
+    float max_speed_sq = 0.0f;
+    for (int i = 0; i < count && span > 0.0f; i++)
+    {
+        float speed_sq = c->vel_x[i] * c->vel_x[i] + c->vel_y[i] * c->vel_y[i];
+        if (speed_sq > max_speed_sq) max_speed_sq = speed_sq;
+    }
+    float half_span = 0.5f * span;
+    SpatialHash *hash = &system->broadphase;
+    SpatialHash_Begin(hash, count, 2.0f * (system->max_radius + sqrtf(max_speed_sq) * half_span));
+    for (int i = 0; i < count; i++)
+    {
+        const CollisionShape *shape = AsteroidShape(system, i);
+        Vector2 center = AsteroidCenter(system, shape, i);
+        float speed = sqrtf(c->vel_x[i] * c->vel_x[i] + c->vel_y[i] * c->vel_y[i]);
+        SpatialHash_Insert(hash, i, center.x + c->vel_x[i] * half_span, center.y + c->vel_y[i] * half_span,
+                           shape->circle_radius + speed * half_span);
+    }
+    SpatialHash_Finish(hash);
+    int pair_count = SpatialHash_FindPairs(hash, system->jobs);
+
+    // Every pair is swept and its contact found in parallel first; the
+    // order-dependent response then runs serially in impact order, so the
+    // outcome is the same for any thread count, and a stretch of time gives
+    // the same events whether it is stepped in small or large steps.
+    int threads = JobSystem_ThreadCount(system->jobs);
+    if (!Memory_GrowArray((void **)&system->pair_contacts, &system->pair_contact_capacity, pair_count,
+                          sizeof(AsteroidContact), 256) ||
+        !Memory_GrowArray((void **)&system->thread_stats, &system->thread_stats_capacity, threads, sizeof(CollisionShapeStats), 1))
+    {
+        return;
+    }
+    memset(system->thread_stats, 0, (size_t)threads * sizeof(CollisionShapeStats));
+    system->sweep_span = span;
+    JobSystem_ParallelFor(system->jobs, pair_count, ASTEROID_PAIR_GRAIN, TestPairsRange, system);
+
+    system->stats.narrowphase_tests = pair_count;
+    system->stats.collisions = 0;
+    system->stats.shape = (CollisionShapeStats){0};
+    for (int t = 0; t < threads; t++)
+    {
+        system->stats.shape.tests += system->thread_stats[t].tests;
+        system->stats.shape.coarse_rejects += system->thread_stats[t].coarse_rejects;
+        system->stats.shape.coarse_accepts += system->thread_stats[t].coarse_accepts;
+        system->stats.shape.fine_tests += system->thread_stats[t].fine_tests;
+    }
+    system->stats.broadphase = hash->stats;
+
+    int contact_count = 0;
+    for (int p = 0; p < pair_count; p++) contact_count += system->pair_contacts[p].time >= 0.0f;
+    if (!Memory_GrowArray((void **)&system->contacts, &system->contact_capacity, contact_count, sizeof(AsteroidContact), 64) ||
+        !Memory_GrowArray((void **)&system->collisions, &system->collision_capacity, contact_count, sizeof(AsteroidCollision), 64))
+    {
+        return;
+    }
+    contact_count = 0;
+    for (int p = 0; p < pair_count; p++)
+    {
+        if (system->pair_contacts[p].time >= 0.0f) system->contacts[contact_count++] = system->pair_contacts[p];
+    }
+    qsort(system->contacts, (size_t)contact_count, sizeof(AsteroidContact), CompareContacts);
+
+    if (system->collision_response == ASTEROID_RESPONSE_DESTROY)
+    {
+        DestroyContacts(system, contact_count);
+    }
+    else
+    {
+        BounceContacts(system, contact_count, span);
+    }
+    system->stats.collisions = system->collision_count;
+}
+
+int Asteroids_Count(const AsteroidSystem *system)
+{
+    return system->pool.count;
+}
+
+AsteroidHandle Asteroids_HandleAt(const AsteroidSystem *system, int dense_index)
+{
+    return EntityPool_HandleAt(&system->pool, dense_index);
 }
 
-int Asteroids_FindClosest(const AsteroidSystem *system, Vector2 position, float range, float *out_dist)
+int Asteroids_IsAlive(const AsteroidSystem *system, AsteroidHandle handle)
+{
+    return EntityPool_Resolve(&system->pool, handle) >= 0;
+}
+
+typedef struct NearestQuery
+{
+    const AsteroidSystem *system;
+    int k;
+    int count;
+    AsteroidHandle *handles;
+    float *dist_sq;
+    float range_sq;
+} NearestQuery;
+
+// Keeps the k best hits sorted in the caller's buffers; returns the distance
+// a new hit has to beat (ties still enter via the higher-index rule).
+static float VisitNearest(void *user, int item, float dist_sq)
 {
-    float range_sq = range * range;
-    int best_index = -1;
-    float best_dist_sq = range_sq;
+    NearestQuery *query = (NearestQuery *)user;
+    int slot = query->count;
+    while (slot > 0)
+    {
+        float other = query->dist_sq[slot - 1];
+        int other_item = EntityPool_Resolve(&query->system->pool, query->handles[slot - 1]);
+        if (dist_sq > other || (dist_sq == other && item < other_item)) break;
+        slot--;
+    }
 
-    for (int i = 0; i < system->asteroid_count; i++)
+    if (slot < query->k)
     {
-        const Asteroid *asteroid = &system->asteroids[i];
-        float dx = asteroid->position.x - position.x;
-        float dy = asteroid->position.y - position.y;
-        float dist_sq = dx * dx + dy * dy;
-        if (dist_sq <= best_dist_sq)
+        int last = (query->count < query->k) ? query->count : query->k - 1;
+        for (int i = last; i > slot; i--)
         {
-            best_dist_sq = dist_sq;
-            best_index = i;
+            query->handles[i] = query->handles[i - 1];
+            query->dist_sq[i] = query->dist_sq[i - 1];
         }
+        query->handles[slot] = EntityPool_HandleAt(&query->system->pool, item);
+        query->dist_sq[slot] = dist_sq;
+        if (query->count < query->k) query->count++;
+    }
+
+    return (query->count == query->k) ? query->dist_sq[query->k - 1] : query->range_sq;
+}
+
+int Asteroids_QueryNearest(const AsteroidSystem *system, Vector2 position, float range, int k,
+                           AsteroidHandle *out_handles, float *out_dist_sq)
+{
+    if (k <= 0 || range < 0.0f) return 0;
+    NearestQuery query = { system, k, 0, out_handles, out_dist_sq, range * range };
+    SpatialQuery_Nearest(&system->query_index, position.x, position.y, query.range_sq, VisitNearest, &query);
+    return query.count;
+}
+
+typedef struct CollectQuery
+{
+    const AsteroidSystem *system;
+    AsteroidHandle *handles;
+    int capacity;
+    int count;
+} CollectQuery;
+
+static void VisitCollect(void *user, int item, float dist_sq)
+{
+    (void)dist_sq;
+    CollectQuery *query = (CollectQuery *)user;
+    if (query->count < query->capacity) query->handles[query->count] = EntityPool_HandleAt(&query->system->pool, item);
+    query->count++;
+}
+
+int Asteroids_QueryRadius(const AsteroidSystem *system, Vector2 position, float radius,
+                          AsteroidHandle *out_handles, int max_handles)
+{
+    CollectQuery query = { system, out_handles, max_handles, 0 };
+    SpatialQuery_Radius(&system->query_index, position.x, position.y, radius, VisitCollect, &query);
+    return query.count;
+}
+
+int Asteroids_QueryRect(const AsteroidSystem *system, Rectangle rect, AsteroidHandle *out_handles, int max_handles)
+{
+    CollectQuery query = { system, out_handles, max_handles, 0 };
+    SpatialQuery_Rect(&system->query_index, rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+                      VisitCollect, &query);
+    return query.count;
+}
+
+AsteroidHandle Asteroids_FindClosest(const AsteroidSystem *system, Vector2 position, float range, float *out_dist)
+{
+    AsteroidHandle best = ENTITY_HANDLE_NULL;
+    float best_dist_sq = 0.0f;
+    int found = Asteroids_QueryNearest(system, position, range, 1, &best, &best_dist_sq);
+
+    if (out_dist != NULL) *out_dist = found ? sqrtf(best_dist_sq) : 0.0f;
+    return best;
+}
+
+typedef struct RayQuery
+{
+    const AsteroidSystem *system;
+    float origin_x;
+    float origin_y;
+    float dir_x;
+    float dir_y;
+    float chunk_begin;
+    float best_t;
+    int best_index;
+} RayQuery;
+
+static void VisitRayCandidate(void *user, int item, float dist_sq)
+{
+    (void)dist_sq;
+    RayQuery *query = (RayQuery *)user;
+    const AsteroidSystem *system = query->system;
+    const CollisionShape *shape = AsteroidShape(system, item);
+
+    // Ray against the (padded) enclosing circle first. Candidates whose
+    // circle starts before this chunk were already tested by an earlier one.
+    Vector2 center = AsteroidCenter(system, shape, item);
+    float to_x = center.x - query->origin_x;
+    float to_y = center.y - query->origin_y;
+    float along = to_x * query->dir_x + to_y * query->dir_y;
+    float perp_sq = to_x * to_x + to_y * to_y - along * along;
+    float radius = shape->circle_radius + 1.0f;
+    if (perp_sq > radius * radius) return;
+    float half_chord = sqrtf(radius * radius - perp_sq);
+    float t_enter = along - half_chord;
+    if (t_enter < query->chunk_begin || t_enter > query->best_t || along + half_chord < 0.0f) return;
+
+    // Mask pixel (x, y) covers world [left + x, left + x + 1), as in
+    // SweptImpactTime.
+    float left = system->columns.pos_x[item] - 0.5f * (float)shape->fine.width;
+    float top = system->columns.pos_y[item] - 0.5f * (float)shape->fine.height;
+    float t = CollisionShape_Raycast(shape, query->origin_x - left, query->origin_y - top,
+                                     query->dir_x, query->dir_y, query->best_t);
+    if (t < 0.0f) return;
+    if (t < query->best_t || (t == query->best_t && item > query->best_index))
+    {
+        query->best_t = t;
+        query->best_index = item;
+    }
+}
+
+int Asteroids_Raycast(const AsteroidSystem *system, Vector2 origin, Vector2 dir, float max_dist, AsteroidRayHit *out_hit)
+{
+    float length = sqrtf(dir.x * dir.x + dir.y * dir.y);
+    if (length <= 0.0f || max_dist <= 0.0f) return 0;
+
+    RayQuery query = { system, origin.x, origin.y, dir.x / length, dir.y / length, -INFINITY, max_dist, -1 };
+
+    // Walk the query index a cell-sized chunk at a time, nearest chunk first.
+    // Every asteroid that can touch a chunk has its position within max_reach
+    // of it, so the chunk's box grown by max_reach finds all of them; once a
+    // hit lies inside the chunks walked so far, nothing further can beat it.
+    float step = ASTEROID_QUERY_CELL_SIZE;
+    float reach = system->max_reach;
+    for (float t0 = 0.0f; t0 < max_dist; t0 += step)
+    {
+        float t1 = (t0 + step < max_dist) ? t0 + step : max_dist;
+        float ax = origin.x + query.dir_x * t0;
+        float ay = origin.y + query.dir_y * t0;
+        float bx = origin.x + query.dir_x * t1;
+        float by = origin.y + query.dir_y * t1;
+        SpatialQuery_Rect(&system->query_index,
+                          fminf(ax, bx) - reach, fminf(ay, by) - reach, fmaxf(ax, bx) + reach, fmaxf(ay, by) + reach,
+                          VisitRayCandidate, &query);
+        if (query.best_index >= 0 && query.best_t <= t1) break;
+        query.chunk_begin = t1;
     }
 
-    if (out_dist != NULL) *out_dist = (best_index >= 0) ? sqrtf(best_dist_sq) : 0.0f;
-    return best_index;
+    if (query.best_index < 0) return 0;
+    if (out_hit != NULL)
+    {
+        out_hit->handle = EntityPool_HandleAt(&system->pool, query.best_index);
+        out_hit->distance = query.best_t;
+        out_hit->point = (Vector2){ origin.x + query.dir_x * query.best_t, origin.y + query.dir_y * query.best_t };
+    }
+    return 1;
 }
 
-int Asteroids_ApplyDamage(AsteroidSystem *system, int index, float damage)
+// What a destroyed rock leaves to its fragments.
+typedef struct AsteroidRemains
 {
-    if (index < 0 || index >= system->asteroid_count) return 0;
-    Asteroid *asteroid = &system->asteroids[index];
-    asteroid->hp -= damage;
-    if (asteroid->hp <= 0.0f)
+    float pos_x;
+    float pos_y;
+    float vel_x;
+    float vel_y;
+    float hp_max;
+    float scale;
+    int scale_bucket;
+    int asset_index;
+    int origin;
+} AsteroidRemains;
+
+// Instantiates the fragments of a destroyed rock straight from its asset's
+// fracture table: column writes only, no image work.
+static void SpawnFragments(AsteroidSystem *system, const AsteroidRemains *rock)
+{
+    const AsteroidAsset *asset = &system->assets[rock->asset_index];
+    if (asset->parent >= 0 || asset->fragment_count <= 0) return;
+    if (!ReserveAsteroids(system, system->pool.count + asset->fragment_count)) return;
+
+    AsteroidColumns *c = &system->columns;
+    for (int f = 0; f < asset->fragment_count; f++)
     {
+        const AsteroidAsset *fragment = &system->assets[asset->first_fragment + f];
+        EntityPool_Create(&system->pool);
+        int i = system->pool.count - 1;
+        c->pos_x[i] = rock->pos_x + fragment->offset.x * rock->scale;
+        c->pos_y[i] = rock->pos_y + fragment->offset.y * rock->scale;
+        c->vel_x[i] = rock->vel_x + fragment->drift.x * ASTEROID_FRAGMENT_KICK;
+        c->vel_y[i] = rock->vel_y + fragment->drift.y * ASTEROID_FRAGMENT_KICK;
+        c->hp_max[i] = rock->hp_max * fragment->area_share;
+        c->hp[i] = c->hp_max[i];
+        c->scale[i] = rock->scale;
+        c->scale_bucket[i] = rock->scale_bucket;
+        c->asset_index[i] = asset->first_fragment + f;
+        c->origin[i] = rock->origin;
+    }
+}
+
+int Asteroids_ApplyDamage(AsteroidSystem *system, AsteroidHandle handle, float damage)
+{
+    int index = EntityPool_Resolve(&system->pool, handle);
+    if (index < 0) return 0;
+    system->columns.hp[index] -= damage;
+    if (system->columns.hp[index] <= 0.0f)
+    {
+        // Keep the query index valid until the next rebuild: drop this entry
+        // and point the entry of the asteroid swapped into its slot at it.
+        // Fragments are appended after the removal, past every indexed item.
+        const AsteroidColumns *c = &system->columns;
+        int last = system->pool.count - 1;
+        SpatialHash_RemapItem(&system->query_index, c->pos_x[index], c->pos_y[index], index, -1);
+        if (last != index) SpatialHash_RemapItem(&system->query_index, c->pos_x[last], c->pos_y[last], last, index);
+        AsteroidRemains remains = { c->pos_x[index], c->pos_y[index], c->vel_x[index], c->vel_y[index],
+                                    c->hp_max[index], c->scale[index], c->scale_bucket[index],
+                                    c->asset_index[index], c->origin[index] };
+        int origin = remains.origin;
+        if (origin >= 0) system->sectors.sectors[origin / SECTOR_MAX_ROCKS].mined |= 1u << (origin % SECTOR_MAX_ROCKS);
         RemoveAsteroid(system, index);
+        SpawnFragments(system, &remains);
         return 1;
     }
     return 0;
@@ -233,76 +1441,237 @@ int Asteroids_ApplyDamage(AsteroidSystem *system, int index, float damage)
 
 void Asteroids_AddPopup(AsteroidSystem *system, Vector2 position, float value)
 {
-    if (system->popup_count >= ASTEROID_MAX) return;
+    if (!Memory_GrowArray((void **)&system->popups, &system->popup_capacity, system->popup_count + 1, sizeof(DamagePopup), 32)) return;
     DamagePopup *popup = &system->popups[system->popup_count++];
     popup->position = position;
-    popup->position.x += (float)GetRandomValue(-8, 8);
-    popup->position.y += (float)GetRandomValue(-8, 8);
+    popup->position.x += (float)Rng_RangeInt(&system->fx_rng, -8, 8);
+    popup->position.y += (float)Rng_RangeInt(&system->fx_rng, -8, 8);
     popup->value = value;
     popup->timer = 0.0f;
     popup->lifetime = 0.6f;
 }
 
-int Asteroids_GetInfo(const AsteroidSystem *system, int index, Vector2 *out_pos, float *out_radius)
+int Asteroids_GetHealth(const AsteroidSystem *system, AsteroidHandle handle, float *out_hp, float *out_hp_max)
+{
+    int index = EntityPool_Resolve(&system->pool, handle);
+    if (index < 0) return 0;
+    if (out_hp != NULL) *out_hp = system->columns.hp[index];
+    if (out_hp_max != NULL) *out_hp_max = system->columns.hp_max[index];
+    return 1;
+}
+
+int Asteroids_GetInfo(const AsteroidSystem *system, AsteroidHandle handle, Vector2 *out_pos, float *out_radius)
+{
+    int index = EntityPool_Resolve(&system->pool, handle);
+    if (index < 0) return 0;
+    const CollisionShape *shape = AsteroidShape(system, index);
+    if (out_pos != NULL) *out_pos = AsteroidCenter(system, shape, index);
+    if (out_radius != NULL) *out_radius = shape->circle_radius;
+    return 1;
+}
+
+typedef struct MoveJob
+{
+    AsteroidSystem *system;
+    float dt;
+} MoveJob;
+
+// Integration over [begin, end). The kernel does the same float ops on every
+// lane, so any split gives identical results.
+static void MoveRange(void *user, int begin, int end)
+{
+    const MoveJob *move = (const MoveJob *)user;
+    AsteroidColumns *c = &move->system->columns;
+    AsteroidKernels_Integrate(c->pos_x + begin, c->pos_y + begin, c->vel_x + begin, c->vel_y + begin, end - begin,
+                              move->dt);
+}
+
+// Generation job for sector slots [begin, end): fills their content from the
+// sector stream alone, so it can run on any thread at any time before the
+// insert. Reads only the assets and the sector's cell.
+static void GenerateSectors(void *user, int begin, int end)
 {
-    if (index < 0 || index >= system->asteroid_count) return 0;
-    const Asteroid *asteroid = &system->asteroids[index];
-    const AsteroidAsset *asset = &system->assets[asteroid->asset_index];
-    if (out_pos != NULL) *out_pos = asteroid->position;
-    if (out_radius != NULL)
+    AsteroidSystem *system = (AsteroidSystem *)user;
+    const float sub = SECTOR_SIZE / (float)SECTOR_GRID;
+    for (int slot = begin; slot < end; slot++)
     {
-        float w = asset->width * asteroid->scale;
-        float h = asset->height * asteroid->scale;
-        float r = 0.5f * ((w > h) ? w : h);
-        *out_radius = r;
+        const Sector *sector = &system->sectors.sectors[slot];
+        SectorContent *content = &system->sectors.content[slot];
+        uint64_t cell = ((uint64_t)(uint32_t)sector->cx << 32) | (uint32_t)sector->cy;
+        Rng rng = Rng_Create(system->sector_seed ^ ASTEROID_SECTOR_SALT, cell);
+        float draws[SECTOR_MAX_ROCKS * SECTOR_DRAWS];
+        Rng_FillFloatsAt(&rng, 0, draws, SECTOR_MAX_ROCKS * SECTOR_DRAWS, 0.0f, 1.0f);
+
+        content->count = 0;
+        for (int local = 0; local < SECTOR_MAX_ROCKS; local++)
+        {
+            const float *draw = draws + local * SECTOR_DRAWS;
+            if (draw[SECTOR_DRAW_FILL] >= ASTEROID_SECTOR_FILL) continue;
+
+            SectorRock *rock = &content->rocks[content->count++];
+            rock->local = local;
+            rock->asset_index = DrawIndex(draw[SECTOR_DRAW_TEXTURE], system->rock_count);
+            rock->scale_bucket = DrawIndex(draw[SECTOR_DRAW_BUCKET], ASTEROID_SCALE_BUCKETS);
+            const CollisionShape *shape = &system->assets[rock->asset_index].shapes[rock->scale_bucket];
+
+            // The collision circle starts inside its sub-cell, so no two
+            // generated rocks overlap, in this sector or the next.
+            float margin = (shape->circle_radius < 0.5f * sub) ? shape->circle_radius : 0.5f * sub;
+            float left = (float)sector->cx * SECTOR_SIZE + (float)(local % SECTOR_GRID) * sub;
+            float top = (float)sector->cy * SECTOR_SIZE + (float)(local / SECTOR_GRID) * sub;
+            float circle_x = left + Lerp(margin, sub - margin, draw[SECTOR_DRAW_X]);
+            float circle_y = top + Lerp(margin, sub - margin, draw[SECTOR_DRAW_Y]);
+            rock->pos_x = circle_x + 0.5f * (float)shape->fine.width - shape->circle_x;
+            rock->pos_y = circle_y + 0.5f * (float)shape->fine.height - shape->circle_y;
+
+            float drift_angle = draw[SECTOR_DRAW_DRIFT_ANGLE] * 2.0f * PI;
+            float speed = Lerp(system->speed * 0.5f, system->speed * 1.1f, draw[SECTOR_DRAW_SPEED]);
+            rock->vel_x = cosf(drift_angle) * speed;
+            rock->vel_y = sinf(drift_angle) * speed;
+            rock->hp_max = Lerp(60.0f, 120.0f, draw[SECTOR_DRAW_HP]);
+        }
     }
-    return 1;
 }
 
-void Asteroids_Update(AsteroidSystem *system, float dt, Camera2D camera, Vector2 player_pos)
+// Moves a generated sector's rocks, minus the mined ones, into the columns.
+static void InsertSector(AsteroidSystem *system, int slot)
 {
-    system->spawn_timer -= dt;
-    if (system->spawn_timer <= 0.0f)
+    Sector *sector = &system->sectors.sectors[slot];
+    const SectorContent *content = &system->sectors.content[slot];
+    sector->status = SECTOR_LIVE;
+    if (!ReserveAsteroids(system, system->pool.count + content->count)) return;
+
+    AsteroidColumns *c = &system->columns;
+    for (int r = 0; r < content->count; r++)
     {
-        SpawnAsteroid(system, camera, player_pos);
-        system->spawn_timer = system->spawn_interval;
+        const SectorRock *rock = &content->rocks[r];
+        if (sector->mined & (1u << rock->local)) continue;
+        EntityHandle handle = EntityPool_Create(&system->pool);
+        int i = system->pool.count - 1;
+        c->pos_x[i] = rock->pos_x;
+        c->pos_y[i] = rock->pos_y;
+        c->vel_x[i] = rock->vel_x;
+        c->vel_y[i] = rock->vel_y;
+        c->hp_max[i] = rock->hp_max;
+        c->hp[i] = rock->hp_max;
+        c->scale_bucket[i] = rock->scale_bucket;
+        c->scale[i] = Asteroids_BucketScale(rock->scale_bucket);
+        c->asset_index[i] = rock->asset_index;
+        c->origin[i] = slot * SECTOR_MAX_ROCKS + rock->local;
+        sector->handles[rock->local] = handle;
     }
+}
 
-    float max_dist = (system->max_spawn_dist > 0.0f) ? system->max_spawn_dist : 1200.0f;
-    float despawn_dist = max_dist + 600.0f;
-    float despawn_dist_sq = despawn_dist * despawn_dist;
+// Removes the sector and whatever is left of its rocks, wherever they drifted:
+// the ones it generated by handle, then the fragments of its mined ones by
+// origin (backwards, so every swapped-in asteroid has been looked at).
+static void EvictSector(AsteroidSystem *system, int slot)
+{
+    const Sector *sector = &system->sectors.sectors[slot];
+    for (int local = 0; local < SECTOR_MAX_ROCKS; local++)
+    {
+        int index = EntityPool_Resolve(&system->pool, sector->handles[local]);
+        if (index >= 0) RemoveAsteroid(system, index);
+    }
+    if (sector->mined != 0)
+    {
+        const int *origin = system->columns.origin;
+        for (int i = system->pool.count - 1; i >= 0; i--)
+        {
+            if (origin[i] >= slot * SECTOR_MAX_ROCKS && origin[i] < (slot + 1) * SECTOR_MAX_ROCKS) RemoveAsteroid(system, i);
+        }
+    }
+    SectorMap_Release(&system->sectors, slot);
+}
 
-    for (int i = 0; i < system->asteroid_count; )
+static void InsertPendingSectors(AsteroidSystem *system)
+{
+    JobSystem_Wait(system->jobs, &system->sector_jobs);
+    for (int slot = 0; slot < system->sectors.sector_count; slot++)
     {
-        Asteroid *asteroid = &system->asteroids[i];
-        asteroid->position.x += asteroid->velocity.x * dt;
-        asteroid->position.y += asteroid->velocity.y * dt;
+        if (system->sectors.sectors[slot].status == SECTOR_PENDING) InsertSector(system, slot);
+    }
+}
+
+static void RequestSector(AsteroidSystem *system, int slot)
+{
+    JobSystem_Submit(system->jobs, GenerateSectors, system, slot, slot + 1, &system->sector_jobs);
+}
 
-        Vector2 delta = { asteroid->position.x - player_pos.x, asteroid->position.y - player_pos.y };
-        float dist_sq = delta.x * delta.x + delta.y * delta.y;
-        if (dist_sq > despawn_dist_sq)
+// Sector content requested last tick enters the world now, whenever its job
+// finished, so what spawns when does not depend on thread timing. Sectors
+// are handled in slot order and cells requested row by row.
+static void StreamSectors(AsteroidSystem *system, Vector2 player_pos)
+{
+    SectorMap *map = &system->sectors;
+    InsertPendingSectors(system);
+    if (!system->stream_sectors || system->rock_count <= 0) return;
+
+    float load = system->view_radius + ASTEROID_SECTOR_LOAD_MARGIN;
+    float evict = system->view_radius + ASTEROID_SECTOR_EVICT_MARGIN;
+    for (int slot = 0; slot < map->sector_count; slot++)
+    {
+        const Sector *sector = &map->sectors[slot];
+        if (sector->status == SECTOR_LIVE &&
+            SectorMap_CellDistanceSq(sector->cx, sector->cy, player_pos.x, player_pos.y) > evict * evict)
         {
-            RemoveAsteroid(system, i);
-            continue;
+            EvictSector(system, slot);
         }
-        i++;
     }
 
-    for (int i = 0; i < system->asteroid_count; i++)
+    int min_cx = SectorMap_Cell(player_pos.x - load);
+    int max_cx = SectorMap_Cell(player_pos.x + load);
+    int min_cy = SectorMap_Cell(player_pos.y - load);
+    int max_cy = SectorMap_Cell(player_pos.y + load);
+    if (!SectorMap_Reserve(map, map->sector_count + (max_cx - min_cx + 1) * (max_cy - min_cy + 1))) return;
+    int was_empty = map->active == 0;
+    for (int cy = min_cy; cy <= max_cy; cy++)
     {
-        for (int j = i + 1; j < system->asteroid_count; )
+        for (int cx = min_cx; cx <= max_cx; cx++)
         {
-            if (AsteroidsOverlap(system, &system->asteroids[i], &system->asteroids[j]))
-            {
-                RemoveAsteroid(system, j);
-                RemoveAsteroid(system, i);
-                i--;
-                break;
-            }
-            j++;
+            if (SectorMap_CellDistanceSq(cx, cy, player_pos.x, player_pos.y) > load * load) continue;
+            if (SectorMap_Find(map, cx, cy) >= 0) continue;
+            int slot = SectorMap_Acquire(map, cx, cy);
+            if (slot >= 0) RequestSector(system, slot);
         }
     }
+    // A fresh world (or a jump) gets its surroundings now, not a tick later.
+    if (was_empty) InsertPendingSectors(system);
+}
+
+void Asteroids_Update(AsteroidSystem *system, float dt, Vector2 player_pos)
+{
+    PROFILE_BEGIN("sectors");
+    StreamSectors(system, player_pos);
+    PROFILE_END();
 
+    // Swept: collisions over the step's motion, then the move. Otherwise
+    // the move, then overlaps at the new positions (rocks faster than their
+    // size per step tunnel through each other).
+    if (system->swept_collisions)
+    {
+        PROFILE_BEGIN("collision");
+        ResolveCollisions(system, dt);
+        PROFILE_END();
+    }
+    PROFILE_BEGIN("integrate");
+    MoveJob move = { system, dt };
+    JobSystem_ParallelFor(system->jobs, system->pool.count, ASTEROID_MOVE_GRAIN, MoveRange, &move);
+    PROFILE_END();
+    if (!system->swept_collisions)
+    {
+        PROFILE_BEGIN("collision");
+        ResolveCollisions(system, 0.0f);
+        PROFILE_END();
+    }
+    PROFILE_BEGIN("compact");
+    CompactDestroyed(system);
+    PROFILE_END();
+    PROFILE_BEGIN("query_index");
+    RebuildQueryIndex(system);
+    PROFILE_END();
+
+    PROFILE_BEGIN("popups");
     for (int i = 0; i < system->popup_count; )
     {
         DamagePopup *popup = &system->popups[i];
@@ -315,27 +1684,36 @@ void Asteroids_Update(AsteroidSystem *system, float dt, Camera2D camera, Vector2
         }
         i++;
     }
+    PROFILE_END();
 }
 
-void Asteroids_Draw(AsteroidSystem *system)
+void Asteroids_DrawSprite(const AsteroidSystem *system, int asset_index, float x, float y, float scale,
+                          SpriteBatch *batch)
 {
-    for (int i = 0; i < system->asteroid_count; i++)
-    {
-        Asteroid *asteroid = &system->asteroids[i];
-        AsteroidAsset *asset = &system->assets[asteroid->asset_index];
-        Texture2D *tex = &asset->texture;
-        if (tex->id == 0) continue;
+    const AsteroidAsset *asset = &system->assets[asset_index];
+    Texture2D texture = (system->atlas.texture.id != 0) ? system->atlas.texture : asset->texture;
 
-        float w = tex->width * asteroid->scale;
-        float h = tex->height * asteroid->scale;
-        Rectangle dest = { asteroid->position.x, asteroid->position.y, w, h };
-        Vector2 origin = { w * 0.5f, h * 0.5f };
-        DrawTexturePro(*tex, (Rectangle){0, 0, (float)tex->width, (float)tex->height}, dest, origin, 0.0f, WHITE);
+    float w = (float)asset->width * scale;
+    float h = (float)asset->height * scale;
+    Rectangle dest = { x, y, w, h };
+    Vector2 origin = { w * 0.5f, h * 0.5f };
+    SpriteBatch_Submit(batch, texture, asset->region, dest, origin, 0.0f, WHITE, SPRITE_LAYER_ASTEROIDS);
+}
+
+void Asteroids_Draw(const AsteroidSystem *system, SpriteBatch *batch)
+{
+    const AsteroidColumns *c = &system->columns;
+    for (int i = 0; i < system->pool.count; i++)
+    {
+        Asteroids_DrawSprite(system, c->asset_index[i], c->pos_x[i], c->pos_y[i], c->scale[i], batch);
     }
+}
 
-    for (int i = 0; i < system->popup_count; i++)
+void Asteroids_DrawPopups(const DamagePopup *popups, int count)
+{
+    for (int i = 0; i < count; i++)
     {
-        DamagePopup *popup = &system->popups[i];
+        const DamagePopup *popup = &popups[i];
         float t = popup->timer / popup->lifetime;
         if (t < 0.0f) t = 0.0f;
         if (t > 1.0f) t = 1.0f;
@@ -347,13 +1725,305 @@ void Asteroids_Draw(AsteroidSystem *system)
     }
 }
 
+// The columns in state order; lengths are all state->count.
+static void StateColumns(const AsteroidColumns *c, void **out)
+{
+    void *columns[] = { c->pos_x, c->pos_y, c->vel_x, c->vel_y, c->hp, c->hp_max, c->scale, c->scale_bucket,
+                        c->asset_index, c->origin };
+    memcpy(out, columns, sizeof(columns));
+}
+
+#define ASTEROID_STATE_COLUMNS 10
+#define ASTEROID_STATE_ASSET_COLUMN 8
+#define ASTEROID_STATE_ORIGIN_COLUMN 9
+_Static_assert(sizeof(int) == sizeof(float), "state columns are sized as floats");
+
+size_t Asteroids_StateArraySize(const AsteroidState *state)
+{
+    size_t count = (size_t)state->count;
+    size_t slots = (size_t)state->slot_count;
+    return ASTEROID_STATE_COLUMNS * count * sizeof(float) + slots * (sizeof(uint32_t) + sizeof(int)) +
+           count * sizeof(int) + (size_t)state->free_count * sizeof(int) + (size_t)state->popup_count * sizeof(DamagePopup) +
+           (size_t)state->sector_count * sizeof(Sector) + (size_t)state->dirty_count * sizeof(SectorDirty);
+}
+
+void Asteroids_SaveState(const AsteroidSystem *system, AsteroidState *state, unsigned char *arrays)
+{
+    const EntityPool *pool = &system->pool;
+    const SectorMap *map = &system->sectors;
+    *state = (AsteroidState){0};
+    state->spawn_rng = system->spawn_rng;
+    state->fx_rng = system->fx_rng;
+    state->sector_seed = system->sector_seed;
+    state->view_radius = system->view_radius;
+    state->speed = system->speed;
+    state->stream_sectors = system->stream_sectors;
+    state->swept_collisions = system->swept_collisions;
+    state->collision_response = (int32_t)system->collision_response;
+    state->count = pool->count;
+    state->slot_count = pool->slot_count;
+    state->free_count = pool->free_count;
+    state->popup_count = system->popup_count;
+    state->sector_count = map->sector_count;
+    state->dirty_count = map->dirty_count;
+
+    size_t count = (size_t)pool->count;
+    size_t slots = (size_t)pool->slot_count;
+    void *columns[ASTEROID_STATE_COLUMNS];
+    StateColumns(&system->columns, columns);
+    for (int i = 0; i < ASTEROID_STATE_COLUMNS; i++)
+    {
+        if (count > 0) memcpy(arrays, columns[i], count * sizeof(float));
+        arrays += count * sizeof(float);
+    }
+    if (slots > 0)
+    {
+        memcpy(arrays, pool->generations, slots * sizeof(uint32_t));
+        memcpy(arrays + slots * sizeof(uint32_t), pool->slot_to_dense, slots * sizeof(int));
+    }
+    arrays += slots * (sizeof(uint32_t) + sizeof(int));
+    if (count > 0) memcpy(arrays, pool->dense_to_slot, count * sizeof(int));
+    arrays += count * sizeof(int);
+    if (pool->free_count > 0) memcpy(arrays, pool->free_slots, (size_t)pool->free_count * sizeof(int));
+    arrays += (size_t)pool->free_count * sizeof(int);
+    if (system->popup_count > 0) memcpy(arrays, system->popups, (size_t)system->popup_count * sizeof(DamagePopup));
+    arrays += (size_t)system->popup_count * sizeof(DamagePopup);
+    if (map->sector_count > 0) memcpy(arrays, map->sectors, (size_t)map->sector_count * sizeof(Sector));
+    arrays += (size_t)map->sector_count * sizeof(Sector);
+    if (map->dirty_count > 0) memcpy(arrays, map->dirty, (size_t)map->dirty_count * sizeof(SectorDirty));
+}
+
+static int ReadStateInt(const unsigned char *bytes, size_t i)
+{
+    int value;
+    memcpy(&value, bytes + i * sizeof(int), sizeof(value));
+    return value;
+}
+
+// Checks the saved pool tables and sector handles before anything is
+// copied: live slots and dense entries map to each other, every other slot
+// is on the free list exactly once, generations are non-zero, and sector
+// handles name saved slots (a handle of the slot's current generation must
+// be live; older ones are stale by design). Returns 0 if anything is off.
+static int PoolStateValid(const AsteroidState *state, const unsigned char *pool_bytes, const unsigned char *sector_bytes)
+{
+    int count = state->count;
+    int slots = state->slot_count;
+    if (count + state->free_count != slots) return 0;
+    const unsigned char *generations = pool_bytes;
+    const unsigned char *slot_to_dense = generations + (size_t)slots * sizeof(uint32_t);
+    const unsigned char *dense_to_slot = slot_to_dense + (size_t)slots * sizeof(int);
+    const unsigned char *free_slots = dense_to_slot + (size_t)count * sizeof(int);
+
+    unsigned char *seen = (unsigned char *)calloc((size_t)(slots > 0 ? slots : 1), 1);
+    if (seen == NULL) return 0;
+    int ok = 1;
+    for (int slot = 0; slot < slots && ok; slot++)
+    {
+        uint32_t generation;
+        memcpy(&generation, generations + (size_t)slot * sizeof(uint32_t), sizeof(generation));
+        int dense = ReadStateInt(slot_to_dense, (size_t)slot);
+        if (generation == 0u || dense < -1 || dense >= count) ok = 0;
+        else if (dense >= 0 && ReadStateInt(dense_to_slot, (size_t)dense) != slot) ok = 0;
+    }
+    for (int dense = 0; dense < count && ok; dense++)
+    {
+        int slot = ReadStateInt(dense_to_slot, (size_t)dense);
+        if (slot < 0 || slot >= slots || ReadStateInt(slot_to_dense, (size_t)slot) != dense) ok = 0;
+    }
+    for (int i = 0; i < state->free_count && ok; i++)
+    {
+        int slot = ReadStateInt(free_slots, (size_t)i);
+        if (slot < 0 || slot >= slots || seen[slot] || ReadStateInt(slot_to_dense, (size_t)slot) != -1) ok = 0;
+        else seen[slot] = 1;
+    }
+    free(seen);
+
+    for (int s = 0; s < state->sector_count && ok; s++)
+    {
+        const unsigned char *sector = sector_bytes + (size_t)s * sizeof(Sector);
+        for (int local = 0; local < SECTOR_MAX_ROCKS && ok; local++)
+        {
+            EntityHandle handle;
+            memcpy(&handle, sector + offsetof(Sector, handles) + (size_t)local * sizeof(EntityHandle), sizeof(handle));
+            if (EntityHandle_IsNull(handle)) continue;
+            if (handle.index >= (uint32_t)slots)
+            {
+                ok = 0;
+                break;
+            }
+            uint32_t generation;
+            memcpy(&generation, generations + (size_t)handle.index * sizeof(uint32_t), sizeof(generation));
+            if (handle.generation == generation && ReadStateInt(slot_to_dense, handle.index) < 0) ok = 0;
+        }
+    }
+    return ok;
+}
+
+int Asteroids_LoadState(AsteroidSystem *system, const AsteroidState *state, const unsigned char *arrays)
+{
+    if (state->count < 0 || state->slot_count < state->count || state->free_count < 0 ||
+        state->free_count > state->slot_count || state->popup_count < 0 || state->sector_count < 0 ||
+        state->dirty_count < 0)
+    {
+        return 0;
+    }
+    size_t count = (size_t)state->count;
+    size_t slots = (size_t)state->slot_count;
+    const unsigned char *asset_column = arrays + ASTEROID_STATE_ASSET_COLUMN * count * sizeof(float);
+    const unsigned char *origin_column = arrays + ASTEROID_STATE_ORIGIN_COLUMN * count * sizeof(float);
+    for (size_t i = 0; i < count; i++)
+    {
+        int asset;
+        int origin;
+        memcpy(&asset, asset_column + i * sizeof(int), sizeof(asset));
+        memcpy(&origin, origin_column + i * sizeof(int), sizeof(origin));
+        if (asset < 0 || asset >= system->asset_count || origin < -1 || origin >= state->sector_count * SECTOR_MAX_ROCKS)
+        {
+            return 0;
+        }
+    }
+    AsteroidState before_sectors = *state;
+    before_sectors.sector_count = 0;
+    before_sectors.dirty_count = 0;
+    const unsigned char *sector_bytes = arrays + Asteroids_StateArraySize(&before_sectors);
+    for (int slot = 0; slot < state->sector_count; slot++)
+    {
+        int32_t status;
+        memcpy(&status, sector_bytes + (size_t)slot * sizeof(Sector) + offsetof(Sector, status), sizeof(status));
+        if (status < SECTOR_FREE || status > SECTOR_LIVE) return 0;
+    }
+    if (!PoolStateValid(state, arrays + ASTEROID_STATE_COLUMNS * count * sizeof(float), sector_bytes)) return 0;
+    const SectorDirty *dirty = (const SectorDirty *)(const void *)(sector_bytes + (size_t)state->sector_count * sizeof(Sector));
+    // Nothing may be generating into the sector arrays while they change.
+    JobSystem_Wait(system->jobs, &system->sector_jobs);
+    SectorMap *map = &system->sectors;
+    if (!ReserveAsteroids(system, state->slot_count) ||
+        !Memory_GrowArray((void **)&system->popups, &system->popup_capacity, state->popup_count, sizeof(DamagePopup), 32) ||
+        !SectorMap_Reserve(map, state->sector_count) || !SectorMap_SetDirty(map, dirty, state->dirty_count))
+    {
+        return 0;
+    }
+
+    void *columns[ASTEROID_STATE_COLUMNS];
+    StateColumns(&system->columns, columns);
+    for (int i = 0; i < ASTEROID_STATE_COLUMNS; i++)
+    {
+        if (count > 0) memcpy(columns[i], arrays, count * sizeof(float));
+        arrays += count * sizeof(float);
+    }
+    EntityPool *pool = &system->pool;
+    if (slots > 0)
+    {
+        memcpy(pool->generations, arrays, slots * sizeof(uint32_t));
+        memcpy(pool->slot_to_dense, arrays + slots * sizeof(uint32_t), slots * sizeof(int));
+    }
+    arrays += slots * (sizeof(uint32_t) + sizeof(int));
+    if (count > 0) memcpy(pool->dense_to_slot, arrays, count * sizeof(int));
+    arrays += count * sizeof(int);
+    if (state->free_count > 0) memcpy(pool->free_slots, arrays, (size_t)state->free_count * sizeof(int));
+    arrays += (size_t)state->free_count * sizeof(int);
+    if (state->popup_count > 0) memcpy(system->popups, arrays, (size_t)state->popup_count * sizeof(DamagePopup));
+    arrays += (size_t)state->popup_count * sizeof(DamagePopup);
+    pool->count = state->count;
+    pool->slot_count = state->slot_count;
+    pool->free_count = state->free_count;
+    system->popup_count = state->popup_count;
+
+    // Sectors: the slot array as saved; pending ones are generated again.
+    if (map->sector_count > state->sector_count)
+    {
+        memset(map->sectors + state->sector_count, 0, (size_t)(map->sector_count - state->sector_count) * sizeof(Sector));
+    }
+    if (state->sector_count > 0) memcpy(map->sectors, sector_bytes, (size_t)state->sector_count * sizeof(Sector));
+    map->sector_count = state->sector_count;
+    map->active = 0;
+
+    system->spawn_rng = state->spawn_rng;
+    system->fx_rng = state->fx_rng;
+    system->sector_seed = state->sector_seed;
+    system->view_radius = state->view_radius;
+    system->speed = state->speed;
+    system->stream_sectors = state->stream_sectors;
+    system->swept_collisions = state->swept_collisions;
+    system->collision_response = (state->collision_response == ASTEROID_RESPONSE_DESTROY)
+                               ? ASTEROID_RESPONSE_DESTROY : ASTEROID_RESPONSE_BOUNCE;
+    system->stats = (AsteroidStats){0};
+    for (int slot = 0; slot < map->sector_count; slot++)
+    {
+        if (map->sectors[slot].status == SECTOR_FREE) continue;
+        map->active++;
+        if (map->sectors[slot].status == SECTOR_PENDING) RequestSector(system, slot);
+    }
+    RebuildQueryIndex(system);
+    return 1;
+}
+
 void Asteroids_Unload(AsteroidSystem *system)
 {
-    for (int i = 0; i < system->asset_count; i++)
+    JobSystem_Wait(system->jobs, &system->sector_jobs);
+    for (int i = 0; i < system->asset_count && !system->shares_assets; i++)
+    {
+        if (system->assets[i].texture.id != 0) UnloadTexture(system->assets[i].texture);
+        FreeAssetMasks(&system->assets[i]);
+    }
+    if (!system->shares_assets)
     {
-        UnloadTexture(system->assets[i].texture);
-        free(system->assets[i].mask);
-        system->assets[i].mask = NULL;
+        free(system->assets);
+        SpriteAtlas_Unload(&system->atlas);
     }
+    system->atlas = (SpriteAtlas){0};
+    // Assets still loading (the loader must have been freed first, so no
+    // decode job is writing to them).
+    for (int slot = 0; slot < system->loading_total; slot++)
+    {
+        AsteroidAsset *loaded = &system->loading_assets[slot];
+        ReleaseAssetImage(loaded);
+        if (loaded->width > 0) FreeAssetMasks(loaded);
+        ReleaseStagedFragments(loaded);
+    }
+    free(system->loading_assets);
+    system->loading_assets = NULL;
+    system->loading_total = 0;
+    system->loading_resolved = 0;
+    system->assets = NULL;
     system->asset_count = 0;
+    system->asset_capacity = 0;
+    system->rock_count = 0;
+    system->mask_bytes = 0;
+
+    EntityPool_Free(&system->pool);
+    FreeColumns(&system->columns);
+    free(system->destroyed);
+    free(system->pair_contacts);
+    free(system->contacts);
+    free(system->solve_vel_x);
+    free(system->solve_vel_y);
+    free(system->solve_time);
+    free(system->collisions);
+    free(system->thread_stats);
+    free(system->spawn_draws);
+    free(system->popups);
+    system->destroyed = NULL;
+    system->pair_contacts = NULL;
+    system->pair_contact_capacity = 0;
+    system->contacts = NULL;
+    system->contact_capacity = 0;
+    system->solve_vel_x = NULL;
+    system->solve_vel_y = NULL;
+    system->solve_time = NULL;
+    system->collisions = NULL;
+    system->collision_count = 0;
+    system->collision_capacity = 0;
+    system->thread_stats = NULL;
+    system->thread_stats_capacity = 0;
+    system->spawn_draws = NULL;
+    system->spawn_draw_capacity = 0;
+    system->popups = NULL;
+    system->asteroid_capacity = 0;
+    system->popup_count = 0;
+    system->popup_capacity = 0;
+    SectorMap_Free(&system->sectors);
+    SpatialHash_Free(&system->broadphase);
+    SpatialHash_Free(&system->query_index);
 }
@@ -2,27 +2,128 @@
 #define ASTEROIDS_H
 
 #include "raylib.h"
+#include "asset_loader.h"
+#include "sprite_atlas.h"
+#include "sprite_batch.h"
+#include "spatial_hash.h"
+#include "spatial_query.h"
+#include "collision_shape.h"
+#include "entity_pool.h"
+#include "job_system.h"
+#include "rng.h"
+#include "sectors.h"
 
-#define ASTEROID_MAX 128
-#define ASTEROID_TEXTURE_MAX 64
+#include <stddef.h>
+#include <stdint.h>
+
+// Asteroid scales are quantised into buckets so every asset can carry a
+// pre-scaled collision mask per bucket.
+#define ASTEROID_SCALE_BUCKETS 6
+#define ASTEROID_SCALE_MIN 0.6f
+#define ASTEROID_SCALE_STEP 0.1f
+#define ASTEROID_SCALE_MAX (ASTEROID_SCALE_MIN + ASTEROID_SCALE_STEP * (ASTEROID_SCALE_BUCKETS - 1))
+// Alpha above this is solid in the collision masks.
+#define ASTEROID_MASK_THRESHOLD 20
+
+#define ASTEROID_DEFAULT_DIRECTORY "Assets/Textures/Asteroids/Stone"
 
 typedef struct AsteroidAsset
 {
+    // Own texture, only used when the assets did not fit in the system atlas.
     Texture2D texture;
-    unsigned char *mask;
+    // Where the asset sits in the texture it is drawn from.
+    Rectangle region;
+    CollisionShape shapes[ASTEROID_SCALE_BUCKETS];
     int width;
     int height;
+    // Shapes are views into the mounted asset pack (not freed on unload).
+    int mapped;
+    // RGBA8 pixels, held only while loading until the textures are uploaded.
+    Image image;
+    int image_is_view;
+    // Whole rocks (parent -1) break into the fragment assets [first_fragment,
+    // first_fragment + fragment_count), cut from their mask at load (see
+    // fracture.h). A fragment records the rock it came from, where its
+    // image's centre sits relative to the rock's (image pixels), the unit
+    // direction from the rock's centroid to its own (it is thrown that way)
+    // and its share of the rock's solid area (and so of its hit points).
+    int parent;
+    int first_fragment;
+    int fragment_count;
+    Vector2 offset;
+    Vector2 drift;
+    float area_share;
+    // While loading: the rock's fragments, until every rock is in and they
+    // are appended after them.
+    struct AsteroidAsset *staged_fragments;
 } AsteroidAsset;
 
-typedef struct Asteroid
+typedef EntityHandle AsteroidHandle;
+
+// Per-asteroid components as structure-of-arrays columns, all indexed by the
+// same dense index. Hot loops (integration, nearest search) touch only
+// pos/vel; everything else stays out of their cache lines.
+typedef struct AsteroidColumns
 {
-    Vector2 position;
-    Vector2 velocity;
-    float scale;
-    int asset_index;
-    float hp;
-    float hp_max;
-} Asteroid;
+    float *pos_x;
+    float *pos_y;
+    float *vel_x;
+    float *vel_y;
+    float *hp;
+    float *hp_max;
+    float *scale;
+    int *scale_bucket;
+    int *asset_index;
+    // Sector rock the asteroid was generated as (sector slot *
+    // SECTOR_MAX_ROCKS + sub-cell), or -1 for Asteroids_SpawnField rocks.
+    int *origin;
+} AsteroidColumns;
+
+typedef struct AsteroidRayHit
+{
+    AsteroidHandle handle;
+    Vector2 point;
+    float distance;
+} AsteroidRayHit;
+
+typedef enum AsteroidResponse
+{
+    // Rocks bounce off each other: impulses along the contact normal, with
+    // mass from mask area, and overlaps are pushed apart.
+    ASTEROID_RESPONSE_BOUNCE = 0,
+    // Both rocks of a collision are destroyed (only a rock's first hit in an
+    // update counts).
+    ASTEROID_RESPONSE_DESTROY
+} AsteroidResponse;
+
+// Two asteroids that hit each other time seconds into the update's step:
+// the unit contact normal from a to b, how far they overlapped (pixels) and
+// the impulse that separated them (0 when destroyed).
+typedef struct AsteroidCollision
+{
+    AsteroidHandle a;
+    AsteroidHandle b;
+    float time;
+    Vector2 normal;
+    float depth;
+    float impulse;
+} AsteroidCollision;
+
+// Narrowphase result for dense indices first < second: the time of impact in
+// the step (negative: none) and, at that time, the contact normal from first
+// to second and the penetration depth. target and impulse belong to the
+// solver: the normal velocity it aims for and the impulse applied so far.
+typedef struct AsteroidContact
+{
+    float time;
+    float normal_x;
+    float normal_y;
+    float depth;
+    int first;
+    int second;
+    float target;
+    float impulse;
+} AsteroidContact;
 
 typedef struct DamagePopup
 {
@@ -32,28 +133,197 @@ typedef struct DamagePopup
     float lifetime;
 } DamagePopup;
 
+typedef struct AsteroidStats
+{
+    SpatialHashStats broadphase;
+    CollisionShapeStats shape;
+    int narrowphase_tests;
+    int collisions;
+} AsteroidStats;
+
+// Asteroids live in dense columns indexed through an EntityPool; anything that
+// holds on to an asteroid across calls uses an AsteroidHandle, never a dense
+// index, because removals swap the last asteroid into the freed spot.
+// Assets, columns and popups are heap arrays that grow geometrically.
 typedef struct AsteroidSystem
 {
-    AsteroidAsset assets[ASTEROID_TEXTURE_MAX];
+    // Whole rocks first ([0, rock_count), the ones that spawn), then their
+    // fragments.
+    AsteroidAsset *assets;
     int asset_count;
-    Asteroid asteroids[ASTEROID_MAX];
-    int asteroid_count;
-    DamagePopup popups[ASTEROID_MAX];
+    int asset_capacity;
+    int rock_count;
+    // Set by Asteroids_InitShared: assets belong to another system, which
+    // must outlive this one.
+    int shares_assets;
+    // Every asset's pixels in one texture, so all asteroids draw in a single
+    // batch; empty in headless runs or if they do not fit.
+    SpriteAtlas atlas;
+    EntityPool pool;
+    AsteroidColumns columns;
+    int asteroid_capacity;
+    DamagePopup *popups;
     int popup_count;
-    float spawn_timer;
-    float spawn_interval;
-    float min_spawn_dist;
-    float max_spawn_dist;
+    int popup_capacity;
+    // Sectors within view_radius (plus a margin) of the player are streamed
+    // in, generated from sector_seed; 0 in stream_sectors stops streaming
+    // (active sectors stay until Asteroids_Reset).
+    float view_radius;
     float speed;
+    uint64_t sector_seed;
+    int stream_sectors;
+    SectorMap sectors;
+    // Generation jobs of the pending sectors.
+    JobCounter sector_jobs;
+    float max_radius;
+    float max_reach;
+    size_t mask_bytes;
+    SpatialHash broadphase;
+    // Asteroid positions (dense indices as items) for Asteroids_Query*;
+    // rebuilt at the end of every update and patched on removals in between.
+    SpatialHash query_index;
+    unsigned char *destroyed;
+    // Nonzero (the default): collisions are found along each step's motion,
+    // so rocks cannot pass through each other however long the step; 0 only
+    // tests where the rocks end up.
+    int swept_collisions;
+    AsteroidResponse collision_response;
+    // The last update's collisions, in the order they were resolved.
+    AsteroidCollision *collisions;
+    int collision_count;
+    int collision_capacity;
+    // Per-pair contacts and per-thread shape stats, filled by jobs; the span
+    // they sweep over.
+    AsteroidContact *pair_contacts;
+    int pair_contact_capacity;
+    float sweep_span;
+    // The hits among them in resolution order, and per-rock solver scratch
+    // (velocity before the solve, time of the first contact), grown with the
+    // columns.
+    AsteroidContact *contacts;
+    int contact_capacity;
+    float *solve_vel_x;
+    float *solve_vel_y;
+    float *solve_time;
+    CollisionShapeStats *thread_stats;
+    int thread_stats_capacity;
+    // Optional; NULL runs every stage on the calling thread.
+    JobSystem *jobs;
+    // Field spawns and cosmetic jitter come from separate streams, so
+    // effects never shift what spawns.
+    Rng spawn_rng;
+    Rng fx_rng;
+    float *spawn_draws;
+    int spawn_draw_capacity;
+    AsteroidStats stats;
+    // Asteroids_InitAsync: assets still loading, moved into `assets` at once
+    // when the last one resolves.
+    AsteroidAsset *loading_assets;
+    int loading_total;
+    int loading_resolved;
 } AsteroidSystem;
 
-void Asteroids_Init(AsteroidSystem *system, const char *directory);
-void Asteroids_Update(AsteroidSystem *system, float dt, Camera2D camera, Vector2 player_pos);
-void Asteroids_Draw(AsteroidSystem *system);
-int Asteroids_FindClosest(const AsteroidSystem *system, Vector2 position, float range, float *out_dist);
-int Asteroids_ApplyDamage(AsteroidSystem *system, int index, float damage);
+// Everything an AsteroidSystem simulates, apart from its arrays: tuning,
+// random streams and the array lengths. Pointer-free, for WorldState; the
+// arrays follow it in Asteroids_SaveState's layout.
+typedef struct AsteroidState
+{
+    Rng spawn_rng;
+    Rng fx_rng;
+    uint64_t sector_seed;
+    float view_radius;
+    float speed;
+    int32_t stream_sectors;
+    int32_t swept_collisions;
+    int32_t collision_response;
+    int32_t count;
+    int32_t slot_count;
+    int32_t free_count;
+    int32_t popup_count;
+    int32_t sector_count;
+    int32_t dirty_count;
+} AsteroidState;
+
+float Asteroids_BucketScale(int bucket);
+// Builds the per-bucket collision shapes of an RGBA8 image (what the loader
+// does per asset; also used by the asset cooker). Returns 0 on failure, with
+// nothing left allocated.
+int Asteroids_BakeShapes(CollisionShape shapes[ASTEROID_SCALE_BUCKETS], const Image *image);
+// Fingerprint of every parameter Asteroids_BakeShapes depends on; cooked
+// shapes are only used when it matches.
+uint32_t Asteroids_ShapeKey(void);
+// Loads from the mounted asset pack (see asset_pack.h) when it holds the
+// directory's PNGs, else decodes the PNGs and bakes masks.
+// seed selects the system's random streams (normally the world seed).
+void Asteroids_Init(AsteroidSystem *system, const char *directory, int load_textures, uint64_t seed);
+// Same assets, queued on loader instead of loaded here (textures included).
+// They are published together, in Asteroids_Init's order, once every one has
+// resolved; until then asset_count is 0 and nothing spawns. Free the loader
+// before Asteroids_Unload.
+void Asteroids_InitAsync(AsteroidSystem *system, const char *directory, AssetLoader *loader, uint64_t seed);
+// Borrows source's loaded assets (masks, textures) instead of loading a copy;
+// for running many worlds side by side.
+void Asteroids_InitShared(AsteroidSystem *system, const AsteroidSystem *source, uint64_t seed);
+// Removes every asteroid and popup and restarts the random streams from seed;
+// assets, tuning and allocations are kept.
+void Asteroids_Reset(AsteroidSystem *system, uint64_t seed);
+// Streams sectors around player_pos (sectors requested on one tick enter the
+// world on the next, generated on the job system in between; a sector out of
+// range leaves with all its rocks), then moves, collides (see
+// swept_collisions and collision_response; the hits are listed in
+// collisions) and compacts.
+void Asteroids_Update(AsteroidSystem *system, float dt, Vector2 player_pos);
+// Rocks outside the sector scheme: they never leave on their own.
+void Asteroids_SpawnField(AsteroidSystem *system, Vector2 center, int count, float radius);
+// Submits every asteroid to batch (SPRITE_LAYER_ASTEROIDS).
+void Asteroids_Draw(const AsteroidSystem *system, SpriteBatch *batch);
+// One asteroid sprite from its asset, e.g. out of a render snapshot. Only
+// the assets are read, which do not change once loaded.
+void Asteroids_DrawSprite(const AsteroidSystem *system, int asset_index, float x, float y, float scale,
+                          SpriteBatch *batch);
+// Damage numbers; plain text, drawn directly.
+void Asteroids_DrawPopups(const DamagePopup *popups, int count);
+int Asteroids_Count(const AsteroidSystem *system);
+AsteroidHandle Asteroids_HandleAt(const AsteroidSystem *system, int dense_index);
+int Asteroids_IsAlive(const AsteroidSystem *system, AsteroidHandle handle);
+AsteroidHandle Asteroids_FindClosest(const AsteroidSystem *system, Vector2 position, float range, float *out_dist);
+// Queries against asteroid positions; results go to caller buffers and nothing
+// is allocated. QueryNearest writes up to k hits within range, nearest first
+// (equal distances: higher dense index first) and returns how many it wrote.
+// QueryRadius/QueryRect return the number of matches but write at most
+// max_handles of them.
+int Asteroids_QueryNearest(const AsteroidSystem *system, Vector2 position, float range, int k,
+                           AsteroidHandle *out_handles, float *out_dist_sq);
+int Asteroids_QueryRadius(const AsteroidSystem *system, Vector2 position, float radius,
+                          AsteroidHandle *out_handles, int max_handles);
+int Asteroids_QueryRect(const AsteroidSystem *system, Rectangle rect, AsteroidHandle *out_handles, int max_handles);
+// First solid mask pixel along origin + dir * t for t in [0, max_dist] (dir
+// need not be normalised; distance is in world units). Returns 0 on a miss.
+int Asteroids_Raycast(const AsteroidSystem *system, Vector2 origin, Vector2 dir, float max_dist, AsteroidRayHit *out_hit);
+// Returns 1 if the damage destroyed the asteroid (the handle is then stale);
+// a destroyed sector rock is recorded as mined and does not come back. A
+// destroyed whole rock breaks into its fragments: new asteroids from its
+// asset's fracture table, at its scale, moving with it plus an outward kick,
+// with its origin (they leave with its sector) and hit points by area share.
+// Fragments do not break further. They join the Asteroids_Query* index at
+// the next update.
+int Asteroids_ApplyDamage(AsteroidSystem *system, AsteroidHandle handle, float damage);
 void Asteroids_AddPopup(AsteroidSystem *system, Vector2 position, float value);
-int Asteroids_GetInfo(const AsteroidSystem *system, int index, Vector2 *out_pos, float *out_radius);
+// Reports the centre and radius of the asteroid's tight enclosing circle
+// (not the sprite centre / half-extent).
+int Asteroids_GetInfo(const AsteroidSystem *system, AsteroidHandle handle, Vector2 *out_pos, float *out_radius);
+int Asteroids_GetHealth(const AsteroidSystem *system, AsteroidHandle handle, float *out_hp, float *out_hp_max);
+// Bytes of array data behind a state with these lengths.
+size_t Asteroids_StateArraySize(const AsteroidState *state);
+// Fills state and writes the arrays (Asteroids_StateArraySize(state) bytes)
+// to arrays: the component columns, the pool's slot tables, the popups and
+// the sector map (active sectors and mined records; pending sectors are
+// regenerated on load).
+void Asteroids_SaveState(const AsteroidSystem *system, AsteroidState *state, unsigned char *arrays);
+// Replaces the simulated state with a saved one; assets and allocations are
+// kept (and grown if needed), the query index is rebuilt. Returns 0 if the
+// arrays cannot be allocated or refer to an asset this system lacks.
+int Asteroids_LoadState(AsteroidSystem *system, const AsteroidState *state, const unsigned char *arrays);
 void Asteroids_Unload(AsteroidSystem *system);
 
 #endif
@@ -0,0 +1,226 @@
+#include "bitmask.h"
+
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+int BitMask_Alloc(BitMask *mask, int width, int height)
+{
+    *mask = (BitMask){0};
+    if (width <= 0 || height <= 0) return 0;
+
+    int words = (width + 63) / 64;
+    uint64_t *bits = (uint64_t *)calloc((size_t)words * (size_t)height, sizeof(uint64_t));
+    if (bits == NULL) return 0;
+
+    mask->width = width;
+    mask->height = height;
+    mask->words_per_row = words;
+    mask->bits = bits;
+    mask->min_x = width;
+    mask->min_y = height;
+    mask->max_x = -1;
+    mask->max_y = -1;
+    return 1;
+}
+
+void BitMask_UpdateBounds(BitMask *mask)
+{
+    mask->min_x = mask->width;
+    mask->min_y = mask->height;
+    mask->max_x = -1;
+    mask->max_y = -1;
+    for (int y = 0; y < mask->height; y++)
+    {
+        const uint64_t *row = mask->bits + (size_t)y * (size_t)mask->words_per_row;
+        for (int w = 0; w < mask->words_per_row; w++)
+        {
+            uint64_t word = row[w];
+            if (word == 0) continue;
+            int lo = w * 64 + __builtin_ctzll(word);
+            int hi = w * 64 + 63 - __builtin_clzll(word);
+            if (lo < mask->min_x) mask->min_x = lo;
+            if (hi > mask->max_x) mask->max_x = hi;
+            if (y < mask->min_y) mask->min_y = y;
+            mask->max_y = y;
+        }
+    }
+}
+
+int BitMask_Build(BitMask *mask, const unsigned char *alpha, int width, int height,
+                  int pixel_stride, int row_stride, unsigned char threshold, float scale)
+{
+    *mask = (BitMask){0};
+    if (width <= 0 || height <= 0 || scale <= 0.0f) return 0;
+
+    int out_w = (int)(width * scale + 0.5f);
+    int out_h = (int)(height * scale + 0.5f);
+    if (out_w < 1) out_w = 1;
+    if (out_h < 1) out_h = 1;
+
+    if (!BitMask_Alloc(mask, out_w, out_h)) return 0;
+    int words = mask->words_per_row;
+    uint64_t *bits = mask->bits;
+
+    float inv_scale = 1.0f / scale;
+    for (int y = 0; y < out_h; y++)
+    {
+        int sy = (int)((y + 0.5f) * inv_scale);
+        if (sy >= height) sy = height - 1;
+        const unsigned char *src_row = alpha + (size_t)sy * (size_t)row_stride;
+        uint64_t *dst_row = bits + (size_t)y * (size_t)words;
+        for (int x = 0; x < out_w; x++)
+        {
+            int sx = (int)((x + 0.5f) * inv_scale);
+            if (sx >= width) sx = width - 1;
+            if (src_row[(size_t)sx * (size_t)pixel_stride] >= threshold)
+            {
+                dst_row[x >> 6] |= 1ull << (x & 63);
+            }
+        }
+    }
+
+    BitMask_UpdateBounds(mask);
+    return 1;
+}
+
+void BitMask_Free(BitMask *mask)
+{
+    free(mask->bits);
+    *mask = (BitMask){0};
+}
+
+size_t BitMask_Bytes(const BitMask *mask)
+{
+    return (size_t)mask->words_per_row * (size_t)mask->height * sizeof(uint64_t);
+}
+
+// One A-space word worth of B bits, starting at B bit (w * 64 + offset_x).
+// q/r are the word index and bit shift; lo_ok/hi_ok say whether words q and
+// q + 1 exist in B's row (missing words read as empty).
+typedef struct ShiftedFetch
+{
+    int q;
+    int r;
+    int lo_ok;
+    int hi_ok;
+} ShiftedFetch;
+
+static inline ShiftedFetch MakeFetch(int bit, int words)
+{
+    // bit >= -63 here, so bias by one word to keep the shift non-negative.
+    ShiftedFetch fetch;
+    fetch.q = ((bit + 64) >> 6) - 1;
+    fetch.r = (bit + 64) & 63;
+    fetch.lo_ok = (unsigned int)fetch.q < (unsigned int)words;
+    fetch.hi_ok = (unsigned int)(fetch.q + 1) < (unsigned int)words;
+    return fetch;
+}
+
+static inline uint64_t FetchWord(const uint64_t *row, const ShiftedFetch *fetch)
+{
+    uint64_t lo = fetch->lo_ok ? row[fetch->q] : 0;
+    uint64_t hi = fetch->hi_ok ? row[fetch->q + 1] : 0;
+    if (fetch->r == 0) return lo;
+    return (lo >> fetch->r) | (hi << (64 - fetch->r));
+}
+
+int BitMask_Overlap(const BitMask *a, const BitMask *b, int offset_x, int offset_y)
+{
+    int y0 = (a->min_y > b->min_y - offset_y) ? a->min_y : (b->min_y - offset_y);
+    int y1 = (a->max_y < b->max_y - offset_y) ? (a->max_y + 1) : (b->max_y + 1 - offset_y);
+    int x0 = (a->min_x > b->min_x - offset_x) ? a->min_x : (b->min_x - offset_x);
+    int x1 = (a->max_x < b->max_x - offset_x) ? (a->max_x + 1) : (b->max_x + 1 - offset_x);
+    if (y0 >= y1 || x0 >= x1) return 0;
+
+    int w0 = x0 >> 6;
+    int w1 = (x1 - 1) >> 6;
+    uint64_t first_mask = ~0ull << (x0 & 63);
+    uint64_t last_mask = ((x1 & 63) != 0) ? (~0ull >> (64 - (x1 & 63))) : ~0ull;
+    int wa = a->words_per_row;
+    int wb = b->words_per_row;
+
+    for (int w = w0; w <= w1; w++)
+    {
+        uint64_t edge = ~0ull;
+        if (w == w0) edge &= first_mask;
+        if (w == w1) edge &= last_mask;
+        ShiftedFetch fetch = MakeFetch(w * 64 + offset_x, wb);
+        if (!fetch.lo_ok && !fetch.hi_ok) continue;
+
+        const uint64_t *a_col = a->bits + (size_t)y0 * (size_t)wa + w;
+        const uint64_t *b_col = b->bits + (size_t)(y0 + offset_y) * (size_t)wb;
+        int y = y0;
+
+        // The shift is the same for every row of a column word, so several
+        // rows are tested per instruction.
+#if defined(__AVX2__)
+        const __m256i a_index = _mm256_set_epi64x(3LL * wa, 2LL * wa, wa, 0);
+        const __m256i b_index = _mm256_set_epi64x(3LL * wb, 2LL * wb, wb, 0);
+        const __m256i edge4 = _mm256_set1_epi64x((long long)edge);
+        const __m128i shift_lo = _mm_cvtsi32_si128(fetch.r);
+        const __m128i shift_hi = _mm_cvtsi32_si128(64 - fetch.r);
+        for (; y + 4 <= y1; y += 4)
+        {
+            __m256i av = _mm256_i64gather_epi64((const long long *)a_col, a_index, 8);
+            av = _mm256_and_si256(av, edge4);
+            if (_mm256_testz_si256(av, av))
+            {
+                a_col += 4 * (size_t)wa;
+                b_col += 4 * (size_t)wb;
+                continue;
+            }
+            __m256i lo = fetch.lo_ok ? _mm256_i64gather_epi64((const long long *)(b_col + fetch.q), b_index, 8) : _mm256_setzero_si256();
+            __m256i hi = fetch.hi_ok ? _mm256_i64gather_epi64((const long long *)(b_col + fetch.q + 1), b_index, 8) : _mm256_setzero_si256();
+            __m256i bv = _mm256_or_si256(_mm256_srl_epi64(lo, shift_lo), _mm256_sll_epi64(hi, shift_hi));
+            if (!_mm256_testz_si256(av, bv)) return 1;
+            a_col += 4 * (size_t)wa;
+            b_col += 4 * (size_t)wb;
+        }
+#elif defined(__SSE2__)
+        const __m128i edge2 = _mm_set1_epi64x((long long)edge);
+        const __m128i shift_lo = _mm_cvtsi32_si128(fetch.r);
+        const __m128i shift_hi = _mm_cvtsi32_si128(64 - fetch.r);
+        const __m128i zero = _mm_setzero_si128();
+        for (; y + 2 <= y1; y += 2)
+        {
+            __m128i av = _mm_and_si128(_mm_set_epi64x((long long)a_col[wa], (long long)a_col[0]), edge2);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(av, zero)) != 0xFFFF)
+            {
+                __m128i lo = fetch.lo_ok ? _mm_set_epi64x((long long)b_col[wb + fetch.q], (long long)b_col[fetch.q]) : zero;
+                __m128i hi = fetch.hi_ok ? _mm_set_epi64x((long long)b_col[wb + fetch.q + 1], (long long)b_col[fetch.q + 1]) : zero;
+                __m128i bv = _mm_or_si128(_mm_srl_epi64(lo, shift_lo), _mm_sll_epi64(hi, shift_hi));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(av, bv), zero)) != 0xFFFF) return 1;
+            }
+            a_col += 2 * (size_t)wa;
+            b_col += 2 * (size_t)wb;
+        }
+#endif
+        for (; y < y1; y++)
+        {
+            uint64_t bits = *a_col & edge;
+            if (bits != 0 && (bits & FetchWord(b_col, &fetch)) != 0) return 1;
+            a_col += wa;
+            b_col += wb;
+        }
+    }
+
+    return 0;
+}
+
+int BitMask_OverlapReference(const BitMask *a, const BitMask *b, int offset_x, int offset_y)
+{
+    for (int y = 0; y < a->height; y++)
+    {
+        for (int x = 0; x < a->width; x++)
+        {
+            if (!BitMask_Test(a, x, y)) continue;
+            if (BitMask_Test(b, x + offset_x, y + offset_y)) return 1;
+        }
+    }
+    return 0;
+}
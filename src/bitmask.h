@@ -0,0 +1,54 @@
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 1-bit collision mask stored as 64-bit row bitsets (bit x of a row lives in
+// word x / 64 at bit x % 64). Masks are baked at a fixed scale so two masks
+// line up on the same world-pixel grid and overlap reduces to AND-ing
+// shifted row words.
+typedef struct BitMask
+{
+    int width;
+    int height;
+    int words_per_row;
+    uint64_t *bits;
+    // Tight bounds of the set bits (inclusive); min > max when empty.
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+} BitMask;
+
+// Bakes a mask from an alpha channel (alpha[y * row_stride + x * pixel_stride])
+// resampled to round(width * scale) x round(height * scale) with nearest
+// sampling. Returns 0 on allocation failure.
+int BitMask_Build(BitMask *mask, const unsigned char *alpha, int width, int height,
+                  int pixel_stride, int row_stride, unsigned char threshold, float scale);
+int BitMask_Alloc(BitMask *mask, int width, int height);
+void BitMask_UpdateBounds(BitMask *mask);
+void BitMask_Free(BitMask *mask);
+size_t BitMask_Bytes(const BitMask *mask);
+
+static inline void BitMask_Set(BitMask *mask, int x, int y)
+{
+    mask->bits[y * mask->words_per_row + (x >> 6)] |= 1ull << (x & 63);
+}
+
+static inline int BitMask_Test(const BitMask *mask, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= mask->width || y >= mask->height) return 0;
+    return (int)((mask->bits[y * mask->words_per_row + (x >> 6)] >> (x & 63)) & 1u);
+}
+
+// Returns 1 if any solid pixel (x, y) of a has a solid pixel (x + offset_x,
+// y + offset_y) in b. Only the intersection of the two tight bounds is
+// scanned; uses AVX2/SSE2 row-parallel ANDs where available.
+int BitMask_Overlap(const BitMask *a, const BitMask *b, int offset_x, int offset_y);
+
+// Pixel-by-pixel version of BitMask_Overlap, kept as the reference the
+// word-parallel path must match exactly.
+int BitMask_OverlapReference(const BitMask *a, const BitMask *b, int offset_x, int offset_y);
+
+#endif
@@ -0,0 +1,17 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "clock.h"
+
+#include <time.h>
+
+uint64_t Clock_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+double Clock_NowSeconds(void)
+{
+    return (double)Clock_NowNs() * 1e-9;
+}
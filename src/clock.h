@@ -0,0 +1,11 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+// Monotonic high-resolution clock that works without a window (raylib's
+// GetTime() needs InitWindow), used by headless runs and benchmarks.
+uint64_t Clock_NowNs(void);
+double Clock_NowSeconds(void);
+
+#endif
@@ -0,0 +1,641 @@
+#include "collision_shape.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// Stands in for "no seed pixel" in the distance transform.
+#define COLLISION_SDF_FAR 1e20
+#define COLLISION_TWO_PI 6.28318530718f
+
+typedef struct CirclePoint
+{
+    double x;
+    double y;
+} CirclePoint;
+
+typedef struct Circle
+{
+    double x;
+    double y;
+    double r;
+} Circle;
+
+static int FloorDiv(int value, int divisor)
+{
+    return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+static int InCircle(const Circle *c, CirclePoint p)
+{
+    double dx = p.x - c->x;
+    double dy = p.y - c->y;
+    return dx * dx + dy * dy <= c->r * c->r * (1.0 + 1e-9) + 1e-9;
+}
+
+static Circle CircleFrom2(CirclePoint a, CirclePoint b)
+{
+    Circle c;
+    c.x = 0.5 * (a.x + b.x);
+    c.y = 0.5 * (a.y + b.y);
+    c.r = 0.5 * sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y));
+    return c;
+}
+
+static Circle CircleFrom3(CirclePoint a, CirclePoint b, CirclePoint c)
+{
+    double bx = b.x - a.x;
+    double by = b.y - a.y;
+    double cx = c.x - a.x;
+    double cy = c.y - a.y;
+    double d = 2.0 * (bx * cy - by * cx);
+    if (fabs(d) < 1e-12)
+    {
+        // Collinear: the circle on the farthest pair covers all three.
+        Circle ab = CircleFrom2(a, b);
+        Circle ac = CircleFrom2(a, c);
+        Circle bc = CircleFrom2(b, c);
+        if (ab.r >= ac.r && ab.r >= bc.r) return ab;
+        return (ac.r >= bc.r) ? ac : bc;
+    }
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+    Circle result;
+    result.x = a.x + (cy * b2 - by * c2) / d;
+    result.y = a.y + (bx * c2 - cx * b2) / d;
+    result.r = sqrt((result.x - a.x) * (result.x - a.x) + (result.y - a.y) * (result.y - a.y));
+    return result;
+}
+
+// Welzl's minimal enclosing circle (iterative form) over the centres of the
+// mask's boundary pixels; a fixed shuffle keeps expected O(n) and makes the
+// result reproducible.
+static void ComputeEnclosingCircle(CollisionShape *shape)
+{
+    const BitMask *mask = &shape->fine;
+    shape->circle_x = 0.5f * (float)mask->width;
+    shape->circle_y = 0.5f * (float)mask->height;
+    shape->circle_radius = 0.0f;
+    if (mask->max_x < mask->min_x) return;
+
+    int capacity = 2 * (mask->width + mask->height) + 64;
+    int count = 0;
+    CirclePoint *points = (CirclePoint *)malloc((size_t)capacity * sizeof(CirclePoint));
+    if (points == NULL) return;
+
+    for (int y = mask->min_y; y <= mask->max_y; y++)
+    {
+        for (int x = mask->min_x; x <= mask->max_x; x++)
+        {
+            if (!BitMask_Test(mask, x, y)) continue;
+            if (BitMask_Test(mask, x - 1, y) && BitMask_Test(mask, x + 1, y) &&
+                BitMask_Test(mask, x, y - 1) && BitMask_Test(mask, x, y + 1)) continue;
+            if (count >= capacity)
+            {
+                CirclePoint *grown = (CirclePoint *)realloc(points, (size_t)capacity * 2 * sizeof(CirclePoint));
+                if (grown == NULL)
+                {
+                    free(points);
+                    return;
+                }
+                points = grown;
+                capacity *= 2;
+            }
+            points[count].x = x + 0.5;
+            points[count].y = y + 0.5;
+            count++;
+        }
+    }
+
+    if (count == 0)
+    {
+        free(points);
+        return;
+    }
+
+    unsigned int state = 0x9e3779b9u;
+    for (int i = count - 1; i > 0; i--)
+    {
+        state = state * 1664525u + 1013904223u;
+        int j = (int)((state >> 8) % (unsigned int)(i + 1));
+        CirclePoint tmp = points[i];
+        points[i] = points[j];
+        points[j] = tmp;
+    }
+
+    Circle c = { points[0].x, points[0].y, 0.0 };
+    for (int i = 1; i < count; i++)
+    {
+        if (InCircle(&c, points[i])) continue;
+        c = (Circle){ points[i].x, points[i].y, 0.0 };
+        for (int j = 0; j < i; j++)
+        {
+            if (InCircle(&c, points[j])) continue;
+            c = CircleFrom2(points[i], points[j]);
+            for (int k = 0; k < j; k++)
+            {
+                if (InCircle(&c, points[k])) continue;
+                c = CircleFrom3(points[i], points[j], points[k]);
+            }
+        }
+    }
+    free(points);
+
+    // Grow by half a pixel diagonal so the circle covers whole pixels, not
+    // just their centres.
+    shape->circle_x = (float)c.x;
+    shape->circle_y = (float)c.y;
+    shape->circle_radius = (float)c.r + 0.7072f;
+}
+
+static void FreeLevel(CollisionLevel *level)
+{
+    BitMask_Free(&level->any);
+    BitMask_Free(&level->any_dilated);
+    BitMask_Free(&level->all);
+}
+
+static int BuildLevel(CollisionLevel *level, const BitMask *fine, int block)
+{
+    *level = (CollisionLevel){0};
+    level->block = block;
+    int cw = (fine->width + block - 1) / block;
+    int ch = (fine->height + block - 1) / block;
+
+    int *counts = (int *)calloc((size_t)cw * (size_t)ch, sizeof(int));
+    if (counts == NULL) return 0;
+    if (!BitMask_Alloc(&level->any, cw, ch) ||
+        !BitMask_Alloc(&level->any_dilated, cw + 1, ch + 1) ||
+        !BitMask_Alloc(&level->all, cw, ch))
+    {
+        free(counts);
+        FreeLevel(level);
+        return 0;
+    }
+
+    for (int y = fine->min_y; y <= fine->max_y; y++)
+    {
+        for (int x = fine->min_x; x <= fine->max_x; x++)
+        {
+            if (BitMask_Test(fine, x, y)) counts[(y / block) * cw + (x / block)]++;
+        }
+    }
+
+    for (int by = 0; by < ch; by++)
+    {
+        for (int bx = 0; bx < cw; bx++)
+        {
+            int count = counts[by * cw + bx];
+            if (count == 0) continue;
+            BitMask_Set(&level->any, bx, by);
+            BitMask_Set(&level->any_dilated, bx, by);
+            BitMask_Set(&level->any_dilated, bx + 1, by);
+            BitMask_Set(&level->any_dilated, bx, by + 1);
+            BitMask_Set(&level->any_dilated, bx + 1, by + 1);
+            // Edge blocks that hang off the mask are never "all solid".
+            if (count == block * block) BitMask_Set(&level->all, bx, by);
+        }
+    }
+    free(counts);
+
+    BitMask_UpdateBounds(&level->any);
+    BitMask_UpdateBounds(&level->any_dilated);
+    BitMask_UpdateBounds(&level->all);
+    return 1;
+}
+
+// Felzenszwalb-Huttenlocher squared distance transform of the n values
+// stride apart at f, in place: f[q] = min over p of f[p] + (q - p)^2. The
+// scratch arrays hold n (values, v) and n + 1 (z) entries.
+static void DistanceTransform1D(double *f, int n, int stride, double *values, int *v, double *z)
+{
+    for (int i = 0; i < n; i++) values[i] = f[i * stride];
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INFINITY;
+    z[1] = INFINITY;
+    for (int q = 1; q < n; q++)
+    {
+        double s;
+        for (;;)
+        {
+            int p = v[k];
+            s = ((values[q] + (double)q * q) - (values[p] + (double)p * p)) / (2.0 * (q - p));
+            if (s > z[k]) break;
+            k--;
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INFINITY;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k + 1] < q) k++;
+        double d = (double)(q - v[k]);
+        f[q * stride] = d * d + values[v[k]];
+    }
+}
+
+static void DistanceTransform2D(double *f, int width, int height, double *values, int *v, double *z)
+{
+    for (int x = 0; x < width; x++) DistanceTransform1D(f + x, height, width, values, v, z);
+    for (int y = 0; y < height; y++) DistanceTransform1D(f + y * width, width, 1, values, v, z);
+}
+
+// Exact Euclidean distances between pixel centres: a solid pixel's distance
+// to the nearest empty one and vice versa, each less half a pixel so the
+// outline sits midway between them.
+static int BuildDistanceField(CollisionShape *shape)
+{
+    const BitMask *mask = &shape->fine;
+    if (mask->max_x < mask->min_x) return 1;
+
+    int x0 = mask->min_x - COLLISION_SDF_MARGIN;
+    int y0 = mask->min_y - COLLISION_SDF_MARGIN;
+    int width = mask->max_x - mask->min_x + 1 + 2 * COLLISION_SDF_MARGIN;
+    int height = mask->max_y - mask->min_y + 1 + 2 * COLLISION_SDF_MARGIN;
+    size_t cells = (size_t)width * (size_t)height;
+    int n = (width > height) ? width : height;
+
+    double *to_solid = (double *)malloc(cells * sizeof(double));
+    double *to_empty = (double *)malloc(cells * sizeof(double));
+    double *values = (double *)malloc((size_t)n * sizeof(double));
+    double *z = (double *)malloc((size_t)(n + 1) * sizeof(double));
+    int *v = (int *)malloc((size_t)n * sizeof(int));
+    shape->sdf = (int16_t *)malloc(cells * sizeof(int16_t));
+    int ok = to_solid != NULL && to_empty != NULL && values != NULL && z != NULL && v != NULL && shape->sdf != NULL;
+    if (ok)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                int solid = BitMask_Test(mask, x0 + x, y0 + y);
+                to_solid[y * width + x] = solid ? 0.0 : COLLISION_SDF_FAR;
+                to_empty[y * width + x] = solid ? COLLISION_SDF_FAR : 0.0;
+            }
+        }
+        DistanceTransform2D(to_solid, width, height, values, v, z);
+        DistanceTransform2D(to_empty, width, height, values, v, z);
+        for (size_t i = 0; i < cells; i++)
+        {
+            double distance = (to_empty[i] > 0.0) ? 0.5 - sqrt(to_empty[i]) : sqrt(to_solid[i]) - 0.5;
+            double units = floor(distance * COLLISION_SDF_UNIT + 0.5);
+            if (units > INT16_MAX) units = INT16_MAX;
+            if (units < INT16_MIN) units = INT16_MIN;
+            shape->sdf[i] = (int16_t)units;
+        }
+        shape->sdf_x = x0;
+        shape->sdf_y = y0;
+        shape->sdf_width = width;
+        shape->sdf_height = height;
+    }
+    else
+    {
+        free(shape->sdf);
+        shape->sdf = NULL;
+    }
+    free(to_solid);
+    free(to_empty);
+    free(values);
+    free(z);
+    free(v);
+    return ok;
+}
+
+// Area, and per angular sector around the centroid the boundary pixel
+// farthest from it (first in scan order on ties).
+static void BuildOutline(CollisionShape *shape)
+{
+    const BitMask *mask = &shape->fine;
+    double sum_x = 0.0;
+    double sum_y = 0.0;
+    shape->area = 0;
+    for (int y = mask->min_y; y <= mask->max_y; y++)
+    {
+        for (int x = mask->min_x; x <= mask->max_x; x++)
+        {
+            if (!BitMask_Test(mask, x, y)) continue;
+            shape->area++;
+            sum_x += x + 0.5;
+            sum_y += y + 0.5;
+        }
+    }
+    shape->outline_count = 0;
+    if (shape->area == 0) return;
+    float center_x = (float)(sum_x / shape->area);
+    float center_y = (float)(sum_y / shape->area);
+
+    float best[COLLISION_SHAPE_OUTLINE];
+    float best_x[COLLISION_SHAPE_OUTLINE];
+    float best_y[COLLISION_SHAPE_OUTLINE];
+    for (int s = 0; s < COLLISION_SHAPE_OUTLINE; s++) best[s] = -1.0f;
+    for (int y = mask->min_y; y <= mask->max_y; y++)
+    {
+        for (int x = mask->min_x; x <= mask->max_x; x++)
+        {
+            if (!BitMask_Test(mask, x, y)) continue;
+            if (BitMask_Test(mask, x - 1, y) && BitMask_Test(mask, x + 1, y) &&
+                BitMask_Test(mask, x, y - 1) && BitMask_Test(mask, x, y + 1)) continue;
+            float px = (float)x + 0.5f;
+            float py = (float)y + 0.5f;
+            float dx = px - center_x;
+            float dy = py - center_y;
+            int sector = (int)((atan2f(dy, dx) / COLLISION_TWO_PI + 0.5f) * COLLISION_SHAPE_OUTLINE);
+            if (sector < 0) sector = 0;
+            if (sector >= COLLISION_SHAPE_OUTLINE) sector = COLLISION_SHAPE_OUTLINE - 1;
+            float dist_sq = dx * dx + dy * dy;
+            if (dist_sq <= best[sector]) continue;
+            best[sector] = dist_sq;
+            best_x[sector] = px;
+            best_y[sector] = py;
+        }
+    }
+
+    for (int s = 0; s < COLLISION_SHAPE_OUTLINE; s++)
+    {
+        if (best[s] < 0.0f) continue;
+        shape->outline_x[shape->outline_count] = best_x[s];
+        shape->outline_y[shape->outline_count] = best_y[s];
+        shape->outline_count++;
+    }
+}
+
+int CollisionShape_Build(CollisionShape *shape, const unsigned char *alpha, int width, int height,
+                         int pixel_stride, int row_stride, unsigned char threshold, float scale)
+{
+    static const int blocks[COLLISION_SHAPE_LEVELS] = { COLLISION_SHAPE_BLOCK_COARSE, COLLISION_SHAPE_BLOCK_FINE };
+
+    *shape = (CollisionShape){0};
+    if (!BitMask_Build(&shape->fine, alpha, width, height, pixel_stride, row_stride, threshold, scale)) return 0;
+
+    for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+    {
+        if (!BuildLevel(&shape->levels[l], &shape->fine, blocks[l]))
+        {
+            CollisionShape_Free(shape);
+            return 0;
+        }
+    }
+
+    ComputeEnclosingCircle(shape);
+    BuildOutline(shape);
+    if (!BuildDistanceField(shape))
+    {
+        CollisionShape_Free(shape);
+        return 0;
+    }
+    return 1;
+}
+
+void CollisionShape_Free(CollisionShape *shape)
+{
+    BitMask_Free(&shape->fine);
+    for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+    {
+        FreeLevel(&shape->levels[l]);
+    }
+    free(shape->sdf);
+    shape->sdf = NULL;
+}
+
+size_t CollisionShape_Bytes(const CollisionShape *shape)
+{
+    size_t bytes = BitMask_Bytes(&shape->fine);
+    for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+    {
+        bytes += BitMask_Bytes(&shape->levels[l].any);
+        bytes += BitMask_Bytes(&shape->levels[l].any_dilated);
+        bytes += BitMask_Bytes(&shape->levels[l].all);
+    }
+    if (shape->sdf != NULL) bytes += (size_t)shape->sdf_width * (size_t)shape->sdf_height * sizeof(int16_t);
+    return bytes;
+}
+
+int CollisionShape_Overlap(const CollisionShape *a, const CollisionShape *b, int offset_x, int offset_y,
+                           CollisionShapeStats *stats)
+{
+    if (stats != NULL) stats->tests++;
+
+    // A block i covers b pixels [i*B + offset, (i+1)*B + offset): blocks
+    // i + k and i + k + 1 of b with k = floor(offset / B). "any" against the
+    // dilated b can only reject; two "all" blocks at shift k always share at
+    // least one pixel, so they can only accept.
+    for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+    {
+        const CollisionLevel *la = &a->levels[l];
+        const CollisionLevel *lb = &b->levels[l];
+        int kx = FloorDiv(offset_x, la->block);
+        int ky = FloorDiv(offset_y, la->block);
+        if (!BitMask_Overlap(&la->any, &lb->any_dilated, kx + 1, ky + 1))
+        {
+            if (stats != NULL) stats->coarse_rejects++;
+            return 0;
+        }
+        if (BitMask_Overlap(&la->all, &lb->all, kx, ky))
+        {
+            if (stats != NULL) stats->coarse_accepts++;
+            return 1;
+        }
+    }
+
+    if (stats != NULL) stats->fine_tests++;
+    return BitMask_Overlap(&a->fine, &b->fine, offset_x, offset_y);
+}
+
+// Amanatides-Woo traversal state over a grid of square cells.
+typedef struct GridWalk
+{
+    int x;
+    int y;
+    int step_x;
+    int step_y;
+    float t;
+    float next_x;
+    float next_y;
+    float delta_x;
+    float delta_y;
+} GridWalk;
+
+static int ClampInt(int v, int lo, int hi)
+{
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+// Starts a walk at parameter t in the cell containing origin + dir * t,
+// clamped to [lo, hi] cells so rounding at an entry edge stays inside.
+static void GridWalk_Begin(GridWalk *walk, float ox, float oy, float dx, float dy, float t, float cell,
+                           int lo_x, int lo_y, int hi_x, int hi_y)
+{
+    walk->t = t;
+    walk->x = ClampInt((int)floorf((ox + dx * t) / cell), lo_x, hi_x);
+    walk->y = ClampInt((int)floorf((oy + dy * t) / cell), lo_y, hi_y);
+    walk->step_x = (dx > 0.0f) ? 1 : (dx < 0.0f) ? -1 : 0;
+    walk->step_y = (dy > 0.0f) ? 1 : (dy < 0.0f) ? -1 : 0;
+    walk->delta_x = (dx != 0.0f) ? cell / fabsf(dx) : INFINITY;
+    walk->delta_y = (dy != 0.0f) ? cell / fabsf(dy) : INFINITY;
+    walk->next_x = (dx > 0.0f) ? ((float)(walk->x + 1) * cell - ox) / dx
+                 : (dx < 0.0f) ? ((float)walk->x * cell - ox) / dx : INFINITY;
+    walk->next_y = (dy > 0.0f) ? ((float)(walk->y + 1) * cell - oy) / dy
+                 : (dy < 0.0f) ? ((float)walk->y * cell - oy) / dy : INFINITY;
+}
+
+// Parameter at which the ray leaves the current cell.
+static float GridWalk_Exit(const GridWalk *walk)
+{
+    return (walk->next_x < walk->next_y) ? walk->next_x : walk->next_y;
+}
+
+static void GridWalk_Step(GridWalk *walk)
+{
+    if (walk->next_x < walk->next_y)
+    {
+        walk->t = walk->next_x;
+        walk->x += walk->step_x;
+        walk->next_x += walk->delta_x;
+    }
+    else
+    {
+        walk->t = walk->next_y;
+        walk->y += walk->step_y;
+        walk->next_y += walk->delta_y;
+    }
+}
+
+// Clips origin + dir * t, t in [*t0, *t1], to the box [x0, x1] x [y0, y1].
+static int ClipRay(float ox, float oy, float dx, float dy, float x0, float y0, float x1, float y1,
+                   float *t0, float *t1)
+{
+    const float o[2] = { ox, oy };
+    const float d[2] = { dx, dy };
+    const float lo[2] = { x0, y0 };
+    const float hi[2] = { x1, y1 };
+    for (int axis = 0; axis < 2; axis++)
+    {
+        if (d[axis] == 0.0f)
+        {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return 0;
+            continue;
+        }
+        float ta = (lo[axis] - o[axis]) / d[axis];
+        float tb = (hi[axis] - o[axis]) / d[axis];
+        if (ta > tb)
+        {
+            float tmp = ta;
+            ta = tb;
+            tb = tmp;
+        }
+        if (ta > *t0) *t0 = ta;
+        if (tb < *t1) *t1 = tb;
+        if (*t0 > *t1) return 0;
+    }
+    return 1;
+}
+
+float CollisionShape_Raycast(const CollisionShape *shape, float origin_x, float origin_y,
+                             float dir_x, float dir_y, float max_t)
+{
+    const BitMask *fine = &shape->fine;
+    if (fine->max_x < fine->min_x || max_t < 0.0f) return -1.0f;
+
+    float t_begin = 0.0f;
+    float t_end = max_t;
+    if (!ClipRay(origin_x, origin_y, dir_x, dir_y, (float)fine->min_x, (float)fine->min_y,
+                 (float)(fine->max_x + 1), (float)(fine->max_y + 1), &t_begin, &t_end))
+    {
+        return -1.0f;
+    }
+
+    const CollisionLevel *level = &shape->levels[COLLISION_SHAPE_LEVELS - 1];
+    int block = level->block;
+    GridWalk outer;
+    GridWalk_Begin(&outer, origin_x, origin_y, dir_x, dir_y, t_begin, (float)block,
+                   fine->min_x / block, fine->min_y / block, fine->max_x / block, fine->max_y / block);
+
+    while (outer.t <= t_end)
+    {
+        if (outer.x < fine->min_x / block || outer.x > fine->max_x / block ||
+            outer.y < fine->min_y / block || outer.y > fine->max_y / block)
+        {
+            break;
+        }
+
+        float block_exit = GridWalk_Exit(&outer);
+        if (block_exit > t_end) block_exit = t_end;
+
+        if (BitMask_Test(&level->any, outer.x, outer.y))
+        {
+            int lo_x = outer.x * block;
+            int lo_y = outer.y * block;
+            GridWalk inner;
+            GridWalk_Begin(&inner, origin_x, origin_y, dir_x, dir_y, outer.t, 1.0f,
+                           lo_x, lo_y, lo_x + block - 1, lo_y + block - 1);
+            while (inner.t <= block_exit &&
+                   inner.x >= lo_x && inner.x < lo_x + block && inner.y >= lo_y && inner.y < lo_y + block)
+            {
+                if (BitMask_Test(fine, inner.x, inner.y)) return inner.t;
+                GridWalk_Step(&inner);
+            }
+        }
+        GridWalk_Step(&outer);
+    }
+    return -1.0f;
+}
+
+float CollisionShape_Distance(const CollisionShape *shape, float x, float y, float *normal_x, float *normal_y)
+{
+    *normal_x = 0.0f;
+    *normal_y = 0.0f;
+    if (shape->sdf == NULL)
+    {
+        float dx = x - shape->circle_x;
+        float dy = y - shape->circle_y;
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length > 0.0f)
+        {
+            *normal_x = dx / length;
+            *normal_y = dy / length;
+        }
+        return length - shape->circle_radius;
+    }
+
+    // Sample (i, j) sits at the centre of pixel (sdf_x + i, sdf_y + j).
+    // Off the field, the nearest point on it stands in, plus the way there.
+    int width = shape->sdf_width;
+    float gx = x - 0.5f - (float)shape->sdf_x;
+    float gy = y - 0.5f - (float)shape->sdf_y;
+    float cx = fminf(fmaxf(gx, 0.0f), (float)(width - 1));
+    float cy = fminf(fmaxf(gy, 0.0f), (float)(shape->sdf_height - 1));
+    int i = ClampInt((int)cx, 0, width - 2);
+    int j = ClampInt((int)cy, 0, shape->sdf_height - 2);
+    float fx = cx - (float)i;
+    float fy = cy - (float)j;
+    const int16_t *cell = shape->sdf + j * width + i;
+    float v00 = (float)cell[0];
+    float v10 = (float)cell[1];
+    float v01 = (float)cell[width];
+    float v11 = (float)cell[width + 1];
+    float top = v00 + (v10 - v00) * fx;
+    float bottom = v01 + (v11 - v01) * fx;
+    float distance = (top + (bottom - top) * fy) * (1.0f / COLLISION_SDF_UNIT);
+    float grad_x = (v10 - v00) + ((v11 - v01) - (v10 - v00)) * fy;
+    float grad_y = bottom - top;
+
+    float off_x = gx - cx;
+    float off_y = gy - cy;
+    float off = sqrtf(off_x * off_x + off_y * off_y);
+    if (off > 0.0f)
+    {
+        distance += off;
+        grad_x = off_x;
+        grad_y = off_y;
+    }
+    float length = sqrtf(grad_x * grad_x + grad_y * grad_y);
+    if (length > 0.0f)
+    {
+        *normal_x = grad_x / length;
+        *normal_y = grad_y / length;
+    }
+    return distance;
+}
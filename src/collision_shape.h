@@ -0,0 +1,90 @@
+#ifndef COLLISION_SHAPE_H
+#define COLLISION_SHAPE_H
+
+#include "bitmask.h"
+
+// Block sizes of the occupancy pyramid, coarsest first.
+#define COLLISION_SHAPE_LEVELS 2
+#define COLLISION_SHAPE_BLOCK_COARSE 32
+#define COLLISION_SHAPE_BLOCK_FINE 8
+// Distance field samples are in 1/COLLISION_SDF_UNIT pixel, over the mask's
+// tight bounds grown by COLLISION_SDF_MARGIN pixels on every side.
+#define COLLISION_SDF_UNIT 16
+#define COLLISION_SDF_MARGIN 4
+// Contact sample points on the outline, one per angular sector.
+#define COLLISION_SHAPE_OUTLINE 32
+
+// One pyramid level: per-block "any pixel solid" and "every pixel solid"
+// masks. `any_dilated` ORs each block with its left/top neighbours (one extra
+// row/column) so a block-aligned shift can conservatively cover the two
+// blocks an unaligned pixel shift straddles.
+typedef struct CollisionLevel
+{
+    int block;
+    BitMask any;
+    BitMask any_dilated;
+    BitMask all;
+} CollisionLevel;
+
+// Everything the narrowphase needs for one mask at one scale, baked at load:
+// the pixel mask (with tight bounds), a minimal enclosing circle of its solid
+// pixels, a coarse-to-fine occupancy pyramid, and for contacts a signed
+// distance field with a ring of outline points.
+typedef struct CollisionShape
+{
+    BitMask fine;
+    CollisionLevel levels[COLLISION_SHAPE_LEVELS];
+    float circle_x;
+    float circle_y;
+    float circle_radius;
+    // Solid pixels (the body's mass at unit density).
+    int area;
+    // Signed distance from each pixel centre to the outline (negative
+    // inside), row-major over [sdf_x, sdf_x + sdf_width) x [sdf_y, sdf_y +
+    // sdf_height) of mask pixels. NULL for an empty mask.
+    int16_t *sdf;
+    int sdf_x;
+    int sdf_y;
+    int sdf_width;
+    int sdf_height;
+    // Centre of the outermost boundary pixel in each of outline_count equal
+    // angular sectors around the centroid (empty sectors skipped).
+    float outline_x[COLLISION_SHAPE_OUTLINE];
+    float outline_y[COLLISION_SHAPE_OUTLINE];
+    int outline_count;
+} CollisionShape;
+
+typedef struct CollisionShapeStats
+{
+    int tests;
+    int coarse_rejects;
+    int coarse_accepts;
+    int fine_tests;
+} CollisionShapeStats;
+
+int CollisionShape_Build(CollisionShape *shape, const unsigned char *alpha, int width, int height,
+                         int pixel_stride, int row_stride, unsigned char threshold, float scale);
+void CollisionShape_Free(CollisionShape *shape);
+size_t CollisionShape_Bytes(const CollisionShape *shape);
+
+// Same contract as BitMask_Overlap on the fine masks (pixel (x, y) of a
+// against (x + offset_x, y + offset_y) of b), answered coarse-to-fine.
+// stats may be NULL.
+int CollisionShape_Overlap(const CollisionShape *a, const CollisionShape *b, int offset_x, int offset_y,
+                           CollisionShapeStats *stats);
+
+// First solid pixel of the fine mask along origin + dir * t, in mask pixel
+// space (pixel (x, y) covers [x, x + 1) x [y, y + 1)). Walks the finest
+// pyramid level's blocks, skipping empty ones, and steps pixels only inside
+// occupied blocks. Returns the entry t of the hit pixel in [0, max_t], or
+// -1 when nothing is hit. dir does not need to be normalised.
+float CollisionShape_Raycast(const CollisionShape *shape, float origin_x, float origin_y,
+                             float dir_x, float dir_y, float max_t);
+
+// Signed distance in pixels from (x, y), in mask pixel space, to the mask's
+// outline (negative inside), bilinear between the field's samples; points
+// off the field add their distance to it. normal_x/normal_y receive the unit
+// gradient, pointing out of the shape (0, 0 where it is flat). O(1).
+float CollisionShape_Distance(const CollisionShape *shape, float x, float y, float *normal_x, float *normal_y);
+
+#endif
@@ -0,0 +1,105 @@
+#include "entity_pool.h"
+
+#include <stdlib.h>
+
+#include "memory.h"
+
+#define ENTITY_POOL_MIN_CAPACITY 256
+
+void EntityPool_Init(EntityPool *pool)
+{
+    *pool = (EntityPool){0};
+}
+
+void EntityPool_Free(EntityPool *pool)
+{
+    free(pool->generations);
+    free(pool->slot_to_dense);
+    free(pool->dense_to_slot);
+    free(pool->free_slots);
+    *pool = (EntityPool){0};
+}
+
+int EntityPool_Reserve(EntityPool *pool, int needed)
+{
+    if (needed <= pool->dense_capacity && needed <= pool->slot_capacity) return 1;
+
+    // Slots and dense entries are 1:1 at peak, so all four arrays share a
+    // capacity; grow each from the same starting point.
+    int capacity = pool->slot_capacity;
+    int target = capacity;
+    if (!Memory_GrowArray((void **)&pool->generations, &target, needed, sizeof(uint32_t), ENTITY_POOL_MIN_CAPACITY)) return 0;
+    int grown = target;
+    target = capacity;
+    if (!Memory_GrowArray((void **)&pool->slot_to_dense, &target, grown, sizeof(int), ENTITY_POOL_MIN_CAPACITY)) return 0;
+    target = capacity;
+    if (!Memory_GrowArray((void **)&pool->dense_to_slot, &target, grown, sizeof(int), ENTITY_POOL_MIN_CAPACITY)) return 0;
+    target = capacity;
+    if (!Memory_GrowArray((void **)&pool->free_slots, &target, grown, sizeof(int), ENTITY_POOL_MIN_CAPACITY)) return 0;
+
+    pool->slot_capacity = grown;
+    pool->dense_capacity = grown;
+    return 1;
+}
+
+EntityHandle EntityPool_Create(EntityPool *pool)
+{
+    if (!EntityPool_Reserve(pool, pool->count + 1)) return ENTITY_HANDLE_NULL;
+
+    int slot;
+    if (pool->free_count > 0)
+    {
+        slot = pool->free_slots[--pool->free_count];
+    }
+    else
+    {
+        slot = pool->slot_count++;
+        pool->generations[slot] = 1u;
+    }
+
+    int dense = pool->count++;
+    pool->slot_to_dense[slot] = dense;
+    pool->dense_to_slot[dense] = slot;
+    return (EntityHandle){ (uint32_t)slot, pool->generations[slot] };
+}
+
+int EntityPool_Remove(EntityPool *pool, int dense)
+{
+    if (dense < 0 || dense >= pool->count) return -1;
+
+    int slot = pool->dense_to_slot[dense];
+    pool->generations[slot]++;
+    if (pool->generations[slot] == 0u) pool->generations[slot] = 1u;
+    pool->slot_to_dense[slot] = -1;
+    pool->free_slots[pool->free_count++] = slot;
+
+    int last = --pool->count;
+    if (dense == last) return -1;
+
+    int moved_slot = pool->dense_to_slot[last];
+    pool->dense_to_slot[dense] = moved_slot;
+    pool->slot_to_dense[moved_slot] = dense;
+    return last;
+}
+
+void EntityPool_Clear(EntityPool *pool)
+{
+    while (pool->count > 0)
+    {
+        EntityPool_Remove(pool, pool->count - 1);
+    }
+}
+
+int EntityPool_Resolve(const EntityPool *pool, EntityHandle handle)
+{
+    if (handle.generation == 0u || handle.index >= (uint32_t)pool->slot_count) return -1;
+    if (pool->generations[handle.index] != handle.generation) return -1;
+    return pool->slot_to_dense[handle.index];
+}
+
+EntityHandle EntityPool_HandleAt(const EntityPool *pool, int dense)
+{
+    if (dense < 0 || dense >= pool->count) return ENTITY_HANDLE_NULL;
+    int slot = pool->dense_to_slot[dense];
+    return (EntityHandle){ (uint32_t)slot, pool->generations[slot] };
+}
@@ -0,0 +1,56 @@
+#ifndef ENTITY_POOL_H
+#define ENTITY_POOL_H
+
+#include <stdint.h>
+
+// Stable reference to a pooled entity. The generation is bumped every time a
+// slot is freed, so a handle to a destroyed entity never resolves again, even
+// after the slot is reused. Generation 0 is never issued: a zeroed handle is null.
+typedef struct EntityHandle
+{
+    uint32_t index;
+    uint32_t generation;
+} EntityHandle;
+
+#define ENTITY_HANDLE_NULL ((EntityHandle){ 0u, 0u })
+
+// Maps handles to a dense, swap-removed component range [0, count). The pool
+// only owns the indirection; the owning system keeps its component arrays
+// sized to dense_capacity and moves the element EntityPool_Remove reports.
+// Slots come from a free list and capacity grows geometrically, so creating
+// an entity does not allocate once the pool has warmed up.
+typedef struct EntityPool
+{
+    uint32_t *generations;
+    int *slot_to_dense;
+    int *dense_to_slot;
+    int *free_slots;
+    int free_count;
+    int slot_count;
+    int slot_capacity;
+    int count;
+    int dense_capacity;
+} EntityPool;
+
+void EntityPool_Init(EntityPool *pool);
+void EntityPool_Free(EntityPool *pool);
+// Ensures room for `needed` live entities. Returns 0 on allocation failure.
+int EntityPool_Reserve(EntityPool *pool, int needed);
+// Appends a new entity at dense index pool->count - 1 and returns its handle;
+// returns ENTITY_HANDLE_NULL when the pool cannot grow.
+EntityHandle EntityPool_Create(EntityPool *pool);
+// Removes the entity at a dense index. Returns the dense index whose
+// components must be moved into `dense` (the old last element), or -1 when
+// nothing moves.
+int EntityPool_Remove(EntityPool *pool, int dense);
+void EntityPool_Clear(EntityPool *pool);
+// Dense index of a live handle, or -1 if it is null or stale.
+int EntityPool_Resolve(const EntityPool *pool, EntityHandle handle);
+EntityHandle EntityPool_HandleAt(const EntityPool *pool, int dense);
+
+static inline int EntityHandle_IsNull(EntityHandle handle)
+{
+    return handle.generation == 0u;
+}
+
+#endif
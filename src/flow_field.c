@@ -0,0 +1,486 @@
+#include "flow_field.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+// Neighbour steps: the four sides first, then the diagonals.
+static const int STEP_X[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int STEP_Y[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+static int StepCost(int k)
+{
+    return (k < 4) ? FLOW_FIELD_COST_STRAIGHT : FLOW_FIELD_COST_DIAGONAL;
+}
+
+// Neighbour k of cell (x, y) if the step to it is allowed: inside the grid,
+// onto a free cell, and for a diagonal past two free side cells. Steps are
+// symmetric, so the same test serves both directions. Returns -1 otherwise.
+static int Neighbour(const FlowField *field, int x, int y, int k)
+{
+    int nx = x + STEP_X[k];
+    int ny = y + STEP_Y[k];
+    if (nx < 0 || ny < 0 || nx >= field->width || ny >= field->height) return -1;
+    int n = ny * field->width + nx;
+    if (field->blocked[n]) return -1;
+    if (k >= 4 && (field->blocked[y * field->width + nx] || field->blocked[ny * field->width + x])) return -1;
+    return n;
+}
+
+static int GrowInts(int **data, int *capacity, int needed)
+{
+    return Memory_GrowArray((void **)data, capacity, needed, sizeof(int), 256);
+}
+
+// Queues a cell whose cost is already set as a starting point of the next
+// Settle.
+static int SeedPush(FlowField *field, int cell)
+{
+    if (!GrowInts(&field->seeds, &field->seed_capacity, field->seed_count + 1)) return 0;
+    field->seeds[field->seed_count++] = cell;
+    return 1;
+}
+
+// Counting sort of the seeds by cost into order (cost << 32 | cell), dropping
+// those whose cost was cleared since. Returns the count kept, or -1 if the
+// scratch could not grow.
+static int SortSeeds(FlowField *field)
+{
+    int32_t min_cost = FLOW_FIELD_UNREACHED;
+    int32_t max_cost = 0;
+    for (int i = 0; i < field->seed_count; i++)
+    {
+        int32_t cost = field->cost[field->seeds[i]];
+        if (cost == FLOW_FIELD_UNREACHED) continue;
+        if (cost < min_cost) min_cost = cost;
+        if (cost > max_cost) max_cost = cost;
+    }
+    if (min_cost > max_cost) return 0;
+    int range = (int)(max_cost - min_cost) + 1;
+    if (!GrowInts(&field->cost_counts, &field->cost_count_capacity, range + 1) ||
+        !Memory_GrowArray((void **)&field->order, &field->order_capacity, field->seed_count, sizeof(uint64_t), 256))
+    {
+        return -1;
+    }
+    int *counts = field->cost_counts;
+    memset(counts, 0, (size_t)(range + 1) * sizeof(int));
+    for (int i = 0; i < field->seed_count; i++)
+    {
+        int32_t cost = field->cost[field->seeds[i]];
+        if (cost != FLOW_FIELD_UNREACHED) counts[cost - min_cost + 1]++;
+    }
+    for (int c = 0; c < range; c++) counts[c + 1] += counts[c];
+    for (int i = 0; i < field->seed_count; i++)
+    {
+        int cell = field->seeds[i];
+        int32_t cost = field->cost[cell];
+        if (cost == FLOW_FIELD_UNREACHED) continue;
+        field->order[counts[cost - min_cost]++] = ((uint64_t)(uint32_t)cost << 32) | (uint32_t)cell;
+    }
+    return counts[range - 1];
+}
+
+// Queues a cell reached at cost, which lies within FLOW_FIELD_BUCKETS - 1
+// of the cost being settled, so its bucket holds nothing else.
+static int BucketPush(FlowField *field, int32_t cost, int cell)
+{
+    int b = cost % FLOW_FIELD_BUCKETS;
+    if (!Memory_GrowArray((void **)&field->buckets[b], &field->bucket_capacity[b], field->bucket_count[b] + 1,
+                          sizeof(int), 256))
+    {
+        return 0;
+    }
+    field->buckets[b][field->bucket_count[b]++] = cell;
+    return 1;
+}
+
+// Lowers the costs of the neighbours cell reaches at cost and queues them.
+// Returns how many were queued, or -1 if a bucket could not grow.
+static int Relax(FlowField *field, int cell, int32_t cost)
+{
+    int width = field->width;
+    int x = cell % width;
+    int y = cell / width;
+    int32_t *costs = field->cost;
+    int queued = 0;
+    if (x > 0 && y > 0 && x < width - 1 && y < field->height - 1)
+    {
+        // Inside the border: no bounds checks, each side tested once.
+        const unsigned char *blocked = field->blocked;
+        const int side[4] = { 1, -1, width, -width };
+        unsigned char open[4];
+        for (int k = 0; k < 4; k++)
+        {
+            int n = cell + side[k];
+            open[k] = !blocked[n];
+            if (!open[k] || cost + FLOW_FIELD_COST_STRAIGHT >= costs[n]) continue;
+            costs[n] = cost + FLOW_FIELD_COST_STRAIGHT;
+            if (!BucketPush(field, costs[n], n)) return -1;
+            queued++;
+        }
+        for (int k = 4; k < 8; k++)
+        {
+            int sx = (STEP_X[k] > 0) ? 0 : 1;
+            int sy = (STEP_Y[k] > 0) ? 2 : 3;
+            int n = cell + side[sx] + side[sy];
+            if (!open[sx] || !open[sy] || blocked[n] || cost + FLOW_FIELD_COST_DIAGONAL >= costs[n]) continue;
+            costs[n] = cost + FLOW_FIELD_COST_DIAGONAL;
+            if (!BucketPush(field, costs[n], n)) return -1;
+            queued++;
+        }
+        return queued;
+    }
+    for (int k = 0; k < 8; k++)
+    {
+        int n = Neighbour(field, x, y, k);
+        if (n < 0) continue;
+        int32_t next = cost + StepCost(k);
+        if (next >= costs[n]) continue;
+        costs[n] = next;
+        if (!BucketPush(field, next, n)) return -1;
+        queued++;
+    }
+    return queued;
+}
+
+// Settles everything reachable from the seeds in cost order: the seeds
+// sorted up front, the cells they reach from the buckets (Dial's algorithm:
+// every step costs less than FLOW_FIELD_BUCKETS, so the bucket of the cost
+// being settled holds nothing dearer). Entries whose cell has since been
+// reached cheaper are skipped. Returns 0 if the queue could not grow (the
+// costs are then incomplete).
+static int Settle(FlowField *field)
+{
+    int seed_count = SortSeeds(field);
+    field->seed_count = 0;
+    if (seed_count < 0) return 0;
+    int next_seed = 0;
+    int pending = 0;
+    int32_t current = 0;
+    for (;;)
+    {
+        int cell;
+        int32_t cost;
+        int b = current % FLOW_FIELD_BUCKETS;
+        if (next_seed < seed_count && (int32_t)(field->order[next_seed] >> 32) <= current)
+        {
+            uint64_t key = field->order[next_seed++];
+            cell = (int)(uint32_t)key;
+            cost = (int32_t)(key >> 32);
+        }
+        else if (field->bucket_count[b] > 0)
+        {
+            cell = field->buckets[b][--field->bucket_count[b]];
+            cost = current;
+            pending--;
+        }
+        else if (pending > 0)
+        {
+            current++;
+            continue;
+        }
+        else if (next_seed < seed_count)
+        {
+            current = (int32_t)(field->order[next_seed] >> 32);
+            continue;
+        }
+        else
+        {
+            return 1;
+        }
+        if (cost != field->cost[cell]) continue;
+        field->stats.settled_cells++;
+
+        int queued = Relax(field, cell, cost);
+        if (queued < 0)
+        {
+            for (int k = 0; k < FLOW_FIELD_BUCKETS; k++) field->bucket_count[k] = 0;
+            return 0;
+        }
+        pending += queued;
+    }
+}
+
+int FlowField_Init(FlowField *field, Vector2 goal, float cell_size, int width, int height)
+{
+    memset(field, 0, sizeof(*field));
+    if (cell_size <= 0.0f || width < 1 || height < 1) return 0;
+    width |= 1;
+    height |= 1;
+    size_t cells = (size_t)width * (size_t)height;
+    field->cost = (int32_t *)malloc(cells * sizeof(int32_t));
+    field->blocked = (unsigned char *)calloc(cells, 1);
+    field->next_blocked = (unsigned char *)calloc(cells, 1);
+    if (field->cost == NULL || field->blocked == NULL || field->next_blocked == NULL)
+    {
+        FlowField_Free(field);
+        return 0;
+    }
+    for (size_t i = 0; i < cells; i++) field->cost[i] = FLOW_FIELD_UNREACHED;
+    field->width = width;
+    field->height = height;
+    field->cell_size = cell_size;
+    field->inv_cell_size = 1.0f / cell_size;
+    field->goal = goal;
+    field->origin_x = goal.x - 0.5f * (float)width * cell_size;
+    field->origin_y = goal.y - 0.5f * (float)height * cell_size;
+    field->goal_cell = (height / 2) * width + width / 2;
+    return 1;
+}
+
+void FlowField_Free(FlowField *field)
+{
+    free(field->cost);
+    free(field->blocked);
+    free(field->next_blocked);
+    free(field->suspects);
+    free(field->cleared);
+    free(field->seeds);
+    free(field->order);
+    free(field->cost_counts);
+    for (int b = 0; b < FLOW_FIELD_BUCKETS; b++) free(field->buckets[b]);
+    memset(field, 0, sizeof(*field));
+}
+
+void FlowField_BeginObstacles(FlowField *field)
+{
+    memset(field->next_blocked, 0, (size_t)field->width * (size_t)field->height);
+}
+
+void FlowField_AddDisk(FlowField *field, float x, float y, float radius)
+{
+    // Cell (i, j) has its centre at origin + (i + 0.5, j + 0.5) * cell_size.
+    float gx = (x - field->origin_x) * field->inv_cell_size - 0.5f;
+    float gy = (y - field->origin_y) * field->inv_cell_size - 0.5f;
+    float gr = radius * field->inv_cell_size;
+    int min_y = (int)ceilf(gy - gr);
+    int max_y = (int)floorf(gy + gr);
+    if (min_y < 0) min_y = 0;
+    if (max_y > field->height - 1) max_y = field->height - 1;
+    for (int j = min_y; j <= max_y; j++)
+    {
+        float dy = (float)j - gy;
+        float span_sq = gr * gr - dy * dy;
+        if (span_sq < 0.0f) continue;
+        float span = sqrtf(span_sq);
+        int min_x = (int)ceilf(gx - span);
+        int max_x = (int)floorf(gx + span);
+        if (min_x < 0) min_x = 0;
+        if (max_x > field->width - 1) max_x = field->width - 1;
+        if (min_x <= max_x) memset(field->next_blocked + (size_t)j * field->width + min_x, 1, (size_t)(max_x - min_x + 1));
+    }
+}
+
+static int PushSuspects(FlowField *field, int cell)
+{
+    if (!GrowInts(&field->suspects, &field->suspect_capacity, field->suspect_count + 8)) return 0;
+    int x = cell % field->width;
+    int y = cell / field->width;
+    for (int k = 0; k < 8; k++)
+    {
+        int nx = x + STEP_X[k];
+        int ny = y + STEP_Y[k];
+        if (nx < 0 || ny < 0 || nx >= field->width || ny >= field->height) continue;
+        field->suspects[field->suspect_count++] = ny * field->width + nx;
+    }
+    return 1;
+}
+
+static int PushCleared(FlowField *field, int cell)
+{
+    if (!GrowInts(&field->cleared, &field->cleared_capacity, field->cleared_count + 1)) return 0;
+    field->cleared[field->cleared_count++] = cell;
+    return 1;
+}
+
+// A cost is supported while some allowed step leads to a neighbour whose
+// cost is exactly one step lower.
+static int Supported(const FlowField *field, int cell)
+{
+    int x = cell % field->width;
+    int y = cell / field->width;
+    for (int k = 0; k < 8; k++)
+    {
+        int n = Neighbour(field, x, y, k);
+        if (n >= 0 && field->cost[n] != FLOW_FIELD_UNREACHED && field->cost[n] + StepCost(k) == field->cost[cell])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int Rebuild(FlowField *field)
+{
+    int cells = field->width * field->height;
+    for (int i = 0; i < cells; i++) field->cost[i] = FLOW_FIELD_UNREACHED;
+    field->seed_count = 0;
+    field->cost[field->goal_cell] = 0;
+    field->stats.full_rebuilds++;
+    return SeedPush(field, field->goal_cell) && Settle(field);
+}
+
+// Incremental repair after the blocked cells changed (see flow_field.h).
+static int Repair(FlowField *field)
+{
+    int cells = field->width * field->height;
+    field->suspect_count = 0;
+    field->cleared_count = 0;
+    field->seed_count = 0;
+    for (int c = 0; c < cells; c++)
+    {
+        // Most of the grid is unchanged: skip it eight cells at a time.
+        if ((c & 7) == 0 && c + 8 <= cells)
+        {
+            uint64_t next;
+            uint64_t now;
+            memcpy(&next, field->next_blocked + c, sizeof(next));
+            memcpy(&now, field->blocked + c, sizeof(now));
+            if (next == now)
+            {
+                c += 7;
+                continue;
+            }
+        }
+        if (field->next_blocked[c] == field->blocked[c]) continue;
+        field->stats.changed_cells++;
+        field->blocked[c] = field->next_blocked[c];
+        if (field->blocked[c])
+        {
+            if (field->cost[c] == FLOW_FIELD_UNREACHED) continue;
+            field->cost[c] = FLOW_FIELD_UNREACHED;
+            if (!PushSuspects(field, c)) return 0;
+        }
+        else if (!PushCleared(field, c))
+        {
+            return 0;
+        }
+    }
+
+    // Freed cells may open diagonal steps past their corner, between two of
+    // their side neighbours, so those neighbours' costs spread again.
+    int freed = field->cleared_count;
+    for (int i = 0; i < freed; i++)
+    {
+        int x = field->cleared[i] % field->width;
+        int y = field->cleared[i] / field->width;
+        for (int k = 0; k < 4; k++)
+        {
+            int n = Neighbour(field, x, y, k);
+            if (n >= 0 && field->cost[n] != FLOW_FIELD_UNREACHED && !SeedPush(field, n)) return 0;
+        }
+    }
+
+    // Clear every cost that lost its support, outward from the change.
+    for (int i = 0; i < field->suspect_count; i++)
+    {
+        int cell = field->suspects[i];
+        if (cell == field->goal_cell || field->blocked[cell] || field->cost[cell] == FLOW_FIELD_UNREACHED) continue;
+        if (Supported(field, cell)) continue;
+        field->cost[cell] = FLOW_FIELD_UNREACHED;
+        field->stats.cleared_cells++;
+        if (!PushCleared(field, cell) || !PushSuspects(field, cell)) return 0;
+    }
+
+    // Seed the cleared cells from their intact neighbours, then settle.
+    for (int i = 0; i < field->cleared_count; i++)
+    {
+        int cell = field->cleared[i];
+        int x = cell % field->width;
+        int y = cell / field->width;
+        int32_t best = FLOW_FIELD_UNREACHED;
+        for (int k = 0; k < 8; k++)
+        {
+            int n = Neighbour(field, x, y, k);
+            if (n < 0 || field->cost[n] == FLOW_FIELD_UNREACHED) continue;
+            if (field->cost[n] + StepCost(k) < best) best = field->cost[n] + StepCost(k);
+        }
+        if (best >= field->cost[cell]) continue;
+        field->cost[cell] = best;
+        if (!SeedPush(field, cell)) return 0;
+    }
+    return Settle(field);
+}
+
+void FlowField_CommitObstacles(FlowField *field, int full_rebuild)
+{
+    field->stats = (FlowFieldStats){0};
+    field->next_blocked[field->goal_cell] = 0;
+    if (!field->built || full_rebuild)
+    {
+        int cells = field->width * field->height;
+        for (int c = 0; c < cells; c++) field->stats.changed_cells += field->blocked[c] != field->next_blocked[c];
+        memcpy(field->blocked, field->next_blocked, (size_t)cells);
+        field->built = Rebuild(field);
+        return;
+    }
+    // Out of memory mid-repair: the costs are inconsistent, so the next
+    // commit starts over.
+    field->built = Repair(field);
+}
+
+static int CellAt(const FlowField *field, float x, float y)
+{
+    float gx = (x - field->origin_x) * field->inv_cell_size;
+    float gy = (y - field->origin_y) * field->inv_cell_size;
+    if (!(gx >= 0.0f && gy >= 0.0f && gx < (float)field->width && gy < (float)field->height)) return -1;
+    return (int)gy * field->width + (int)gx;
+}
+
+int32_t FlowField_CostAt(const FlowField *field, float x, float y)
+{
+    int cell = CellAt(field, x, y);
+    return (cell >= 0) ? field->cost[cell] : FLOW_FIELD_UNREACHED;
+}
+
+int FlowField_BlockedAt(const FlowField *field, float x, float y)
+{
+    int cell = CellAt(field, x, y);
+    return (cell >= 0) ? field->blocked[cell] : 0;
+}
+
+static Vector2 Toward(float from_x, float from_y, float to_x, float to_y)
+{
+    float dx = to_x - from_x;
+    float dy = to_y - from_y;
+    float length = sqrtf(dx * dx + dy * dy);
+    if (length < 0.0001f) return (Vector2){ 0.0f, 0.0f };
+    return (Vector2){ dx / length, dy / length };
+}
+
+Vector2 FlowField_Direction(const FlowField *field, float x, float y)
+{
+    int cell = CellAt(field, x, y);
+    if (cell < 0 || cell == field->goal_cell) return Toward(x, y, field->goal.x, field->goal.y);
+    int inside = field->blocked[cell];
+    if (!inside && field->cost[cell] == FLOW_FIELD_UNREACHED) return Toward(x, y, field->goal.x, field->goal.y);
+
+    // From a blocked cell any free neighbour will do, corners included.
+    int cx = cell % field->width;
+    int cy = cell / field->width;
+    int best = -1;
+    int32_t best_cost = inside ? FLOW_FIELD_UNREACHED : field->cost[cell];
+    for (int k = 0; k < 8; k++)
+    {
+        int n = -1;
+        if (inside)
+        {
+            int nx = cx + STEP_X[k];
+            int ny = cy + STEP_Y[k];
+            if (nx >= 0 && ny >= 0 && nx < field->width && ny < field->height) n = ny * field->width + nx;
+        }
+        else
+        {
+            n = Neighbour(field, cx, cy, k);
+        }
+        if (n < 0 || field->cost[n] >= best_cost) continue;
+        best = n;
+        best_cost = field->cost[n];
+    }
+    if (best < 0) return Toward(x, y, field->goal.x, field->goal.y);
+    float target_x = field->origin_x + ((float)(best % field->width) + 0.5f) * field->cell_size;
+    float target_y = field->origin_y + ((float)(best / field->width) + 0.5f) * field->cell_size;
+    return Toward(x, y, target_x, target_y);
+}
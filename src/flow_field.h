@@ -0,0 +1,98 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <stdint.h>
+
+#include "raylib.h"
+
+// Shared navigation toward one goal: a grid of square cells around it holds
+// every cell's path cost to the goal, so any number of agents steer by
+// looking at their cell's neighbours instead of searching paths of their own.
+//
+// Costs are integers (FLOW_FIELD_COST_STRAIGHT per side step,
+// FLOW_FIELD_COST_DIAGONAL per diagonal one; a diagonal step may not cut the
+// corner of a blocked cell), so a cost is the exact shortest path and does not
+// depend on the order cells were settled in. Obstacles are resubmitted every
+// update; only the cells whose blocked state changed are then repaired: costs
+// that lost their support are cleared outward from the change, and a Dijkstra
+// pass seeded from the edge of the cleared region (and from freed cells)
+// settles them again. The result is identical to a full rebuild.
+#define FLOW_FIELD_COST_STRAIGHT 10
+#define FLOW_FIELD_COST_DIAGONAL 14
+// Cost of cells the goal cannot be reached from (and of blocked cells).
+#define FLOW_FIELD_UNREACHED INT32_MAX
+// Rings of the settling queue; more than the dearest step (see flow_field.c).
+#define FLOW_FIELD_BUCKETS 16
+
+typedef struct FlowFieldStats
+{
+    // Cells whose blocked state changed in the last commit, cells whose cost
+    // was cleared for repair and cells settled by the Dijkstra pass.
+    int changed_cells;
+    int cleared_cells;
+    int settled_cells;
+    int full_rebuilds;
+} FlowFieldStats;
+
+typedef struct FlowField
+{
+    // width x height cells of cell_size pixels, the goal's cell in the middle.
+    float origin_x;
+    float origin_y;
+    float cell_size;
+    float inv_cell_size;
+    int width;
+    int height;
+    Vector2 goal;
+    int goal_cell;
+    int built;
+    int32_t *cost;
+    unsigned char *blocked;
+    // Obstacles being submitted for the next commit.
+    unsigned char *next_blocked;
+    // Repair scratch, grown as needed: cells to re-check, cleared cells, and
+    // the Dijkstra queue: seed cells, sorted by cost into order (cost << 32 |
+    // cell) through cost_counts, and the cells they reach in buckets by cost
+    // modulo FLOW_FIELD_BUCKETS.
+    int *suspects;
+    int suspect_count;
+    int suspect_capacity;
+    int *cleared;
+    int cleared_count;
+    int cleared_capacity;
+    int *seeds;
+    int seed_count;
+    int seed_capacity;
+    uint64_t *order;
+    int order_capacity;
+    int *cost_counts;
+    int cost_count_capacity;
+    int *buckets[FLOW_FIELD_BUCKETS];
+    int bucket_count[FLOW_FIELD_BUCKETS];
+    int bucket_capacity[FLOW_FIELD_BUCKETS];
+    FlowFieldStats stats;
+} FlowField;
+
+// width and height are rounded up to odd counts so the goal sits in the
+// centre cell. Returns 0 (nothing allocated) on allocation failure. Every
+// cell starts free; costs are built by the first commit.
+int FlowField_Init(FlowField *field, Vector2 goal, float cell_size, int width, int height);
+void FlowField_Free(FlowField *field);
+// Obstacle submission for the next commit: every cell whose centre lies
+// within radius of (x, y) is blocked. The goal's cell never is.
+void FlowField_BeginObstacles(FlowField *field);
+void FlowField_AddDisk(FlowField *field, float x, float y, float radius);
+// Applies the submitted obstacles and repairs the costs the change touched
+// (everything on the first commit, or with full_rebuild set).
+void FlowField_CommitObstacles(FlowField *field, int full_rebuild);
+// Cost of the cell holding (x, y); FLOW_FIELD_UNREACHED outside the grid.
+int32_t FlowField_CostAt(const FlowField *field, float x, float y);
+// 1 if the cell holding (x, y) is blocked; 0 for free cells and outside the grid.
+int FlowField_BlockedAt(const FlowField *field, float x, float y);
+// Unit direction to steer from (x, y): toward the centre of the cheapest
+// neighbouring cell, or straight at the goal from the goal's cell, from
+// outside the grid and from cells the goal cannot be reached from. Agents
+// inside a blocked cell head for the cheapest free neighbour.
+Vector2 FlowField_Direction(const FlowField *field, float x, float y);
+
+#endif
@@ -0,0 +1,259 @@
+#include "fracture.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+#include "rng.h"
+
+// Rejection draws per seed before the rest are given up (very sparse masks).
+#define FRACTURE_SEED_ATTEMPTS 64
+// labels[] while cutting: solid but not yet visited.
+#define FRACTURE_UNVISITED -2
+
+typedef struct FractureComponent
+{
+    int area;
+    long long sum_x;
+    long long sum_y;
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+    // Index in the table, or -1 for dust.
+    int piece;
+} FractureComponent;
+
+// Voronoi cell of pixel (x, y); equal distances go to the lower seed.
+static int NearestSeed(const int *seed_x, const int *seed_y, int seed_count, int x, int y)
+{
+    int best = 0;
+    int best_dist = 0x7fffffff;
+    for (int s = 0; s < seed_count; s++)
+    {
+        int dx = x - seed_x[s];
+        int dy = y - seed_y[s];
+        int dist = dx * dx + dy * dy;
+        if (dist < best_dist)
+        {
+            best_dist = dist;
+            best = s;
+        }
+    }
+    return best;
+}
+
+int Fracture_Build(FractureTable *table, const Image *image, int threshold)
+{
+    memset(table, 0, sizeof(*table));
+    int width = image->width;
+    int height = image->height;
+    const unsigned char *pixels = (const unsigned char *)image->data;
+    if (pixels == NULL || width <= 0 || height <= 0) return 0;
+
+    int *labels = (int *)malloc((size_t)width * (size_t)height * sizeof(int));
+    int *stack = (int *)malloc((size_t)width * (size_t)height * sizeof(int));
+    if (labels == NULL || stack == NULL)
+    {
+        free(labels);
+        free(stack);
+        return 0;
+    }
+
+    long long sum_x = 0;
+    long long sum_y = 0;
+    int min_x = width, min_y = height, max_x = -1, max_y = -1;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            int solid = pixels[((size_t)y * width + x) * 4 + 3] > threshold;
+            labels[y * width + x] = solid ? FRACTURE_UNVISITED : -1;
+            if (!solid) continue;
+            table->area++;
+            sum_x += x;
+            sum_y += y;
+            if (x < min_x) min_x = x;
+            if (x > max_x) max_x = x;
+            if (y < min_y) min_y = y;
+            if (y > max_y) max_y = y;
+        }
+    }
+    if (table->area == 0)
+    {
+        free(labels);
+        free(stack);
+        return 0;
+    }
+    table->centroid_x = (float)((double)sum_x / table->area) + 0.5f;
+    table->centroid_y = (float)((double)sum_y / table->area) + 0.5f;
+
+    // Seeds on distinct solid pixels of the bounding box.
+    int seed_x[FRACTURE_SEEDS];
+    int seed_y[FRACTURE_SEEDS];
+    int seed_count = 0;
+    Rng rng = Rng_Create(FRACTURE_SEED, 0);
+    for (int attempt = 0; attempt < FRACTURE_SEEDS * FRACTURE_SEED_ATTEMPTS && seed_count < FRACTURE_SEEDS; attempt++)
+    {
+        int x = min_x + (int)(Rng_NextFloat(&rng) * (float)(max_x - min_x + 1));
+        int y = min_y + (int)(Rng_NextFloat(&rng) * (float)(max_y - min_y + 1));
+        if (x > max_x) x = max_x;
+        if (y > max_y) y = max_y;
+        if (labels[y * width + x] == -1) continue;
+        int taken = 0;
+        for (int s = 0; s < seed_count; s++) taken |= (seed_x[s] == x && seed_y[s] == y);
+        if (taken) continue;
+        seed_x[seed_count] = x;
+        seed_y[seed_count] = y;
+        seed_count++;
+    }
+    if (seed_count == 0)
+    {
+        seed_x[0] = min_x;
+        seed_y[0] = min_y;
+        seed_count = 1;
+    }
+
+    // Components of each cell, numbered in raster order of their first pixel.
+    FractureComponent *components = NULL;
+    int component_count = 0;
+    int component_capacity = 0;
+    int ok = 1;
+    for (int start = 0; start < width * height; start++)
+    {
+        if (labels[start] != FRACTURE_UNVISITED) continue;
+        if (!Memory_GrowArray((void **)&components, &component_capacity, component_count + 1,
+                              sizeof(FractureComponent), 16))
+        {
+            ok = 0;
+            break;
+        }
+        int id = component_count++;
+        FractureComponent *component = &components[id];
+        *component = (FractureComponent){ 0, 0, 0, width, height, -1, -1, -1 };
+        int cell = NearestSeed(seed_x, seed_y, seed_count, start % width, start / width);
+
+        int top = 0;
+        stack[top++] = start;
+        labels[start] = id;
+        while (top > 0)
+        {
+            int p = stack[--top];
+            int x = p % width;
+            int y = p / width;
+            component->area++;
+            component->sum_x += x;
+            component->sum_y += y;
+            if (x < component->min_x) component->min_x = x;
+            if (x > component->max_x) component->max_x = x;
+            if (y < component->min_y) component->min_y = y;
+            if (y > component->max_y) component->max_y = y;
+
+            const int next_x[4] = { x - 1, x + 1, x, x };
+            const int next_y[4] = { y, y, y - 1, y + 1 };
+            for (int n = 0; n < 4; n++)
+            {
+                if (next_x[n] < 0 || next_x[n] >= width || next_y[n] < 0 || next_y[n] >= height) continue;
+                int q = next_y[n] * width + next_x[n];
+                if (labels[q] != FRACTURE_UNVISITED) continue;
+                if (NearestSeed(seed_x, seed_y, seed_count, next_x[n], next_y[n]) != cell) continue;
+                labels[q] = id;
+                stack[top++] = q;
+            }
+        }
+    }
+    free(stack);
+
+    if (!ok)
+    {
+        free(components);
+        free(labels);
+        memset(table, 0, sizeof(*table));
+        return 0;
+    }
+
+    // Keep the largest components above the dust size (equal areas: the
+    // earlier one), numbered in raster order.
+    int kept = 0;
+    for (int id = 0; id < component_count; id++)
+    {
+        if (components[id].area >= FRACTURE_MIN_AREA) components[id].piece = kept++;
+    }
+    for (; kept > FRACTURE_MAX_PIECES; kept--)
+    {
+        int smallest = -1;
+        for (int id = 0; id < component_count; id++)
+        {
+            if (components[id].piece < 0) continue;
+            if (smallest < 0 || components[id].area <= components[smallest].area) smallest = id;
+        }
+        components[smallest].piece = -1;
+    }
+    for (int id = 0; id < component_count; id++)
+    {
+        const FractureComponent *component = &components[id];
+        if (component->piece < 0) continue;
+        components[id].piece = table->piece_count;
+        FracturePiece *piece = &table->pieces[table->piece_count++];
+        piece->x = (component->min_x > 0) ? component->min_x - 1 : 0;
+        piece->y = (component->min_y > 0) ? component->min_y - 1 : 0;
+        piece->width = ((component->max_x + 1 < width) ? component->max_x + 2 : width) - piece->x;
+        piece->height = ((component->max_y + 1 < height) ? component->max_y + 2 : height) - piece->y;
+        piece->area = component->area;
+        piece->centroid_x = (float)((double)component->sum_x / component->area) + 0.5f;
+        piece->centroid_y = (float)((double)component->sum_y / component->area) + 0.5f;
+    }
+    for (int p = 0; p < width * height; p++)
+    {
+        if (labels[p] >= 0) labels[p] = components[labels[p]].piece;
+    }
+    free(components);
+
+    table->labels = labels;
+    table->width = width;
+    table->height = height;
+    table->threshold = threshold;
+    return 1;
+}
+
+Image Fracture_PieceImage(const FractureTable *table, const Image *image, int piece)
+{
+    Image out = {0};
+    const FracturePiece *box = &table->pieces[piece];
+    unsigned char *data = (unsigned char *)MemAlloc((unsigned int)(box->width * box->height * 4));
+    if (data == NULL) return out;
+    memset(data, 0, (size_t)box->width * (size_t)box->height * 4u);
+
+    const unsigned char *pixels = (const unsigned char *)image->data;
+    int width = table->width;
+    for (int y = box->y; y < box->y + box->height; y++)
+    {
+        for (int x = box->x; x < box->x + box->width; x++)
+        {
+            int p = y * width + x;
+            const unsigned char *src = pixels + (size_t)p * 4;
+            int take = table->labels[p] == piece;
+            // Soft edge: see-through pixels next to the piece go with it.
+            if (!take && src[3] > 0 && src[3] <= table->threshold)
+            {
+                take = (x > 0 && table->labels[p - 1] == piece) ||
+                       (x + 1 < width && table->labels[p + 1] == piece) ||
+                       (y > 0 && table->labels[p - width] == piece) ||
+                       (y + 1 < table->height && table->labels[p + width] == piece);
+            }
+            if (take) memcpy(data + ((size_t)(y - box->y) * box->width + (x - box->x)) * 4, src, 4);
+        }
+    }
+    out.data = data;
+    out.width = box->width;
+    out.height = box->height;
+    out.mipmaps = 1;
+    out.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return out;
+}
+
+void Fracture_Free(FractureTable *table)
+{
+    free(table->labels);
+    table->labels = NULL;
+}
@@ -0,0 +1,55 @@
+#ifndef FRACTURE_H
+#define FRACTURE_H
+
+#include "raylib.h"
+
+// How a rock breaks, cut once per asset at load (or by the asset cooker):
+// FRACTURE_SEEDS points scattered over the solid pixels split the mask into
+// Voronoi cells, each cell splits into its 4-connected components, and
+// components under FRACTURE_MIN_AREA pixels are dropped as dust. At most
+// FRACTURE_MAX_PIECES pieces are kept (the largest). The seeds come from a
+// fixed random stream, so every build of the same image cuts it the same way.
+#define FRACTURE_SEEDS 5
+#define FRACTURE_MIN_AREA 64
+#define FRACTURE_MAX_PIECES 12
+#define FRACTURE_SEED 0x46524143u /* "FRAC" */
+
+// One piece, in the source image's pixels: its bounding box (grown by a pixel
+// for the soft edge, within the image), solid area and centroid.
+typedef struct FracturePiece
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int area;
+    float centroid_x;
+    float centroid_y;
+} FracturePiece;
+
+typedef struct FractureTable
+{
+    FracturePiece pieces[FRACTURE_MAX_PIECES];
+    int piece_count;
+    // The whole rock's solid area and centroid (dust included).
+    int area;
+    float centroid_x;
+    float centroid_y;
+    // Piece of every source pixel (-1: empty or dust), width * height; only
+    // needed to cut the piece images.
+    int *labels;
+    int width;
+    int height;
+    int threshold;
+} FractureTable;
+
+// Cuts an RGBA8 image whose alpha above threshold is solid. Returns 0 (and
+// leaves nothing allocated) if it has no solid pixels or allocation fails.
+int Fracture_Build(FractureTable *table, const Image *image, int threshold);
+// RGBA8 copy of a piece's bounding box holding only its pixels (plus the
+// soft edge pixels bordering it); everything else is transparent. Owned:
+// UnloadImage it. data is NULL on allocation failure.
+Image Fracture_PieceImage(const FractureTable *table, const Image *image, int piece);
+void Fracture_Free(FractureTable *table);
+
+#endif
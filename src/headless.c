@@ -0,0 +1,310 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "headless.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "clock.h"
+#include "input_record.h"
+#include "profiler.h"
+#include "sim_thread.h"
+#include "world.h"
+
+// --sim-thread runs the fixed timeline this many times faster than real time
+// so a check stays short.
+#define HEADLESS_SIM_SPEEDUP 8.0
+// Slowest ticks listed after a replay.
+#define HEADLESS_SLOW_TICKS 5
+
+typedef struct SlowTick
+{
+    uint64_t tick;
+    double ms;
+} SlowTick;
+
+// Per-scope p50/p99 over the last PROFILER_WINDOW samples, then the trace.
+// Returns 0 if the trace could not be written.
+static int ReportProfile(const char *trace_path)
+{
+    if (!Profiler_Enabled())
+    {
+        if (trace_path != NULL) printf("profile: markers compiled out (configure with -DSPACE_GAME_PROFILE=ON)\n");
+        return 1;
+    }
+    ProfilerScopeSummary scopes[PROFILER_MAX_SCOPES];
+    int count = Profiler_Summarize(scopes, PROFILER_MAX_SCOPES);
+    printf("profile: %6s %-*s %10s %9s %9s %9s\n", "thread", 24, "scope", "calls", "p50_ms", "p99_ms", "max_ms");
+    for (int i = 0; i < count; i++)
+    {
+        const ProfilerScopeSummary *scope = &scopes[i];
+        printf("profile: %6d %*s%-*s %10llu %9.3f %9.3f %9.3f\n", scope->thread, 2 * scope->depth, "",
+               24 - 2 * scope->depth, scope->name, (unsigned long long)scope->calls, scope->p50_ms, scope->p99_ms,
+               scope->max_ms);
+    }
+    printf("profile: dropped=%llu\n", (unsigned long long)Profiler_Dropped());
+
+    int ok = 1;
+    if (trace_path != NULL)
+    {
+        Profiler_EndCapture();
+        ok = Profiler_WriteChromeTrace(trace_path);
+        printf("profile: trace %s %s\n", trace_path, ok ? "written" : "FAILED");
+    }
+    Profiler_Shutdown();
+    return ok;
+}
+
+static void SleepSeconds(double seconds)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+// Renderer stand-in: interpolates every asteroid each "frame", with jittery
+// frame times (mostly shorter than a tick, every eighth much longer) so both
+// repeated frames and dropped snapshots happen. Returns 0 if the hand-off
+// counters do not add up or an interpolated position leaves its segment.
+static int RunSimThread(World *world, const InputSnapshot *input, int steps, InputRecorder *recorder)
+{
+    double tick_seconds = SIM_DT / HEADLESS_SIM_SPEEDUP;
+    SimThread sim;
+    if (!SimThread_Start(&sim, world, input, tick_seconds, (uint64_t)steps, recorder))
+    {
+        printf("sim-thread: no thread, running inline\n");
+    }
+
+    int bad_alpha = 0;
+    int bad_lerp = 0;
+    for (int frame = 0; SimThread_Running(&sim); frame++)
+    {
+        SimThread_Acquire(&sim);
+        float alpha = SimThread_Alpha(&sim, Clock_NowSeconds());
+        if (!(alpha >= 0.0f && alpha <= 1.0f)) bad_alpha++;
+
+        const RenderSnapshot *prev = SimThread_Prev(&sim);
+        const RenderSnapshot *cur = SimThread_Current(&sim);
+        for (int i = 0; i < cur->asteroid_count; i++)
+        {
+            int j = (i < sim.links.count) ? sim.links.prev_index[i] : -1;
+            if (j < 0) continue;
+            float a = prev->asteroid_x[j];
+            float b = cur->asteroid_x[i];
+            float x = a + (b - a) * alpha;
+            if (x < fminf(a, b) - 1e-3f || x > fmaxf(a, b) + 1e-3f) bad_lerp++;
+        }
+        Profiler_Collect();
+        SleepSeconds(tick_seconds * ((frame % 8 == 7) ? 3.0 : 0.5));
+    }
+    SimThread_Stop(&sim);
+    // The last snapshot, if the renderer had not taken it yet.
+    SimThread_Acquire(&sim);
+
+    const SimThreadStats *stats = &sim.stats;
+    double ticks = (sim.published > 0) ? (double)sim.published : 1.0;
+    double consumed = (stats->consumed > 0) ? (double)stats->consumed : 1.0;
+    printf("sim-thread: ticks=%llu step_ms avg=%.3f max=%.3f\n", (unsigned long long)sim.published,
+           sim.step_ms_sum / ticks, sim.step_ms_max);
+    printf("sim-thread: frames=%llu consumed=%llu repeated=%llu dropped=%llu skipped_ticks=%llu latency_ms avg=%.3f max=%.3f\n",
+           (unsigned long long)stats->frames, (unsigned long long)stats->consumed, (unsigned long long)stats->repeated,
+           (unsigned long long)sim.dropped, (unsigned long long)stats->skipped_ticks, stats->latency_ms_sum / consumed,
+           stats->latency_ms_max);
+
+    int ok = sim.published == (uint64_t)steps && stats->consumed + sim.dropped == sim.published &&
+             stats->skipped_ticks == sim.dropped && SimThread_Current(&sim)->tick == world->tick && bad_alpha == 0 &&
+             bad_lerp == 0;
+    printf("sim-thread: %s\n", ok ? "ok" : "FAILED");
+    SimThread_Free(&sim);
+    return ok;
+}
+
+// Keeps the slowest ticks, slowest first.
+static void NoteSlowTick(SlowTick *slowest, uint64_t tick, double ms)
+{
+    if (ms <= slowest[HEADLESS_SLOW_TICKS - 1].ms) return;
+    int i = HEADLESS_SLOW_TICKS - 1;
+    for (; i > 0 && slowest[i - 1].ms < ms; i--) slowest[i] = slowest[i - 1];
+    slowest[i] = (SlowTick){ tick, ms };
+}
+
+int Headless_Run(const HeadlessConfig *config)
+{
+    SetTraceLogLevel(LOG_WARNING);
+
+    // A replay takes the world setup from the recording.
+    InputReplay replay = {0};
+    int replaying = config->replay_path != NULL;
+    unsigned int seed = config->seed;
+    int field_asteroids = config->asteroids;
+    if (replaying)
+    {
+        if (!InputReplay_Open(&replay, config->replay_path))
+        {
+            fprintf(stderr, "headless: %s is not an input recording\n", config->replay_path);
+            return 1;
+        }
+        seed = replay.header.seed;
+        field_asteroids = replay.header.field_asteroids;
+    }
+
+    JobSystem jobs;
+    JobSystem_Init(&jobs, config->threads);
+
+    static World world;
+    double load_start = Clock_NowSeconds();
+    World_Init(&world, seed, 1, &jobs);
+    double load_ms = (Clock_NowSeconds() - load_start) * 1000.0;
+    if (world.asteroids.asset_count <= 0)
+    {
+        fprintf(stderr, "headless: no asteroid masks loaded (run from the repository root)\n");
+        World_Unload(&world);
+        JobSystem_Shutdown(&jobs);
+        InputReplay_Close(&replay);
+        return 1;
+    }
+    if (replaying) InputRecord_ApplyHeader(&world, &replay.header);
+
+    // Optional pre-populated field for scaling runs: roughly one rock per
+    // 300x300 px, on top of the streamed sectors.
+    if (field_asteroids > 0)
+    {
+        float radius = sqrtf((float)field_asteroids * 90000.0f / PI);
+        Asteroids_SpawnField(&world.asteroids, world.player.position, field_asteroids, radius);
+    }
+
+    // No live input in headless mode: the ship holds position and aims up.
+    InputSnapshot input = Input_Neutral((Vector2){ world.player.position.x, world.player.position.y - 1.0f });
+
+    InputRecorder recorder = {0};
+    InputRecorder *recording = NULL;
+    int record_ok = 1;
+    if (config->record_path != NULL)
+    {
+        InputRecordHeader header = InputRecord_Header(&world, field_asteroids);
+        if (!InputRecorder_Open(&recorder, config->record_path, &header))
+        {
+            fprintf(stderr, "headless: cannot write %s\n", config->record_path);
+            record_ok = 0;
+        }
+        else
+        {
+            recording = &recorder;
+        }
+    }
+    FILE *hash_log = NULL;
+    if (config->hash_log_path != NULL)
+    {
+        hash_log = fopen(config->hash_log_path, "w");
+        if (hash_log == NULL) fprintf(stderr, "headless: cannot write %s\n", config->hash_log_path);
+    }
+
+    long long candidate_pairs = 0;
+    long long narrowphase_tests = 0;
+    long long collisions = 0;
+    long long coarse_rejects = 0;
+    long long coarse_accepts = 0;
+    long long fine_tests = 0;
+    SlowTick slowest[HEADLESS_SLOW_TICKS] = {0};
+    int checkpoints = 0;
+    uint64_t diverged_tick = 0;
+
+    PROFILE_THREAD("main", -1);
+    if (config->trace_path != NULL) Profiler_BeginCapture();
+
+    double start = Clock_NowSeconds();
+    int steps = 0;
+    int handoff_ok = 1;
+    if (config->sim_thread && !replaying)
+    {
+        handoff_ok = RunSimThread(&world, &input, config->steps, recording);
+        steps = config->steps;
+    }
+    for (; !config->sim_thread || replaying; steps++)
+    {
+        float dt = (config->dt > 0.0f) ? config->dt : SIM_DT;
+        if (replaying)
+        {
+            if (!InputReplay_Next(&replay, &input, &dt)) break;
+        }
+        else if (steps >= config->steps)
+        {
+            break;
+        }
+
+        uint64_t step_start = Clock_NowNs();
+        World_Step(&world, &input, dt);
+        NoteSlowTick(slowest, world.tick, (double)(Clock_NowNs() - step_start) / 1e6);
+        if (recording != NULL) InputRecorder_Tick(recording, &input, dt, &world);
+        if (hash_log != NULL || replaying)
+        {
+            uint64_t hash = World_Checksum(&world);
+            if (hash_log != NULL) fprintf(hash_log, "%llu %016llx\n", (unsigned long long)world.tick, (unsigned long long)hash);
+            uint64_t recorded_tick = 0;
+            uint64_t recorded_hash = 0;
+            if (replaying && InputReplay_Checkpoint(&replay, &recorded_tick, &recorded_hash))
+            {
+                checkpoints++;
+                if (diverged_tick == 0 && (recorded_tick != world.tick || recorded_hash != hash)) diverged_tick = world.tick;
+            }
+        }
+
+        const AsteroidStats *stats = &world.asteroids.stats;
+        candidate_pairs += stats->broadphase.candidate_pairs;
+        narrowphase_tests += stats->narrowphase_tests;
+        collisions += stats->collisions;
+        coarse_rejects += stats->shape.coarse_rejects;
+        coarse_accepts += stats->shape.coarse_accepts;
+        fine_tests += stats->shape.fine_tests;
+        Profiler_Collect();
+    }
+    double elapsed = Clock_NowSeconds() - start;
+    Profiler_Collect();
+
+    double ticks_per_sec = (elapsed > 0.0) ? (double)steps / elapsed : 0.0;
+    printf("steps=%d seed=%u threads=%d elapsed=%.3fs ticks/sec=%.0f\n",
+           steps, seed, JobSystem_ThreadCount(&jobs), elapsed, ticks_per_sec);
+    if (steps > 0 && !config->sim_thread)
+    {
+        printf("pairs/tick: candidate=%.1f narrowphase=%.1f collisions=%lld\n",
+               (double)candidate_pairs / steps, (double)narrowphase_tests / steps, collisions);
+        printf("narrowphase: coarse_rejects=%lld coarse_accepts=%lld fine_tests=%lld\n",
+               coarse_rejects, coarse_accepts, fine_tests);
+    }
+    printf("sectors: active=%d mined_records=%d\n", world.asteroids.sectors.active, world.asteroids.sectors.dirty_count);
+    printf("mask_bytes=%zu load=%.1fms assets=%s\n", world.asteroids.mask_bytes, load_ms,
+           world.asteroids.assets[0].mapped ? "pack" : "png");
+    printf("asteroids=%d checksum=%016llx\n", Asteroids_Count(&world.asteroids), (unsigned long long)World_Checksum(&world));
+
+    int replay_ok = 1;
+    if (replaying)
+    {
+        printf("replay: ticks=%llu checkpoints=%d", (unsigned long long)replay.ticks, checkpoints);
+        if (diverged_tick != 0) printf(" DIVERGED by tick %llu\n", (unsigned long long)diverged_tick);
+        else if (replay.failed) printf(" TRUNCATED\n");
+        else printf(" ok\n");
+        printf("replay: slowest ticks");
+        for (int i = 0; i < HEADLESS_SLOW_TICKS && slowest[i].ms > 0.0; i++)
+        {
+            printf(" %llu=%.2fms", (unsigned long long)slowest[i].tick, slowest[i].ms);
+        }
+        printf("\n");
+        replay_ok = diverged_tick == 0 && !replay.failed;
+        InputReplay_Close(&replay);
+    }
+    if (recording != NULL)
+    {
+        record_ok = InputRecorder_Close(recording);
+        printf("record: %s ticks=%llu %s\n", config->record_path, (unsigned long long)recorder.ticks,
+               record_ok ? "written" : "FAILED");
+    }
+    if (hash_log != NULL) fclose(hash_log);
+
+    int trace_ok = ReportProfile(config->trace_path);
+
+    World_Unload(&world);
+    JobSystem_Shutdown(&jobs);
+    return (handoff_ok && trace_ok && replay_ok && record_ok) ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+typedef struct HeadlessConfig
+{
+    int steps;
+    unsigned int seed;
+    int asteroids;
+    int threads;
+    // Step length in seconds; 0 means SIM_DT. Ignored by replays (they use
+    // the recorded steps) and by sim_thread.
+    float dt;
+    // Step on a SimThread (paced, faster than real time) while the main
+    // thread plays renderer, and check the snapshot hand-off.
+    int sim_thread;
+    // Chrome trace of the whole run (profiler builds only), or NULL.
+    const char *trace_path;
+    // Input recording to write, or to replay (its seed and field then
+    // replace seed and asteroids), or NULL.
+    const char *record_path;
+    const char *replay_path;
+    // "tick hash" per line after every tick, for diffing two runs; or NULL.
+    const char *hash_log_path;
+} HeadlessConfig;
+
+// Runs the simulation at SIM_DT (or a recording's ticks) as fast as the CPU
+// allows: no window, no GPU calls. Prints throughput and a final state
+// checksum; a replay also checks the recorded state hashes and lists the
+// slowest ticks. Returns a process exit code.
+int Headless_Run(const HeadlessConfig *config);
+
+#endif
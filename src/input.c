@@ -0,0 +1,33 @@
+#include "input.h"
+
+InputSnapshot Input_Sample(Camera2D camera)
+{
+    unsigned char buttons = 0;
+    if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) buttons |= INPUT_BUTTON_UP;
+    if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) buttons |= INPUT_BUTTON_DOWN;
+    if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) buttons |= INPUT_BUTTON_LEFT;
+    if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) buttons |= INPUT_BUTTON_RIGHT;
+    if (IsMouseButtonDown(MOUSE_BUTTON_RIGHT)) buttons |= INPUT_BUTTON_BOOST;
+    return Input_FromButtons(buttons, GetScreenToWorld2D(GetMousePosition(), camera), GetMouseWheelMove());
+}
+
+InputSnapshot Input_Neutral(Vector2 aim_world)
+{
+    InputSnapshot input = {0};
+    input.aim_world = aim_world;
+    return input;
+}
+
+InputSnapshot Input_FromButtons(unsigned char buttons, Vector2 aim_world, float wheel)
+{
+    InputSnapshot input = {0};
+    if (buttons & INPUT_BUTTON_UP) input.move.y -= 1.0f;
+    if (buttons & INPUT_BUTTON_DOWN) input.move.y += 1.0f;
+    if (buttons & INPUT_BUTTON_LEFT) input.move.x -= 1.0f;
+    if (buttons & INPUT_BUTTON_RIGHT) input.move.x += 1.0f;
+    input.boost = (buttons & INPUT_BUTTON_BOOST) != 0;
+    input.buttons = buttons;
+    input.aim_world = aim_world;
+    input.wheel = wheel;
+    return input;
+}
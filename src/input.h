@@ -0,0 +1,30 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "raylib.h"
+
+// Held-button bits of an InputSnapshot.
+#define INPUT_BUTTON_UP 0x01u
+#define INPUT_BUTTON_DOWN 0x02u
+#define INPUT_BUTTON_LEFT 0x04u
+#define INPUT_BUTTON_RIGHT 0x08u
+#define INPUT_BUTTON_BOOST 0x10u
+
+// Input sampled once per frame; the simulation only ever reads this snapshot,
+// never raylib's live input state, so it can run headless. move and boost are
+// derived from buttons (Input_FromButtons), which is what input recordings
+// store; wheel is for the camera and never reaches the sim.
+typedef struct InputSnapshot
+{
+    Vector2 move;
+    Vector2 aim_world;
+    bool boost;
+    unsigned char buttons;
+    float wheel;
+} InputSnapshot;
+
+InputSnapshot Input_Sample(Camera2D camera);
+InputSnapshot Input_Neutral(Vector2 aim_world);
+InputSnapshot Input_FromButtons(unsigned char buttons, Vector2 aim_world, float wheel);
+
+#endif
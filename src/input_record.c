@@ -0,0 +1,204 @@
+#include "input_record.h"
+
+#include <string.h>
+
+enum
+{
+    RECORD_TICK = 1,
+    RECORD_REPEAT = 2,
+    RECORD_HASH = 3
+};
+
+#define RECORD_MAX_REPEAT 0xffff
+
+InputRecordHeader InputRecord_Header(const World *world, int field_asteroids)
+{
+    InputRecordHeader header = {0};
+    header.magic = INPUT_RECORD_MAGIC;
+    header.version = INPUT_RECORD_VERSION;
+    header.seed = world->seed;
+    header.field_asteroids = field_asteroids;
+    header.view_radius = world->asteroids.view_radius;
+    header.player_width = world->player.size.x;
+    header.player_height = world->player.size.y;
+    return header;
+}
+
+void InputRecord_ApplyHeader(World *world, const InputRecordHeader *header)
+{
+    world->asteroids.view_radius = header->view_radius;
+    world->player.size = (Vector2){ header->player_width, header->player_height };
+}
+
+static void Write(InputRecorder *recorder, const void *data, size_t size)
+{
+    if (recorder->failed) return;
+    if (fwrite(data, 1, size, recorder->file) != size) recorder->failed = 1;
+}
+
+static void WriteTag(InputRecorder *recorder, unsigned char tag)
+{
+    Write(recorder, &tag, 1);
+}
+
+static void FlushRepeats(InputRecorder *recorder)
+{
+    if (recorder->pending_repeats == 0) return;
+    uint16_t count = (uint16_t)recorder->pending_repeats;
+    WriteTag(recorder, RECORD_REPEAT);
+    Write(recorder, &count, sizeof(count));
+    recorder->pending_repeats = 0;
+}
+
+int InputRecorder_Open(InputRecorder *recorder, const char *path, const InputRecordHeader *header)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->file = fopen(path, "wb");
+    if (recorder->file == NULL) return 0;
+    Write(recorder, header, sizeof(*header));
+    return !recorder->failed;
+}
+
+void InputRecorder_Tick(InputRecorder *recorder, const InputSnapshot *input, float dt, const World *world)
+{
+    if (recorder->file == NULL) return;
+    // Compared bitwise, so a replay sees exactly the recorded floats.
+    int same = recorder->has_last && recorder->buttons == input->buttons &&
+               memcmp(&recorder->aim_x, &input->aim_world.x, sizeof(float)) == 0 &&
+               memcmp(&recorder->aim_y, &input->aim_world.y, sizeof(float)) == 0 &&
+               memcmp(&recorder->wheel, &input->wheel, sizeof(float)) == 0 &&
+               memcmp(&recorder->dt, &dt, sizeof(float)) == 0;
+    if (same && recorder->pending_repeats < RECORD_MAX_REPEAT)
+    {
+        recorder->pending_repeats++;
+    }
+    else
+    {
+        FlushRepeats(recorder);
+        recorder->buttons = input->buttons;
+        recorder->aim_x = input->aim_world.x;
+        recorder->aim_y = input->aim_world.y;
+        recorder->wheel = input->wheel;
+        recorder->dt = dt;
+        recorder->has_last = 1;
+        WriteTag(recorder, RECORD_TICK);
+        Write(recorder, &recorder->buttons, 1);
+        Write(recorder, &recorder->aim_x, sizeof(float));
+        Write(recorder, &recorder->aim_y, sizeof(float));
+        Write(recorder, &recorder->wheel, sizeof(float));
+        Write(recorder, &recorder->dt, sizeof(float));
+    }
+    recorder->ticks++;
+
+    if (world->tick % INPUT_RECORD_HASH_INTERVAL == 0)
+    {
+        FlushRepeats(recorder);
+        uint64_t tick = world->tick;
+        uint64_t hash = World_Checksum(world);
+        WriteTag(recorder, RECORD_HASH);
+        Write(recorder, &tick, sizeof(tick));
+        Write(recorder, &hash, sizeof(hash));
+    }
+}
+
+int InputRecorder_Close(InputRecorder *recorder)
+{
+    if (recorder->file == NULL) return 0;
+    FlushRepeats(recorder);
+    int ok = !recorder->failed;
+    if (fclose(recorder->file) != 0) ok = 0;
+    recorder->file = NULL;
+    return ok;
+}
+
+static int Read(InputReplay *replay, void *data, size_t size)
+{
+    if (replay->failed) return 0;
+    if (fread(data, 1, size, replay->file) != size)
+    {
+        replay->failed = 1;
+        return 0;
+    }
+    return 1;
+}
+
+static void ReadTag(InputReplay *replay)
+{
+    int tag = fgetc(replay->file);
+    replay->tag = (tag == EOF) ? 0 : tag;
+}
+
+int InputReplay_Open(InputReplay *replay, const char *path)
+{
+    memset(replay, 0, sizeof(*replay));
+    replay->file = fopen(path, "rb");
+    if (replay->file == NULL) return 0;
+    if (!Read(replay, &replay->header, sizeof(replay->header)) || replay->header.magic != INPUT_RECORD_MAGIC ||
+        replay->header.version != INPUT_RECORD_VERSION)
+    {
+        InputReplay_Close(replay);
+        return 0;
+    }
+    ReadTag(replay);
+    return 1;
+}
+
+int InputReplay_Next(InputReplay *replay, InputSnapshot *input, float *dt)
+{
+    // A checkpoint the caller did not ask for.
+    uint64_t skipped[2];
+    while (replay->repeats_left == 0 && replay->tag == RECORD_HASH)
+    {
+        if (!Read(replay, skipped, sizeof(skipped))) return 0;
+        ReadTag(replay);
+    }
+
+    if (replay->repeats_left > 0)
+    {
+        replay->repeats_left--;
+    }
+    else if (replay->tag == RECORD_TICK)
+    {
+        unsigned char buttons = 0;
+        float values[4];
+        if (!Read(replay, &buttons, 1) || !Read(replay, values, sizeof(values))) return 0;
+        replay->input = Input_FromButtons(buttons, (Vector2){ values[0], values[1] }, values[2]);
+        replay->dt = values[3];
+        ReadTag(replay);
+    }
+    else if (replay->tag == RECORD_REPEAT && replay->ticks > 0)
+    {
+        uint16_t count = 0;
+        if (!Read(replay, &count, sizeof(count)) || count == 0) return 0;
+        replay->repeats_left = count - 1;
+        ReadTag(replay);
+    }
+    else
+    {
+        // End of stream, or a record this version does not know.
+        if (replay->tag != 0) replay->failed = 1;
+        return 0;
+    }
+
+    replay->ticks++;
+    *input = replay->input;
+    *dt = replay->dt;
+    return 1;
+}
+
+int InputReplay_Checkpoint(InputReplay *replay, uint64_t *tick, uint64_t *hash)
+{
+    if (replay->repeats_left > 0 || replay->tag != RECORD_HASH) return 0;
+    uint64_t values[2];
+    if (!Read(replay, values, sizeof(values))) return 0;
+    ReadTag(replay);
+    *tick = values[0];
+    *hash = values[1];
+    return 1;
+}
+
+void InputReplay_Close(InputReplay *replay)
+{
+    if (replay->file != NULL) fclose(replay->file);
+    replay->file = NULL;
+}
@@ -0,0 +1,91 @@
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "input.h"
+#include "world.h"
+
+// Input recordings: everything needed to re-run a session tick for tick in a
+// headless world. The header holds the world setup (seed, pre-spawned field,
+// the settings the windowed game changes), followed by one record per tick
+// in the order the sim consumed them:
+//
+//   TICK    buttons u8, aim_world f32 x2, wheel f32, dt f32
+//   REPEAT  count u16: the previous TICK again, count more times
+//   HASH    tick u64, World_Checksum u64 after that tick (every
+//           INPUT_RECORD_HASH_INTERVAL ticks)
+//
+// Each record starts with its tag byte. Like the asset pack, a recording is
+// only valid on the endianness it was written with.
+
+#define INPUT_RECORD_MAGIC 0x52504e49u /* "INPR" */
+#define INPUT_RECORD_VERSION 5u
+#define INPUT_RECORD_HASH_INTERVAL 60
+
+typedef struct InputRecordHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t seed;
+    // Asteroids_SpawnField count before the first tick (headless --asteroids).
+    int32_t field_asteroids;
+    float view_radius;
+    // Affects the map-bounds clamp; the windowed ship is texture-sized.
+    float player_width;
+    float player_height;
+    uint32_t reserved;
+} InputRecordHeader;
+
+typedef struct InputRecorder
+{
+    FILE *file;
+    // Last TICK written and how many repeats of it are not written yet.
+    unsigned char buttons;
+    float aim_x;
+    float aim_y;
+    float wheel;
+    float dt;
+    int has_last;
+    int pending_repeats;
+    uint64_t ticks;
+    int failed;
+} InputRecorder;
+
+typedef struct InputReplay
+{
+    FILE *file;
+    InputRecordHeader header;
+    InputSnapshot input;
+    float dt;
+    int repeats_left;
+    // Tag of the next record, read ahead; 0 at the end of the stream.
+    int tag;
+    uint64_t ticks;
+    int failed;
+} InputReplay;
+
+// Header for a world about to run its first tick.
+InputRecordHeader InputRecord_Header(const World *world, int field_asteroids);
+// Applies the recorded settings to a freshly initialised world (seeded with
+// header->seed, field not yet spawned).
+void InputRecord_ApplyHeader(World *world, const InputRecordHeader *header);
+
+// Returns 0 if path cannot be written.
+int InputRecorder_Open(InputRecorder *recorder, const char *path, const InputRecordHeader *header);
+// After World_Step(world, input, dt).
+void InputRecorder_Tick(InputRecorder *recorder, const InputSnapshot *input, float dt, const World *world);
+// Returns 0 if any write failed.
+int InputRecorder_Close(InputRecorder *recorder);
+
+// Returns 0 if path is missing or not a recording of this version.
+int InputReplay_Open(InputReplay *replay, const char *path);
+// Next tick's input and dt. Returns 0 at the end of the recording.
+int InputReplay_Next(InputReplay *replay, InputSnapshot *input, float *dt);
+// After stepping a tick: returns 1 with the recorded hash if the recording
+// has a checkpoint here.
+int InputReplay_Checkpoint(InputReplay *replay, uint64_t *tick, uint64_t *hash);
+void InputReplay_Close(InputReplay *replay);
+
+#endif
@@ -0,0 +1,301 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "job_system.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "profiler.h"
+
+typedef struct JobWorkerStart
+{
+    JobSystem *jobs;
+    int index;
+} JobWorkerStart;
+
+// The calling thread's index and the system it belongs to; the index only
+// means something for that system (threads outside it use 0).
+static _Thread_local int tls_thread_index = 0;
+static _Thread_local const JobSystem *tls_jobs = NULL;
+
+static int QueueInit(JobQueue *queue)
+{
+    *queue = (JobQueue){0};
+    return pthread_mutex_init(&queue->lock, NULL) == 0;
+}
+
+static void QueueFree(JobQueue *queue)
+{
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->jobs);
+    queue->jobs = NULL;
+}
+
+// Ring buffer; on growth the live range is unrolled to start at 0.
+static int QueuePushBack(JobQueue *queue, const Job *job)
+{
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count == queue->capacity)
+    {
+        int capacity = (queue->capacity > 0) ? queue->capacity * 2 : 64;
+        Job *grown = (Job *)malloc((size_t)capacity * sizeof(Job));
+        if (grown == NULL)
+        {
+            pthread_mutex_unlock(&queue->lock);
+            return 0;
+        }
+        for (int i = 0; i < queue->count; i++)
+        {
+            grown[i] = queue->jobs[(queue->head + i) % queue->capacity];
+        }
+        free(queue->jobs);
+        queue->jobs = grown;
+        queue->capacity = capacity;
+        queue->head = 0;
+    }
+    queue->jobs[(queue->head + queue->count) % queue->capacity] = *job;
+    queue->count++;
+    pthread_mutex_unlock(&queue->lock);
+    return 1;
+}
+
+static int QueuePopBack(JobQueue *queue, Job *out)
+{
+    int found = 0;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count > 0)
+    {
+        queue->count--;
+        *out = queue->jobs[(queue->head + queue->count) % queue->capacity];
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+static int QueueStealFront(JobQueue *queue, Job *out)
+{
+    int found = 0;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->count > 0)
+    {
+        *out = queue->jobs[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+// Own queue first (most recently pushed, still warm), then steal the oldest
+// job from the other threads, starting with the next one over.
+static int TakeJob(JobSystem *jobs, int self, Job *out)
+{
+    if (atomic_load_explicit(&jobs->queued, memory_order_acquire) == 0) return 0;
+
+    if (QueuePopBack(&jobs->queues[self], out))
+    {
+        atomic_fetch_sub_explicit(&jobs->queued, 1, memory_order_relaxed);
+        return 1;
+    }
+    for (int i = 1; i < jobs->thread_count; i++)
+    {
+        int victim = (self + i) % jobs->thread_count;
+        if (QueueStealFront(&jobs->queues[victim], out))
+        {
+            atomic_fetch_sub_explicit(&jobs->queued, 1, memory_order_relaxed);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void RunJob(const Job *job)
+{
+    PROFILE_BEGIN("job");
+    job->fn(job->user, job->begin, job->end);
+    PROFILE_END();
+    if (job->counter != NULL) atomic_fetch_sub_explicit(&job->counter->value, 1, memory_order_release);
+}
+
+static void *WorkerMain(void *arg)
+{
+    JobWorkerStart *start = (JobWorkerStart *)arg;
+    JobSystem *jobs = start->jobs;
+    int self = start->index;
+    tls_thread_index = self;
+    tls_jobs = jobs;
+    PROFILE_THREAD("worker", self);
+
+    for (;;)
+    {
+        Job job;
+        if (TakeJob(jobs, self, &job))
+        {
+            RunJob(&job);
+            continue;
+        }
+
+        pthread_mutex_lock(&jobs->sleep_lock);
+        while (atomic_load(&jobs->queued) == 0 && !atomic_load(&jobs->shutdown))
+        {
+            pthread_cond_wait(&jobs->wake, &jobs->sleep_lock);
+        }
+        pthread_mutex_unlock(&jobs->sleep_lock);
+        if (atomic_load(&jobs->shutdown)) break;
+    }
+    PROFILE_THREAD_EXIT();
+    return NULL;
+}
+
+// Joins workers 1 .. started - 1 and frees their queues. thread_count drops
+// to 1, so after a partial start everything runs inline on the caller rather
+// than queueing jobs no worker owns.
+static void StopWorkers(JobSystem *jobs, int started)
+{
+    pthread_mutex_lock(&jobs->sleep_lock);
+    atomic_store(&jobs->shutdown, 1);
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->sleep_lock);
+
+    for (int i = 1; i < started; i++)
+    {
+        pthread_join(jobs->threads[i], NULL);
+    }
+    for (int i = 1; i < jobs->thread_count; i++)
+    {
+        QueueFree(&jobs->queues[i]);
+    }
+    jobs->thread_count = 1;
+}
+
+int JobSystem_Init(JobSystem *jobs, int thread_count)
+{
+    memset(jobs, 0, sizeof(*jobs));
+    if (thread_count < 1) thread_count = 1;
+    atomic_init(&jobs->queued, 0);
+    atomic_init(&jobs->shutdown, 0);
+    pthread_mutex_init(&jobs->sleep_lock, NULL);
+    pthread_cond_init(&jobs->wake, NULL);
+
+    jobs->queues = (JobQueue *)calloc((size_t)thread_count, sizeof(JobQueue));
+    jobs->threads = (pthread_t *)calloc((size_t)thread_count, sizeof(pthread_t));
+    jobs->starts = (JobWorkerStart *)calloc((size_t)thread_count, sizeof(JobWorkerStart));
+    jobs->thread_count = 1;
+    if (jobs->queues == NULL || jobs->threads == NULL || jobs->starts == NULL || !QueueInit(&jobs->queues[0]))
+    {
+        return 0;
+    }
+
+    for (int i = 1; i < thread_count; i++)
+    {
+        if (!QueueInit(&jobs->queues[i]))
+        {
+            // No worker has started yet: drop the extra queues and run inline.
+            StopWorkers(jobs, 1);
+            return 0;
+        }
+        jobs->thread_count = i + 1;
+    }
+
+    // Every queue exists before the first worker starts stealing.
+    tls_thread_index = 0;
+    for (int i = 1; i < thread_count; i++)
+    {
+        jobs->starts[i] = (JobWorkerStart){ jobs, i };
+        if (pthread_create(&jobs->threads[i], NULL, WorkerMain, &jobs->starts[i]) != 0)
+        {
+            StopWorkers(jobs, i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void JobSystem_Shutdown(JobSystem *jobs)
+{
+    StopWorkers(jobs, jobs->thread_count);
+    if (jobs->queues != NULL) QueueFree(&jobs->queues[0]);
+    free(jobs->queues);
+    free(jobs->threads);
+    free(jobs->starts);
+    pthread_mutex_destroy(&jobs->sleep_lock);
+    pthread_cond_destroy(&jobs->wake);
+    memset(jobs, 0, sizeof(*jobs));
+}
+
+int JobSystem_ThreadCount(const JobSystem *jobs)
+{
+    return (jobs != NULL && jobs->thread_count > 0) ? jobs->thread_count : 1;
+}
+
+int JobSystem_DefaultThreadCount(void)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) return 1;
+    return (cpus > JOB_SYSTEM_MAX_DEFAULT_THREADS) ? JOB_SYSTEM_MAX_DEFAULT_THREADS : (int)cpus;
+}
+
+int JobSystem_ThreadIndex(const JobSystem *jobs)
+{
+    return (jobs != NULL && jobs == tls_jobs) ? tls_thread_index : 0;
+}
+
+void JobCounter_Init(JobCounter *counter)
+{
+    atomic_init(&counter->value, 0);
+}
+
+void JobSystem_Submit(JobSystem *jobs, JobFn fn, void *user, int begin, int end, JobCounter *counter)
+{
+    Job job = { fn, user, begin, end, counter };
+    if (counter != NULL) atomic_fetch_add_explicit(&counter->value, 1, memory_order_relaxed);
+
+    if (JobSystem_ThreadCount(jobs) <= 1 || !QueuePushBack(&jobs->queues[JobSystem_ThreadIndex(jobs)], &job))
+    {
+        RunJob(&job);
+        return;
+    }
+
+    atomic_fetch_add_explicit(&jobs->queued, 1, memory_order_release);
+    pthread_mutex_lock(&jobs->sleep_lock);
+    pthread_cond_signal(&jobs->wake);
+    pthread_mutex_unlock(&jobs->sleep_lock);
+}
+
+void JobSystem_Wait(JobSystem *jobs, JobCounter *counter)
+{
+    int self = JobSystem_ThreadIndex(jobs);
+    while (atomic_load_explicit(&counter->value, memory_order_acquire) > 0)
+    {
+        Job job;
+        if (JobSystem_ThreadCount(jobs) > 1 && TakeJob(jobs, self, &job)) RunJob(&job);
+        else sched_yield();
+    }
+}
+
+int JobSystem_ParallelFor(JobSystem *jobs, int count, int grain, JobFn fn, void *user)
+{
+    if (count <= 0) return 0;
+    if (grain < 1) grain = 1;
+    if (JobSystem_ThreadCount(jobs) <= 1 || count <= grain)
+    {
+        fn(user, 0, count);
+        return 1;
+    }
+
+    JobCounter counter;
+    JobCounter_Init(&counter);
+    int ranges = 0;
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        int end = (count - begin > grain) ? begin + grain : count;
+        JobSystem_Submit(jobs, fn, user, begin, end, &counter);
+        ranges++;
+    }
+    JobSystem_Wait(jobs, &counter);
+    return ranges;
+}
@@ -0,0 +1,80 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Small work-stealing job system. Each thread (the caller is thread 0) owns a
+// deque: it pushes and pops at the back, idle threads steal from the front.
+// Completion is tracked with counters: a job decrements its counter when it
+// finishes, and JobSystem_Wait runs queued jobs until the counter reaches
+// zero, so a dependent stage simply waits on the counter of the stage before.
+//
+// A NULL JobSystem (or one with a single thread) runs everything inline on the
+// caller, so systems can take an optional JobSystem without special cases.
+
+#define JOB_SYSTEM_MAX_DEFAULT_THREADS 8
+
+typedef void (*JobFn)(void *user, int begin, int end);
+
+typedef struct JobCounter
+{
+    atomic_int value;
+} JobCounter;
+
+typedef struct Job
+{
+    JobFn fn;
+    void *user;
+    int begin;
+    int end;
+    JobCounter *counter;
+} Job;
+
+typedef struct JobQueue
+{
+    pthread_mutex_t lock;
+    Job *jobs;
+    int head;
+    int count;
+    int capacity;
+} JobQueue;
+
+struct JobWorkerStart;
+
+typedef struct JobSystem
+{
+    int thread_count;
+    pthread_t *threads;
+    struct JobWorkerStart *starts;
+    JobQueue *queues;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t wake;
+    atomic_int queued;
+    atomic_int shutdown;
+} JobSystem;
+
+// thread_count includes the calling thread; values below 1 are treated as 1.
+// Returns 0 if threads could not be started (the system then runs inline).
+int JobSystem_Init(JobSystem *jobs, int thread_count);
+void JobSystem_Shutdown(JobSystem *jobs);
+int JobSystem_ThreadCount(const JobSystem *jobs);
+// Online CPU count, capped at JOB_SYSTEM_MAX_DEFAULT_THREADS.
+int JobSystem_DefaultThreadCount(void);
+// Index of the calling thread in jobs, in [0, thread_count): 0 for the thread
+// that called JobSystem_Init and for any thread outside jobs (e.g. a worker of
+// another system), and for a NULL system.
+int JobSystem_ThreadIndex(const JobSystem *jobs);
+
+void JobCounter_Init(JobCounter *counter);
+// Queues fn(user, begin, end) and adds one to counter (may be NULL).
+void JobSystem_Submit(JobSystem *jobs, JobFn fn, void *user, int begin, int end, JobCounter *counter);
+// Runs queued jobs until counter reaches zero.
+void JobSystem_Wait(JobSystem *jobs, JobCounter *counter);
+
+// Splits [0, count) into ranges of at most grain items, runs them across the
+// threads and returns when all are done. fn must not depend on how the range
+// is split. Returns the number of ranges used.
+int JobSystem_ParallelFor(JobSystem *jobs, int count, int grain, JobFn fn, void *user);
+
+#endif
@@ -1,84 +1,242 @@
 #include "raylib.h"
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "player.h"
 #include "planet.h"
 #include "asteroids.h"
+#include "world.h"
+#include "headless.h"
+#include "job_system.h"
+#include "asset_pack.h"
+#include "asset_loader.h"
+#include "clock.h"
+#include "sprite_batch.h"
+#include "sim_thread.h"
+#include "input_record.h"
+#include "profiler.h"
+#include "world_state.h"
 
-int main(void)
+#define QUICKSAVE_PATH "quicksave.state"
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "usage: %s [--headless] [--steps N] [--seed X] [--asteroids N] [--threads N] [--dt S] [--sim-thread]\n"
+            "       [--trace FILE] [--record FILE] [--replay FILE] [--hash-log FILE] [--pack FILE | --no-pack]\n", program);
+}
+
+// Rolling p50/p99 per profiled scope and thread, indented by nesting depth.
+static void DrawProfilerOverlay(int x, int y)
+{
+    ProfilerScopeSummary scopes[PROFILER_MAX_SCOPES];
+    int count = Profiler_Summarize(scopes, PROFILER_MAX_SCOPES);
+    DrawRectangle(x - 8, y - 6, 400, 24 + count * 16, Fade(BLACK, 0.6f));
+    DrawText("scope                 p50 ms   p99 ms   thread", x, y, 14, RAYWHITE);
+    for (int i = 0; i < count; i++)
+    {
+        const ProfilerScopeSummary *scope = &scopes[i];
+        int row = y + 18 + i * 16;
+        DrawText(scope->name, x + 10 * scope->depth, row, 14, RAYWHITE);
+        DrawText(TextFormat("%7.3f  %7.3f  %4d", scope->p50_ms, scope->p99_ms, scope->thread), x + 200, row, 14,
+                 RAYWHITE);
+    }
+}
+
+int main(int argc, char **argv)
 {
+    int headless = 0;
+    int steps = 3600;
+    int asteroidCount = 0;
+    int threadCount = JobSystem_DefaultThreadCount();
+    float stepSeconds = 0.0f;
+    unsigned int seed = (unsigned int)time(NULL);
+    const char *packPath = ASSET_PACK_DEFAULT_PATH;
+    int simThread = 0;
+    const char *tracePath = NULL;
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    const char *hashLogPath = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0) headless = 1;
+        else if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc) steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned int)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--asteroids") == 0 && i + 1 < argc) asteroidCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--dt") == 0 && i + 1 < argc) stepSeconds = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) packPath = argv[++i];
+        else if (strcmp(argv[i], "--no-pack") == 0) packPath = NULL;
+        else if (strcmp(argv[i], "--sim-thread") == 0) simThread = 1;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) tracePath = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--hash-log") == 0 && i + 1 < argc) hashLogPath = argv[++i];
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Cooked assets when available (see cook_assets); every loader falls
+    // back to the PNGs for anything the pack does not hold.
+    double startupBegin = Clock_NowSeconds();
+    if (packPath != NULL) AssetPack_Mount(packPath);
+
+    // Replays always run headless, at full speed.
+    if (headless || replayPath != NULL)
+    {
+        HeadlessConfig config = { steps, seed, asteroidCount, threadCount, stepSeconds, simThread, tracePath, recordPath, replayPath,
+                                  hashLogPath };
+        int result = Headless_Run(&config);
+        AssetPack_Unmount();
+        return result;
+    }
+
     const int screenWidth = 1280;
     const int screenHeight = 720;
 
-    const float mapWidth = 5000.0f;
-    const float mapHeight = 3000.0f;
-
     InitWindow(screenWidth, screenHeight, "Space Prototype");
     SetTargetFPS(60);
 
-    Texture2D background = LoadTexture("Assets/Textures/Background/Space Background.png");
-    Texture2D beamHeadTex = LoadTexture("Assets/Textures/Lasers/Laser Sprites/04.png");
-    Texture2D beamBodyTex = LoadTexture("Assets/Textures/Lasers/Laser Sprites/23.png");
+    JobSystem jobs;
+    JobSystem_Init(&jobs, threadCount);
 
-    Player player;
-    Player_Init(&player, (Vector2){ mapWidth * 0.5f, mapHeight * 0.5f });
+    // Textures decode on the job system and upload a few per frame, so the
+    // window is live straight away and fills in as assets land.
+    AssetLoader loader;
+    AssetLoader_Init(&loader, &jobs);
+    Texture2D background = {0};
+    Texture2D beamHeadTex = {0};
+    Texture2D beamBodyTex = {0};
+    AssetLoader_RequestTexture(&loader, "Assets/Textures/Background/Space Background.png", &background);
+    AssetLoader_RequestTexture(&loader, "Assets/Textures/Lasers/Laser Sprites/04.png", &beamHeadTex);
+    AssetLoader_RequestTexture(&loader, "Assets/Textures/Lasers/Laser Sprites/23.png", &beamBodyTex);
 
-    Planet planet;
-    Planet_Init(&planet, (Vector2){ mapWidth * 0.5f, mapHeight * 0.3f }, 0.6f);
+    static World world;
+    World_InitAsync(&world, seed, &jobs, &loader);
+    world.asteroids.view_radius = 0.5f * (float)((screenWidth > screenHeight) ? screenWidth : screenHeight);
+    Player *player = &world.player;
 
-    AsteroidSystem asteroids;
-    Asteroids_Init(&asteroids, "Assets/Textures/Asteroids/Stone");
+    Planet planet;
+    Planet_InitAsync(&planet, (Vector2){ world.map_bounds.width * 0.5f, world.map_bounds.height * 0.3f }, 0.6f, &loader);
+    AssetLoader_Start(&loader);
 
     Camera2D camera = {0};
     camera.offset = (Vector2){ screenWidth * 0.5f, screenHeight * 0.5f };
-    camera.target = player.position;
+    camera.target = player->position;
     camera.zoom = 1.0f;
+    TraceLog(LOG_INFO, "startup: %.1f ms (%s)", (Clock_NowSeconds() - startupBegin) * 1000.0,
+             (AssetPack_Mounted() != NULL) ? "asset pack" : "png");
 
-    Rectangle mapBounds = {0.0f, 0.0f, mapWidth, mapHeight};
-    const float beamRange = 180.0f;
-    const float beamDps = 30.0f;
     const float beamBodyScale = 0.75f;
     const float beamHeadScale = 0.65f;
     const float beamStepScale = 0.55f;
-    float popupTimer = 0.0f;
-    float popupInterval = 0.18f;
-    int beamActive = 0;
-    Vector2 beamTargetPos = {0};
     Vector2 beamEndPos = {0};
-    float beamTargetDist = 0.0f;
-    float beamTargetRadius = 0.0f;
+    int loading = 1;
+    int firstFrame = 1;
+    SpriteBatch batch;
+    SpriteBatch_Init(&batch, SPRITE_BACKEND_RAYLIB);
 
-    while (!WindowShouldClose())
-    {
-        float dt = GetFrameTime();
+    // The simulation runs on its own thread at SIM_DT once loading is done
+    // (the loader writes into the world until then); frames draw the latest
+    // two snapshots, interpolated to the present.
+    SimThread sim = {0};
+    int simStarted = 0;
+    InputRecorder recorder = {0};
+    InputRecorder *recording = NULL;
+    WorldState quickSave = {0};
 
-        Player_Update(&player, dt, camera, mapBounds);
-        Planet_Update(&planet, dt);
-        Asteroids_Update(&asteroids, dt, camera, player.position);
-        camera.target = player.position;
-        popupTimer -= dt;
+    PROFILE_THREAD("main", -1);
+    if (tracePath != NULL) Profiler_BeginCapture();
+    int showProfiler = Profiler_Enabled();
 
-        int targetIndex = Asteroids_FindClosest(&asteroids, player.position, beamRange, &beamTargetDist);
-        beamActive = (targetIndex >= 0);
-        if (beamActive)
+    while (!WindowShouldClose())
+    {
+        PROFILE_BEGIN("frame");
+        if (loading)
         {
-            Asteroids_GetInfo(&asteroids, targetIndex, &beamTargetPos, &beamTargetRadius);
-            float damage = beamDps * dt;
-            int destroyed = Asteroids_ApplyDamage(&asteroids, targetIndex, damage);
+            PROFILE_BEGIN("asset_pump");
+            loading = AssetLoader_Pump(&loader, ASSET_LOADER_UPLOAD_BUDGET_MS) > 0;
+            PROFILE_END();
+        }
+        if (IsKeyPressed(KEY_F3)) showProfiler = !showProfiler;
 
-            if (popupTimer <= 0.0f)
+        InputSnapshot input = Input_Sample(camera);
+        if (!loading && !simStarted)
+        {
+            if (recordPath != NULL)
             {
-                Asteroids_AddPopup(&asteroids, beamTargetPos, damage * 10.0f);
-                popupTimer = popupInterval;
+                InputRecordHeader header = InputRecord_Header(&world, 0);
+                if (InputRecorder_Open(&recorder, recordPath, &header)) recording = &recorder;
+                else TraceLog(LOG_WARNING, "record: cannot write %s", recordPath);
             }
-
-            if (destroyed) beamActive = 0;
+            if (!SimThread_Start(&sim, &world, &input, SIM_DT, 0, recording))
+            {
+                TraceLog(LOG_WARNING, "sim: no thread, stepping on the render thread");
+            }
+            simStarted = 1;
         }
+        // Quick save / quick load: the sim thread is parked while the world is
+        // copied, then restarted on it.
+        int quickSaving = IsKeyPressed(KEY_F5);
+        if (simStarted && (quickSaving || IsKeyPressed(KEY_F9)))
+        {
+            SimThread_Free(&sim);
+            if (quickSaving)
+            {
+                if (!WorldState_Capture(&quickSave, &world)) TraceLog(LOG_WARNING, "state: capture failed");
+                else if (!WorldState_Write(&quickSave, NULL, QUICKSAVE_PATH)) TraceLog(LOG_WARNING, "state: could not write %s", QUICKSAVE_PATH);
+                else TraceLog(LOG_INFO, "state: tick %llu saved to %s", (unsigned long long)world.tick, QUICKSAVE_PATH);
+            }
+            else if ((quickSave.size > 0 || WorldState_Read(&quickSave, NULL, QUICKSAVE_PATH)) &&
+                     WorldState_Restore(&world, &quickSave))
+            {
+                TraceLog(LOG_INFO, "state: loaded tick %llu", (unsigned long long)world.tick);
+                // The recording no longer replays from its header.
+                if (recording != NULL)
+                {
+                    if (!InputRecorder_Close(recording)) TraceLog(LOG_WARNING, "record: writing %s failed", recordPath);
+                    else TraceLog(LOG_INFO, "record: stopped at quick load, %llu ticks in %s", (unsigned long long)recorder.ticks, recordPath);
+                    recording = NULL;
+                }
+            }
+            else
+            {
+                TraceLog(LOG_WARNING, "state: no quick save to load");
+            }
+            SimThread_Start(&sim, &world, &input, SIM_DT, 0, recording);
+        }
+        // Once the sim thread runs it owns World: the pose comes from snapshots only.
+        PlayerPose pose = {0};
+        if (!simStarted) pose = Player_Pose(player, world.time);
+        const RenderSnapshot *prevShot = NULL;
+        const RenderSnapshot *curShot = NULL;
+        float alpha = 1.0f;
+        if (simStarted)
+        {
+            PROFILE_BEGIN("snapshot_acquire");
+            SimThread_SetInput(&sim, &input);
+            SimThread_Acquire(&sim);
+            prevShot = SimThread_Prev(&sim);
+            curShot = SimThread_Current(&sim);
+            alpha = SimThread_Alpha(&sim, Clock_NowSeconds());
+            pose = RenderSnapshot_LerpPlayer(prevShot, curShot, alpha);
+            PROFILE_END();
+        }
+        camera.target = pose.position;
 
-        float wheel = GetMouseWheelMove();
-        if (wheel != 0.0f)
+        int beamActive = (curShot != NULL) && curShot->beam_active;
+        Vector2 beamTargetPos = (curShot != NULL) ? curShot->beam_target_pos : pose.position;
+        const float beamRange = (curShot != NULL) ? curShot->beam_range : world.beam_range;
+
+        if (input.wheel != 0.0f)
         {
-            camera.zoom += wheel * 0.1f;
+            camera.zoom += input.wheel * 0.1f;
             if (camera.zoom < 0.2f) camera.zoom = 0.2f;
             if (camera.zoom > 2.5f) camera.zoom = 2.5f;
         }
@@ -88,33 +246,48 @@ int main(void)
 
         BeginMode2D(camera);
 
-        // Draw tiled background across the view for an endless feel.
         Vector2 topLeft = GetScreenToWorld2D((Vector2){0, 0}, camera);
         Vector2 bottomRight = GetScreenToWorld2D((Vector2){(float)screenWidth, (float)screenHeight}, camera);
-        int startX = (int)floorf(topLeft.x / background.width) - 1;
-        int endX = (int)floorf(bottomRight.x / background.width) + 1;
-        int startY = (int)floorf(topLeft.y / background.height) - 1;
-        int endY = (int)floorf(bottomRight.y / background.height) + 1;
+        SpriteBatch_BeginFrame(&batch);
+        SpriteBatch_SetView(&batch, (Rectangle){ topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y });
 
-        for (int y = startY; y <= endY; y++)
+        // Draw tiled background across the view for an endless feel.
+        PROFILE_BEGIN("background");
+        if (background.id != 0)
         {
-            for (int x = startX; x <= endX; x++)
+            Rectangle tileSrc = { 0.0f, 0.0f, (float)background.width, (float)background.height };
+            int startX = (int)floorf(topLeft.x / background.width) - 1;
+            int endX = (int)floorf(bottomRight.x / background.width) + 1;
+            int startY = (int)floorf(topLeft.y / background.height) - 1;
+            int endY = (int)floorf(bottomRight.y / background.height) + 1;
+
+            for (int y = startY; y <= endY; y++)
             {
-                DrawTexture(background, x * background.width, y * background.height, WHITE);
+                for (int x = startX; x <= endX; x++)
+                {
+                    Rectangle tileDst = { (float)(x * background.width), (float)(y * background.height), tileSrc.width, tileSrc.height };
+                    SpriteBatch_Submit(&batch, background, tileSrc, tileDst, (Vector2){0}, 0.0f, WHITE, SPRITE_LAYER_BACKGROUND);
+                }
             }
         }
 
-        DrawRectangleLinesEx(mapBounds, 2.0f, Fade(SKYBLUE, 0.5f));
+        PROFILE_END();
+
+        // The boundary sits between the background and everything else.
+        PROFILE_BEGIN("flush_background");
+        SpriteBatch_Flush(&batch);
+        PROFILE_END();
+        DrawRectangleLinesEx(world.map_bounds, 2.0f, Fade(SKYBLUE, 0.5f));
+        PROFILE_BEGIN("beam_draw");
         if (beamActive && beamBodyTex.id != 0 && beamHeadTex.id != 0)
         {
-            Vector2 dir = { beamTargetPos.x - player.position.x, beamTargetPos.y - player.position.y };
+            Vector2 dir = { beamTargetPos.x - pose.position.x, beamTargetPos.y - pose.position.y };
             float dist = sqrtf(dir.x * dir.x + dir.y * dir.y);
             if (dist > 0.01f)
             {
                 dir.x /= dist;
                 dir.y /= dist;
-                float clamped_dist = (dist > beamRange) ? beamRange : dist;
-                float end_dist = clamped_dist - (beamTargetRadius * 0.95f);
+                float end_dist = (dist > beamRange) ? beamRange : dist;
                 if (end_dist < 12.0f) end_dist = 12.0f;
                 float angle = atan2f(dir.y, dir.x) * RAD2DEG;
                 float body_w = beamBodyTex.width * beamBodyScale;
@@ -123,7 +296,7 @@ int main(void)
                 float head_h = beamHeadTex.height * beamHeadScale;
                 float head_forward = head_w * 0.5f;
 
-                float nose_offset = player.size.y * 0.5f;
+                float nose_offset = player->size.y * 0.5f;
                 float start_dist = nose_offset + body_w * 0.5f;
                 float head_center_dist = end_dist - head_forward * 0.9f;
                 if (head_center_dist < start_dist) head_center_dist = start_dist;
@@ -142,45 +315,123 @@ int main(void)
                 {
                     float dist_along = start_dist + actual_step * i;
                     Vector2 pos = {
-                        player.position.x + dir.x * dist_along,
-                        player.position.y + dir.y * dist_along
+                        pose.position.x + dir.x * dist_along,
+                        pose.position.y + dir.y * dist_along
                     };
                     Rectangle body_dst = { pos.x, pos.y, body_w, body_h };
-                    DrawTexturePro(beamBodyTex, body_src, body_dst, body_origin, angle, WHITE);
-                    DrawTexturePro(beamBodyTex, body_src, body_dst, body_origin, angle, Fade((Color){180, 210, 255, 255}, 0.35f));
+                    SpriteBatch_Submit(&batch, beamBodyTex, body_src, body_dst, body_origin, angle, WHITE, SPRITE_LAYER_BEAM);
+                    SpriteBatch_Submit(&batch, beamBodyTex, body_src, body_dst, body_origin, angle,
+                                       Fade((Color){180, 210, 255, 255}, 0.35f), SPRITE_LAYER_BEAM);
                 }
 
                 beamEndPos = (Vector2){
-                    player.position.x + dir.x * head_center_dist,
-                    player.position.y + dir.y * head_center_dist
+                    pose.position.x + dir.x * head_center_dist,
+                    pose.position.y + dir.y * head_center_dist
                 };
                 Rectangle head_src = {0, 0, (float)beamHeadTex.width, (float)beamHeadTex.height};
                 Rectangle head_dst = { beamEndPos.x, beamEndPos.y, head_w, head_h };
                 Vector2 head_origin = { head_w * 0.5f, head_h * 0.5f };
-                DrawTexturePro(beamHeadTex, head_src, head_dst, head_origin, angle, WHITE);
-                DrawTexturePro(beamHeadTex, head_src, head_dst, head_origin, angle, Fade((Color){200, 230, 255, 255}, 0.35f));
+                SpriteBatch_Submit(&batch, beamHeadTex, head_src, head_dst, head_origin, angle, WHITE, SPRITE_LAYER_BEAM_HEAD);
+                SpriteBatch_Submit(&batch, beamHeadTex, head_src, head_dst, head_origin, angle,
+                                   Fade((Color){200, 230, 255, 255}, 0.35f), SPRITE_LAYER_BEAM_HEAD);
             }
         }
-        Planet_Draw(&planet);
-        Asteroids_Draw(&asteroids);
-        Player_Draw(&player, camera);
+        PROFILE_END();
+        PROFILE_BEGIN("planet_draw");
+        Planet_Draw(&planet, &batch, (float)GetTime());
+        PROFILE_END();
+        if (curShot != NULL)
+        {
+            PROFILE_BEGIN("asteroids_draw");
+            for (int i = 0; i < curShot->asteroid_count; i++)
+            {
+                float x = curShot->asteroid_x[i];
+                float y = curShot->asteroid_y[i];
+                int j = (i < sim.links.count) ? sim.links.prev_index[i] : -1;
+                if (j >= 0)
+                {
+                    x = prevShot->asteroid_x[j] + (x - prevShot->asteroid_x[j]) * alpha;
+                    y = prevShot->asteroid_y[j] + (y - prevShot->asteroid_y[j]) * alpha;
+                }
+                Asteroids_DrawSprite(&world.asteroids, curShot->asteroid_asset[i], x, y, curShot->asteroid_scale[i], &batch);
+            }
+            PROFILE_END();
+            PROFILE_BEGIN("player_draw");
+            Player_Draw(player, &pose, &batch);
+            PROFILE_END();
+        }
+        PROFILE_BEGIN("flush_world");
+        SpriteBatch_Flush(&batch);
+        PROFILE_END();
+        PROFILE_BEGIN("popups_draw");
+        if (curShot != NULL) Asteroids_DrawPopups(curShot->popups, curShot->popup_count);
+        PROFILE_END();
 
         EndMode2D();
 
+        PROFILE_BEGIN("hud");
+
         DrawText("WASD or arrows to move", 20, 20, 20, RAYWHITE);
         DrawText("Hold RMB to boost", 20, 44, 18, RAYWHITE);
         DrawText("Mouse wheel to zoom", 20, 66, 18, RAYWHITE);
         DrawText("Map boundary shown in blue", 20, 88, 18, RAYWHITE);
+        DrawText(TextFormat("Sprites %d  batches %d", batch.stats.drawn, batch.stats.batches), 20, 110, 18, RAYWHITE);
+        if (curShot != NULL)
+        {
+            double latency = (sim.stats.consumed > 0) ? sim.stats.latency_ms_sum / (double)sim.stats.consumed : 0.0;
+            DrawText(TextFormat("Sim %.2f ms  latency %.1f ms  dropped %llu  repeated %llu", curShot->step_ms, latency,
+                                (unsigned long long)curShot->dropped, (unsigned long long)sim.stats.repeated),
+                     20, 132, 18, RAYWHITE);
+        }
+        if (loading)
+        {
+            int resolved = 0;
+            int total = 0;
+            AssetLoader_Progress(&loader, &resolved, &total);
+            DrawText(TextFormat("Loading assets %d/%d", resolved, total), 20, screenHeight - 36, 18, RAYWHITE);
+        }
+        if (showProfiler) DrawProfilerOverlay(screenWidth - 360, 20);
+        PROFILE_END();
 
+        PROFILE_BEGIN("present");
         EndDrawing();
+        PROFILE_END();
+        if (firstFrame)
+        {
+            TraceLog(LOG_INFO, "first frame: %.1f ms", (Clock_NowSeconds() - startupBegin) * 1000.0);
+            firstFrame = 0;
+        }
+        PROFILE_END();
+        Profiler_Collect();
     }
 
+    // The sim thread and outstanding decode jobs write into the world and
+    // planet; settle them before anything is unloaded.
+    if (simStarted) SimThread_Free(&sim);
+    if (recording != NULL)
+    {
+        uint64_t ticks = recording->ticks;
+        if (InputRecorder_Close(recording)) TraceLog(LOG_INFO, "record: %llu ticks written to %s", (unsigned long long)ticks, recordPath);
+        else TraceLog(LOG_WARNING, "record: writing %s failed", recordPath);
+    }
+    WorldState_Free(&quickSave);
+    AssetLoader_Free(&loader);
+    if (tracePath != NULL)
+    {
+        Profiler_Collect();
+        if (!Profiler_Enabled()) TraceLog(LOG_WARNING, "profile: markers compiled out, no trace written");
+        else if (Profiler_WriteChromeTrace(tracePath)) TraceLog(LOG_INFO, "profile: trace written to %s", tracePath);
+        else TraceLog(LOG_WARNING, "profile: could not write %s", tracePath);
+    }
+    Profiler_Shutdown();
+    SpriteBatch_Free(&batch);
     Planet_Unload(&planet);
-    Player_Unload(&player);
-    Asteroids_Unload(&asteroids);
-    UnloadTexture(background);
-    UnloadTexture(beamHeadTex);
-    UnloadTexture(beamBodyTex);
+    World_Unload(&world);
+    JobSystem_Shutdown(&jobs);
+    if (background.id != 0) UnloadTexture(background);
+    if (beamHeadTex.id != 0) UnloadTexture(beamHeadTex);
+    if (beamBodyTex.id != 0) UnloadTexture(beamBodyTex);
+    AssetPack_Unmount();
 
     CloseWindow();
     return 0;
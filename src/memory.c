@@ -0,0 +1,17 @@
+#include "memory.h"
+
+#include <stdlib.h>
+
+int Memory_GrowArray(void **data, int *capacity, int needed, size_t element_size, int min_capacity)
+{
+    if (needed <= *capacity) return 1;
+    int new_capacity = (*capacity > min_capacity) ? *capacity : min_capacity;
+    if (new_capacity < 1) new_capacity = 1;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    void *grown = realloc(*data, (size_t)new_capacity * element_size);
+    if (grown == NULL) return 0;
+    *data = grown;
+    *capacity = new_capacity;
+    return 1;
+}
@@ -0,0 +1,12 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+
+// Geometric growth for heap arrays that live as long as their owning system.
+// Grows *data to hold at least `needed` elements (doubling, starting at
+// `min_capacity`) and leaves existing elements in place. Returns 0 on
+// allocation failure, in which case *data and *capacity are unchanged.
+int Memory_GrowArray(void **data, int *capacity, int needed, size_t element_size, int min_capacity);
+
+#endif
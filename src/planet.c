@@ -1,35 +1,42 @@
 #include "planet.h"
 
+#define PLANET_SHEET_PATH "Assets/Textures/Planets/PlanetSpriteSheet.png"
+#define PLANET_FRAME_SIZE 500
+#define PLANET_FRAME_TIME 0.25f
+
 void Planet_Init(Planet *planet, Vector2 position, float scale)
 {
     *planet = (Planet){0};
     planet->position = position;
     planet->scale = scale;
-    planet->sheet = SpriteSheet_Load(
-        "Assets/Textures/Planets/PlanetSpriteSheet.png",
-        500,
-        500);
-    SpriteAnim_Init(&planet->anim, &planet->sheet, 0.25f);
+    planet->sheet = SpriteSheet_Load(PLANET_SHEET_PATH, PLANET_FRAME_SIZE, PLANET_FRAME_SIZE);
+    planet->clip = SpriteClip_Make(&planet->sheet, 0, 0, PLANET_FRAME_TIME, SPRITE_CLIP_LOOP);
 }
 
-void Planet_Update(Planet *planet, float dt)
+void Planet_InitAsync(Planet *planet, Vector2 position, float scale, AssetLoader *loader)
 {
-    SpriteAnim_Update(&planet->anim, dt);
+    *planet = (Planet){0};
+    planet->position = position;
+    planet->scale = scale;
+    planet->clip = SpriteClip_Make(&planet->sheet, 0, 0, PLANET_FRAME_TIME, SPRITE_CLIP_LOOP);
+    AssetLoader_RequestSheet(loader, PLANET_SHEET_PATH, PLANET_FRAME_SIZE, PLANET_FRAME_SIZE, &planet->sheet, NULL,
+                             0.0f);
 }
 
-void Planet_Draw(Planet *planet)
+void Planet_Draw(const Planet *planet, SpriteBatch *batch, float time)
 {
+    Rectangle frame = SpriteClip_Sample(&planet->clip, time);
     Rectangle dest = {
         planet->position.x,
         planet->position.y,
-        planet->anim.frame.width * planet->scale,
-        planet->anim.frame.height * planet->scale
+        frame.width * planet->scale,
+        frame.height * planet->scale
     };
     Vector2 origin = { dest.width * 0.5f, dest.height * 0.5f };
-    DrawTexturePro(planet->sheet.texture, planet->anim.frame, dest, origin, 0.0f, WHITE);
+    SpriteBatch_Submit(batch, planet->sheet.texture, frame, dest, origin, 0.0f, WHITE, SPRITE_LAYER_PLANET);
 }
 
 void Planet_Unload(Planet *planet)
 {
-    SpriteSheet_Unload(&planet->sheet);
+    if (planet->sheet.texture.id != 0) SpriteSheet_Unload(&planet->sheet);
 }
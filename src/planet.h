@@ -3,18 +3,24 @@
 
 #include "raylib.h"
 #include "spritesheet.h"
+#include "asset_loader.h"
+#include "sprite_batch.h"
 
 typedef struct Planet
 {
     Vector2 position;
     float scale;
     SpriteSheet sheet;
-    SpriteAnim anim;
+    SpriteClip clip;
 } Planet;
 
 void Planet_Init(Planet *planet, Vector2 position, float scale);
-void Planet_Update(Planet *planet, float dt);
-void Planet_Draw(Planet *planet);
+// Planet_Init with the sheet queued on loader; planet must stay in place
+// until the loader has finished.
+void Planet_InitAsync(Planet *planet, Vector2 position, float scale, AssetLoader *loader);
+// The planet is scenery: it animates on the render clock (seconds), not on
+// sim time.
+void Planet_Draw(const Planet *planet, SpriteBatch *batch, float time);
 void Planet_Unload(Planet *planet);
 
 #endif
@@ -3,6 +3,11 @@
 
 #include "raylib.h"
 #include "spritesheet.h"
+#include "input.h"
+#include "asset_loader.h"
+#include "sprite_batch.h"
+
+#define PLAYER_DEFAULT_SIZE 48.0f
 
 typedef struct Player
 {
@@ -11,16 +16,37 @@ typedef struct Player
     float speed;
     float boost_speed;
     float angle;
+    bool boosting;
     Texture2D body;
     SpriteSheet engine_idle_sheet;
     SpriteSheet engine_boost_sheet;
-    SpriteAnim engine_idle_anim;
-    SpriteAnim engine_boost_anim;
+    // Looping engine flares over the sheets above, sampled at sim time.
+    SpriteClip engine_idle_clip;
+    SpriteClip engine_boost_clip;
 } Player;
 
+// What drawing the ship needs from the simulation; captured into render
+// snapshots so the renderer never reads a Player the sim is stepping.
+typedef struct PlayerPose
+{
+    Vector2 position;
+    float angle;
+    bool boosting;
+    // Sim time the engine flare is sampled at.
+    float engine_time;
+} PlayerPose;
+
 void Player_Init(Player *player, Vector2 start_pos);
-void Player_Update(Player *player, float dt, Camera2D camera, Rectangle map_bounds);
-void Player_Draw(Player *player, Camera2D camera);
+void Player_LoadAssets(Player *player);
+// Queues the same assets on loader; the player draws nothing until they land.
+// player must stay in place until the loader has finished.
+void Player_LoadAssetsAsync(Player *player, AssetLoader *loader);
+void Player_Update(Player *player, const InputSnapshot *input, float dt, Rectangle map_bounds);
+// Pose at sim time (World::time).
+PlayerPose Player_Pose(const Player *player, double time);
+// Draws the ship at pose. Only player's textures, clips and size are read;
+// they do not change once loading has finished.
+void Player_Draw(const Player *player, const PlayerPose *pose, SpriteBatch *batch);
 void Player_Unload(Player *player);
 
 #endif
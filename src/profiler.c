@@ -0,0 +1,342 @@
+#include "profiler.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock.h"
+#include "memory.h"
+
+typedef struct ProfileEvent
+{
+    const char *name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int depth;
+} ProfileEvent;
+
+// Single producer (the owning thread), single consumer (Profiler_Collect).
+typedef struct ProfileRing
+{
+    ProfileEvent events[PROFILER_RING_EVENTS];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_int in_use;
+    char name[32];
+} ProfileRing;
+
+typedef struct ProfileCaptured
+{
+    const char *name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    int thread;
+} ProfileCaptured;
+
+typedef struct ProfileScope
+{
+    const char *name;
+    int depth;
+    int thread;
+    uint64_t first_start_ns;
+    uint64_t calls;
+    uint64_t window[PROFILER_WINDOW];
+    int window_count;
+    int window_next;
+} ProfileScope;
+
+typedef struct ProfileOpen
+{
+    const char *name;
+    uint64_t start_ns;
+} ProfileOpen;
+
+static ProfileRing *_Atomic g_rings[PROFILER_MAX_THREADS];
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_ullong g_dropped;
+
+// Collector side (one thread).
+static ProfileScope *g_scopes;
+static int g_scope_count;
+static int g_capturing;
+static ProfileCaptured *g_capture;
+static int g_capture_count;
+static int g_capture_capacity;
+
+static _Thread_local ProfileRing *tls_ring;
+static _Thread_local ProfileOpen tls_open[PROFILER_MAX_DEPTH];
+static _Thread_local int tls_depth;
+
+int Profiler_Enabled(void)
+{
+#ifdef SPACE_GAME_PROFILE
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static void NameRing(ProfileRing *ring, const char *name, int index)
+{
+    if (index >= 0) snprintf(ring->name, sizeof(ring->name), "%s %d", name, index);
+    else snprintf(ring->name, sizeof(ring->name), "%s", name);
+}
+
+// Takes a released ring if there is one, otherwise allocates the next slot.
+static ProfileRing *AcquireRing(const char *name, int index)
+{
+    pthread_mutex_lock(&g_lock);
+    ProfileRing *ring = NULL;
+    for (int i = 0; i < PROFILER_MAX_THREADS && ring == NULL; i++)
+    {
+        ProfileRing *slot = atomic_load_explicit(&g_rings[i], memory_order_relaxed);
+        if (slot == NULL)
+        {
+            slot = (ProfileRing *)calloc(1, sizeof(ProfileRing));
+            if (slot == NULL) break;
+            atomic_init(&slot->head, 0u);
+            atomic_init(&slot->tail, 0u);
+            atomic_init(&slot->in_use, 0);
+            atomic_store_explicit(&g_rings[i], slot, memory_order_release);
+        }
+        if (!atomic_load_explicit(&slot->in_use, memory_order_relaxed))
+        {
+            atomic_store_explicit(&slot->in_use, 1, memory_order_relaxed);
+            NameRing(slot, name, index);
+            ring = slot;
+        }
+    }
+    pthread_mutex_unlock(&g_lock);
+    return ring;
+}
+
+void Profiler_SetThreadName(const char *name, int index)
+{
+    if (tls_ring == NULL)
+    {
+        tls_ring = AcquireRing(name, index);
+        return;
+    }
+    pthread_mutex_lock(&g_lock);
+    NameRing(tls_ring, name, index);
+    pthread_mutex_unlock(&g_lock);
+}
+
+void Profiler_ReleaseThread(void)
+{
+    if (tls_ring == NULL) return;
+    pthread_mutex_lock(&g_lock);
+    atomic_store_explicit(&tls_ring->in_use, 0, memory_order_relaxed);
+    pthread_mutex_unlock(&g_lock);
+    tls_ring = NULL;
+    tls_depth = 0;
+}
+
+void Profiler_Begin(const char *name)
+{
+    int depth = tls_depth++;
+    if (depth >= PROFILER_MAX_DEPTH) return;
+    tls_open[depth] = (ProfileOpen){ name, Clock_NowNs() };
+}
+
+void Profiler_End(void)
+{
+    if (tls_depth == 0) return;
+    int depth = --tls_depth;
+    if (depth >= PROFILER_MAX_DEPTH) return;
+    uint64_t end_ns = Clock_NowNs();
+
+    if (tls_ring == NULL) tls_ring = AcquireRing("thread", -1);
+    ProfileRing *ring = tls_ring;
+    if (ring == NULL)
+    {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= PROFILER_RING_EVENTS)
+    {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    ring->events[head % PROFILER_RING_EVENTS] = (ProfileEvent){ tls_open[depth].name, tls_open[depth].start_ns, end_ns, depth };
+    atomic_store_explicit(&ring->head, head + 1u, memory_order_release);
+}
+
+static ProfileScope *FindScope(const char *name, int depth, int thread, uint64_t start_ns)
+{
+    for (int i = 0; i < g_scope_count; i++)
+    {
+        if (g_scopes[i].thread != thread) continue;
+        if (g_scopes[i].name == name || strcmp(g_scopes[i].name, name) == 0) return &g_scopes[i];
+    }
+    if (g_scope_count >= PROFILER_MAX_SCOPES) return NULL;
+    if (g_scopes == NULL)
+    {
+        g_scopes = (ProfileScope *)calloc(PROFILER_MAX_SCOPES, sizeof(ProfileScope));
+        if (g_scopes == NULL) return NULL;
+    }
+    ProfileScope *scope = &g_scopes[g_scope_count++];
+    memset(scope, 0, sizeof(*scope));
+    scope->name = name;
+    scope->depth = depth;
+    scope->thread = thread;
+    scope->first_start_ns = start_ns;
+    return scope;
+}
+
+static void Record(const ProfileEvent *event, int thread)
+{
+    ProfileScope *scope = FindScope(event->name, event->depth, thread, event->start_ns);
+    if (scope != NULL)
+    {
+        scope->calls++;
+        scope->window[scope->window_next] = event->end_ns - event->start_ns;
+        scope->window_next = (scope->window_next + 1) % PROFILER_WINDOW;
+        if (scope->window_count < PROFILER_WINDOW) scope->window_count++;
+    }
+    if (!g_capturing) return;
+    if (g_capture_count >= PROFILER_MAX_CAPTURE_EVENTS ||
+        !Memory_GrowArray((void **)&g_capture, &g_capture_capacity, g_capture_count + 1, sizeof(ProfileCaptured), 4096))
+    {
+        atomic_fetch_add_explicit(&g_dropped, 1, memory_order_relaxed);
+        return;
+    }
+    g_capture[g_capture_count++] = (ProfileCaptured){ event->name, event->start_ns, event->end_ns, thread };
+}
+
+void Profiler_Collect(void)
+{
+    for (int t = 0; t < PROFILER_MAX_THREADS; t++)
+    {
+        ProfileRing *ring = atomic_load_explicit(&g_rings[t], memory_order_acquire);
+        if (ring == NULL) break;
+        unsigned tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        for (; tail != head; tail++) Record(&ring->events[tail % PROFILER_RING_EVENTS], t);
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+}
+
+static int CompareU64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int CompareSummary(const void *a, const void *b)
+{
+    const ProfileScope *x = *(const ProfileScope *const *)a;
+    const ProfileScope *y = *(const ProfileScope *const *)b;
+    if (x->thread != y->thread) return x->thread - y->thread;
+    return (x->first_start_ns > y->first_start_ns) - (x->first_start_ns < y->first_start_ns);
+}
+
+int Profiler_Summarize(ProfilerScopeSummary *out, int max)
+{
+    ProfileScope *order[PROFILER_MAX_SCOPES];
+    for (int i = 0; i < g_scope_count; i++) order[i] = &g_scopes[i];
+    qsort(order, (size_t)g_scope_count, sizeof(order[0]), CompareSummary);
+
+    int written = 0;
+    for (int i = 0; i < g_scope_count && written < max; i++)
+    {
+        const ProfileScope *scope = order[i];
+        uint64_t sorted[PROFILER_WINDOW];
+        int n = scope->window_count;
+        memcpy(sorted, scope->window, (size_t)n * sizeof(uint64_t));
+        qsort(sorted, (size_t)n, sizeof(uint64_t), CompareU64);
+
+        ProfilerScopeSummary *summary = &out[written++];
+        summary->name = scope->name;
+        summary->depth = scope->depth;
+        summary->thread = scope->thread;
+        summary->samples = n;
+        summary->calls = scope->calls;
+        summary->p50_ms = (n > 0) ? (double)sorted[n / 2] / 1e6 : 0.0;
+        summary->p99_ms = (n > 0) ? (double)sorted[(n * 99) / 100] / 1e6 : 0.0;
+        summary->max_ms = (n > 0) ? (double)sorted[n - 1] / 1e6 : 0.0;
+    }
+    return written;
+}
+
+uint64_t Profiler_Dropped(void)
+{
+    return atomic_load_explicit(&g_dropped, memory_order_relaxed);
+}
+
+void Profiler_BeginCapture(void)
+{
+    g_capturing = 1;
+    g_capture_count = 0;
+}
+
+void Profiler_EndCapture(void)
+{
+    g_capturing = 0;
+}
+
+static void WriteJsonString(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+int Profiler_WriteChromeTrace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) return 0;
+
+    uint64_t origin = UINT64_MAX;
+    for (int i = 0; i < g_capture_count; i++)
+    {
+        if (g_capture[i].start_ns < origin) origin = g_capture[i].start_ns;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int first = 1;
+    pthread_mutex_lock(&g_lock);
+    for (int t = 0; t < PROFILER_MAX_THREADS; t++)
+    {
+        ProfileRing *ring = atomic_load_explicit(&g_rings[t], memory_order_acquire);
+        if (ring == NULL) break;
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n",
+                t);
+        WriteJsonString(file, ring->name);
+        fprintf(file, "}}");
+        first = 0;
+    }
+    pthread_mutex_unlock(&g_lock);
+    for (int i = 0; i < g_capture_count; i++)
+    {
+        const ProfileCaptured *event = &g_capture[i];
+        fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+        WriteJsonString(file, event->name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", event->thread,
+                (double)(event->start_ns - origin) / 1e3, (double)(event->end_ns - event->start_ns) / 1e3);
+        first = 0;
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+void Profiler_Shutdown(void)
+{
+    free(g_capture);
+    free(g_scopes);
+    g_capture = NULL;
+    g_capture_count = 0;
+    g_capture_capacity = 0;
+    g_capturing = 0;
+    g_scopes = NULL;
+    g_scope_count = 0;
+}
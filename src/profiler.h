@@ -0,0 +1,82 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Hierarchical scope profiler. PROFILE_BEGIN/PROFILE_END pairs nest per
+// thread; each closed scope lands, with nanosecond start/end times, in the
+// calling thread's own lock-free ring, which Profiler_Collect drains (once a
+// frame, from one thread) into rolling per-scope windows and, while a capture
+// is running, into a Chrome trace (chrome://tracing, Perfetto).
+//
+// The markers compile to nothing unless SPACE_GAME_PROFILE is defined
+// (-DSPACE_GAME_PROFILE=ON); the rest of the API still links and then simply
+// has nothing to report. Scope names must be string literals (or otherwise
+// outlive the profiler).
+
+#define PROFILER_MAX_THREADS 32
+// Per thread, between two collects; a full ring drops new events.
+#define PROFILER_RING_EVENTS 16384
+#define PROFILER_MAX_DEPTH 32
+// Scopes are kept per (name, thread): a name used on every worker gets one
+// entry per worker.
+#define PROFILER_MAX_SCOPES 256
+// Samples kept per scope for the p50/p99.
+#define PROFILER_WINDOW 240
+// Capture limit, so a forgotten capture cannot grow without bound.
+#define PROFILER_MAX_CAPTURE_EVENTS (1 << 22)
+
+#ifdef SPACE_GAME_PROFILE
+#define PROFILE_BEGIN(name) Profiler_Begin(name)
+#define PROFILE_END() Profiler_End()
+// Labels the calling thread in traces ("worker 3"); index < 0 for no suffix.
+#define PROFILE_THREAD(name, index) Profiler_SetThreadName(name, index)
+// Hands the calling thread's ring back for reuse once it has been drained.
+#define PROFILE_THREAD_EXIT() Profiler_ReleaseThread()
+#else
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END() ((void)0)
+#define PROFILE_THREAD(name, index) ((void)0)
+#define PROFILE_THREAD_EXIT() ((void)0)
+#endif
+
+typedef struct ProfilerScopeSummary
+{
+    const char *name;
+    // Nesting depth the scope was first seen at on its thread, and the thread.
+    int depth;
+    int thread;
+    // Samples in the window; lifetime call count.
+    int samples;
+    uint64_t calls;
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+} ProfilerScopeSummary;
+
+// 1 if the markers are compiled in.
+int Profiler_Enabled(void);
+
+void Profiler_Begin(const char *name);
+void Profiler_End(void);
+void Profiler_SetThreadName(const char *name, int index);
+void Profiler_ReleaseThread(void);
+
+// Drains every thread's ring. Call from one thread only (the main loop).
+void Profiler_Collect(void);
+// Scopes ordered by thread, then by where they first started, so children
+// follow their parent. Returns the number written (at most max).
+int Profiler_Summarize(ProfilerScopeSummary *out, int max);
+// Events lost to full rings or threads beyond PROFILER_MAX_THREADS.
+uint64_t Profiler_Dropped(void);
+
+// Keeps every collected event from now on for Profiler_WriteChromeTrace.
+void Profiler_BeginCapture(void);
+void Profiler_EndCapture(void);
+// Writes the captured events as Chrome trace JSON. Returns 0 on failure.
+int Profiler_WriteChromeTrace(const char *path);
+// Frees the capture and the scope windows; the rings stay (threads may still
+// hold them) and are reused.
+void Profiler_Shutdown(void);
+
+#endif
@@ -0,0 +1,129 @@
+#include "render_snapshot.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+static int ReserveAsteroids(RenderSnapshot *snapshot, int needed)
+{
+    if (needed <= snapshot->asteroid_capacity) return 1;
+    void **columns[] = {
+        (void **)&snapshot->asteroid_x, (void **)&snapshot->asteroid_y, (void **)&snapshot->asteroid_scale,
+        (void **)&snapshot->asteroid_asset
+    };
+    size_t sizes[] = { sizeof(float), sizeof(float), sizeof(float), sizeof(int) };
+    int capacity = snapshot->asteroid_capacity;
+    if (!Memory_GrowArray((void **)&snapshot->asteroid_handles, &capacity, needed, sizeof(AsteroidHandle), 256)) return 0;
+    for (size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++)
+    {
+        int column_capacity = snapshot->asteroid_capacity;
+        if (!Memory_GrowArray(columns[i], &column_capacity, capacity, sizes[i], capacity)) return 0;
+    }
+    snapshot->asteroid_capacity = capacity;
+    return 1;
+}
+
+int RenderSnapshot_Capture(RenderSnapshot *snapshot, const World *world)
+{
+    snapshot->tick = world->tick;
+    snapshot->player = Player_Pose(&world->player, world->time);
+    snapshot->beam_active = world->beam_active;
+    snapshot->beam_target_pos = world->beam_target_pos;
+    snapshot->beam_range = world->beam_range;
+    snapshot->asteroid_count = 0;
+    snapshot->asteroid_slot_count = 0;
+    snapshot->popup_count = 0;
+
+    const AsteroidSystem *asteroids = &world->asteroids;
+    int count = asteroids->pool.count;
+    if (!ReserveAsteroids(snapshot, count) ||
+        !Memory_GrowArray((void **)&snapshot->popups, &snapshot->popup_capacity, asteroids->popup_count,
+                          sizeof(DamagePopup), 32))
+    {
+        return 0;
+    }
+
+    const AsteroidColumns *c = &asteroids->columns;
+    memcpy(snapshot->asteroid_x, c->pos_x, (size_t)count * sizeof(float));
+    memcpy(snapshot->asteroid_y, c->pos_y, (size_t)count * sizeof(float));
+    memcpy(snapshot->asteroid_scale, c->scale, (size_t)count * sizeof(float));
+    memcpy(snapshot->asteroid_asset, c->asset_index, (size_t)count * sizeof(int));
+    uint32_t slot_count = 0;
+    for (int i = 0; i < count; i++)
+    {
+        AsteroidHandle handle = EntityPool_HandleAt(&asteroids->pool, i);
+        snapshot->asteroid_handles[i] = handle;
+        if (handle.index >= slot_count) slot_count = handle.index + 1u;
+    }
+    snapshot->asteroid_count = count;
+    snapshot->asteroid_slot_count = slot_count;
+
+    if (asteroids->popup_count > 0)
+    {
+        memcpy(snapshot->popups, asteroids->popups, (size_t)asteroids->popup_count * sizeof(DamagePopup));
+    }
+    snapshot->popup_count = asteroids->popup_count;
+    return 1;
+}
+
+void RenderSnapshot_Free(RenderSnapshot *snapshot)
+{
+    free(snapshot->asteroid_handles);
+    free(snapshot->asteroid_x);
+    free(snapshot->asteroid_y);
+    free(snapshot->asteroid_scale);
+    free(snapshot->asteroid_asset);
+    free(snapshot->popups);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+void SnapshotLinks_Build(SnapshotLinks *links, const RenderSnapshot *prev, const RenderSnapshot *cur)
+{
+    links->count = 0;
+    if (!Memory_GrowArray((void **)&links->prev_index, &links->prev_capacity, cur->asteroid_count, sizeof(int), 256))
+    {
+        return;
+    }
+    links->count = cur->asteroid_count;
+    uint32_t slots = (prev->asteroid_slot_count > cur->asteroid_slot_count) ? prev->asteroid_slot_count
+                                                                            : cur->asteroid_slot_count;
+    if (!Memory_GrowArray((void **)&links->slot_to_prev, &links->slot_capacity, (int)slots, sizeof(int), 256))
+    {
+        for (int i = 0; i < cur->asteroid_count; i++) links->prev_index[i] = -1;
+        return;
+    }
+
+    for (uint32_t s = 0; s < slots; s++) links->slot_to_prev[s] = -1;
+    for (int j = 0; j < prev->asteroid_count; j++)
+    {
+        links->slot_to_prev[prev->asteroid_handles[j].index] = j;
+    }
+    for (int i = 0; i < cur->asteroid_count; i++)
+    {
+        AsteroidHandle handle = cur->asteroid_handles[i];
+        int j = links->slot_to_prev[handle.index];
+        // A reused slot carries a new generation: a different asteroid.
+        links->prev_index[i] = (j >= 0 && prev->asteroid_handles[j].generation == handle.generation) ? j : -1;
+    }
+}
+
+void SnapshotLinks_Free(SnapshotLinks *links)
+{
+    free(links->prev_index);
+    free(links->slot_to_prev);
+    memset(links, 0, sizeof(*links));
+}
+
+PlayerPose RenderSnapshot_LerpPlayer(const RenderSnapshot *prev, const RenderSnapshot *cur, float alpha)
+{
+    PlayerPose pose = cur->player;
+    const PlayerPose *from = &prev->player;
+    pose.position.x = from->position.x + (cur->player.position.x - from->position.x) * alpha;
+    pose.position.y = from->position.y + (cur->player.position.y - from->position.y) * alpha;
+    float turn = fmodf(cur->player.angle - from->angle + 540.0f, 360.0f) - 180.0f;
+    pose.angle = from->angle + turn * alpha;
+    pose.engine_time = from->engine_time + (cur->player.engine_time - from->engine_time) * alpha;
+    return pose;
+}
@@ -0,0 +1,70 @@
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "world.h"
+
+// Immutable copy of everything the renderer draws from the simulation,
+// captured by the sim thread after a tick. Asteroids keep their handles so
+// the renderer can pair each one with its previous position and interpolate;
+// popups are copied whole. Arrays grow to the high-water mark and are reused.
+typedef struct RenderSnapshot
+{
+    uint64_t tick;
+    // Clock_NowSeconds() at which the tick was due (its place on the fixed
+    // timeline, for interpolation) and at which it was published.
+    double tick_time;
+    double publish_time;
+    // Sim-side instrumentation at publish time.
+    double step_ms;
+    uint64_t published;
+    uint64_t dropped;
+
+    PlayerPose player;
+    int beam_active;
+    Vector2 beam_target_pos;
+    float beam_range;
+
+    int asteroid_count;
+    int asteroid_capacity;
+    AsteroidHandle *asteroid_handles;
+    float *asteroid_x;
+    float *asteroid_y;
+    float *asteroid_scale;
+    int *asteroid_asset;
+    // One past the largest handle index, for SnapshotLinks.
+    uint32_t asteroid_slot_count;
+
+    DamagePopup *popups;
+    int popup_count;
+    int popup_capacity;
+} RenderSnapshot;
+
+// Pairs the asteroids of two consecutive snapshots: prev_index[i] is the
+// index in prev of cur's asteroid i, or -1 if it spawned in between. Only the
+// first count entries are set (0 if building them failed): asteroids past it
+// are drawn without interpolation.
+typedef struct SnapshotLinks
+{
+    int *prev_index;
+    int count;
+    int prev_capacity;
+    int *slot_to_prev;
+    int slot_capacity;
+} SnapshotLinks;
+
+// Returns 0 on allocation failure (the snapshot is then left empty of
+// asteroids and popups).
+int RenderSnapshot_Capture(RenderSnapshot *snapshot, const World *world);
+void RenderSnapshot_Free(RenderSnapshot *snapshot);
+
+void SnapshotLinks_Build(SnapshotLinks *links, const RenderSnapshot *prev, const RenderSnapshot *cur);
+void SnapshotLinks_Free(SnapshotLinks *links);
+
+// Pose between prev (alpha 0) and cur (alpha 1); the angle takes the short
+// way round, the engine flare's time advances smoothly, and the boost flag
+// comes from cur.
+PlayerPose RenderSnapshot_LerpPlayer(const RenderSnapshot *prev, const RenderSnapshot *cur, float alpha);
+
+#endif
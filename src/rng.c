@@ -0,0 +1,72 @@
+#include "rng.h"
+
+// SplitMix64 finaliser: a bijective 64-bit mix with full avalanche.
+static uint64_t Mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+Rng Rng_Create(uint64_t seed, uint64_t stream)
+{
+    Rng rng;
+    rng.key0 = Mix64(seed ^ Mix64(stream + 0x9e3779b97f4a7c15ull));
+    rng.key1 = Mix64(rng.key0 + 0x632be59bd9b4e019ull);
+    rng.counter = 0;
+    return rng;
+}
+
+uint64_t Rng_At(const Rng *rng, uint64_t index)
+{
+    // The key enters twice, around a full mix, so two streams are not just
+    // shifted or permuted copies of each other.
+    uint64_t z = Mix64(index * 0x9e3779b97f4a7c15ull + rng->key0);
+    return Mix64(z ^ rng->key1);
+}
+
+float Rng_FloatAt(const Rng *rng, uint64_t index)
+{
+    // Top 24 bits: every float in [0, 1) on a 2^-24 grid, never 1.0f.
+    return (float)(Rng_At(rng, index) >> 40) * (1.0f / 16777216.0f);
+}
+
+uint64_t Rng_NextU64(Rng *rng)
+{
+    return Rng_At(rng, rng->counter++);
+}
+
+float Rng_NextFloat(Rng *rng)
+{
+    return Rng_FloatAt(rng, rng->counter++);
+}
+
+float Rng_Range(Rng *rng, float min, float max)
+{
+    return min + (max - min) * Rng_NextFloat(rng);
+}
+
+int Rng_RangeInt(Rng *rng, int min, int max)
+{
+    if (max <= min) return min;
+    uint64_t span = (uint64_t)((int64_t)max - (int64_t)min) + 1u;
+    // Multiply-shift on the top 32 bits; bias is below 2^-32 * span.
+    uint64_t r = (Rng_NextU64(rng) >> 32) * span >> 32;
+    return (int)((int64_t)min + (int64_t)r);
+}
+
+void Rng_FillFloatsAt(const Rng *rng, uint64_t first, float *out, int count, float min, float max)
+{
+    float scale = max - min;
+    for (int i = 0; i < count; i++)
+    {
+        out[i] = min + scale * Rng_FloatAt(rng, first + (uint64_t)i);
+    }
+}
+
+void Rng_FillFloats(Rng *rng, float *out, int count, float min, float max)
+{
+    if (count <= 0) return;
+    Rng_FillFloatsAt(rng, rng->counter, out, count, min, max);
+    rng->counter += (uint64_t)count;
+}
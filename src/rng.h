@@ -0,0 +1,41 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Counter-based random numbers: every value is a pure function of a 128-bit
+// key (seed + stream) and a 64-bit counter, so value i of a stream can be
+// computed anywhere, in any order, on any thread. The stateful helpers just
+// read the value at `counter` and advance it, which makes drawing N values in
+// one go (or splitting them across jobs) identical to drawing them one by one.
+//
+// Systems own their Rng by value; nothing here is global.
+typedef struct Rng
+{
+    uint64_t key0;
+    uint64_t key1;
+    uint64_t counter;
+} Rng;
+
+// Independent stream `stream` of `seed`; different (seed, stream) pairs give
+// unrelated sequences.
+Rng Rng_Create(uint64_t seed, uint64_t stream);
+
+// Value `index` of the stream, without touching its counter.
+uint64_t Rng_At(const Rng *rng, uint64_t index);
+// Uniform float in [0, 1) from value `index`.
+float Rng_FloatAt(const Rng *rng, uint64_t index);
+
+uint64_t Rng_NextU64(Rng *rng);
+// Uniform float in [0, 1).
+float Rng_NextFloat(Rng *rng);
+float Rng_Range(Rng *rng, float min, float max);
+// Uniform int in [min, max] (inclusive, like raylib's GetRandomValue).
+int Rng_RangeInt(Rng *rng, int min, int max);
+
+// out[i] = uniform in [min, max) from value first + i.
+void Rng_FillFloatsAt(const Rng *rng, uint64_t first, float *out, int count, float min, float max);
+// Fills out with the next count values and advances the counter past them.
+void Rng_FillFloats(Rng *rng, float *out, int count, float min, float max);
+
+#endif
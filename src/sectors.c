@@ -0,0 +1,147 @@
+#include "sectors.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+void SectorMap_Init(SectorMap *map)
+{
+    *map = (SectorMap){0};
+}
+
+void SectorMap_Free(SectorMap *map)
+{
+    free(map->sectors);
+    free(map->content);
+    free(map->dirty);
+    *map = (SectorMap){0};
+}
+
+void SectorMap_Clear(SectorMap *map)
+{
+    if (map->sector_count > 0) memset(map->sectors, 0, (size_t)map->sector_count * sizeof(Sector));
+    map->sector_count = 0;
+    map->active = 0;
+    map->dirty_count = 0;
+}
+
+int SectorMap_Cell(float x)
+{
+    return (int)floorf(x / SECTOR_SIZE);
+}
+
+float SectorMap_CellDistanceSq(int cx, int cy, float x, float y)
+{
+    float left = (float)cx * SECTOR_SIZE;
+    float top = (float)cy * SECTOR_SIZE;
+    float dx = (x < left) ? left - x : (x > left + SECTOR_SIZE ? x - left - SECTOR_SIZE : 0.0f);
+    float dy = (y < top) ? top - y : (y > top + SECTOR_SIZE ? y - top - SECTOR_SIZE : 0.0f);
+    return dx * dx + dy * dy;
+}
+
+int SectorMap_Find(const SectorMap *map, int cx, int cy)
+{
+    for (int i = 0; i < map->sector_count; i++)
+    {
+        const Sector *sector = &map->sectors[i];
+        if (sector->status != SECTOR_FREE && sector->cx == cx && sector->cy == cy) return i;
+    }
+    return -1;
+}
+
+int SectorMap_Reserve(SectorMap *map, int needed)
+{
+    if (needed <= map->sector_capacity) return 1;
+    int sector_capacity = map->sector_capacity;
+    int content_capacity = map->sector_capacity;
+    if (!Memory_GrowArray((void **)&map->sectors, &sector_capacity, needed, sizeof(Sector), 16) ||
+        !Memory_GrowArray((void **)&map->content, &content_capacity, needed, sizeof(SectorContent), 16))
+    {
+        return 0;
+    }
+    memset(map->sectors + map->sector_count, 0, (size_t)(sector_capacity - map->sector_count) * sizeof(Sector));
+    map->sector_capacity = (sector_capacity < content_capacity) ? sector_capacity : content_capacity;
+    return 1;
+}
+
+// Index of the first dirty record not ordered before (cx, cy).
+static int DirtyLowerBound(const SectorMap *map, int cx, int cy)
+{
+    int lo = 0;
+    int hi = map->dirty_count;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        const SectorDirty *d = &map->dirty[mid];
+        if (d->cy < cy || (d->cy == cy && d->cx < cx)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+uint32_t SectorMap_DirtyMask(const SectorMap *map, int cx, int cy)
+{
+    int i = DirtyLowerBound(map, cx, cy);
+    if (i < map->dirty_count && map->dirty[i].cx == cx && map->dirty[i].cy == cy) return map->dirty[i].mined;
+    return 0u;
+}
+
+int SectorMap_Acquire(SectorMap *map, int cx, int cy)
+{
+    int slot = 0;
+    while (slot < map->sector_count && map->sectors[slot].status != SECTOR_FREE) slot++;
+    if (slot == map->sector_count)
+    {
+        if (slot >= map->sector_capacity) return -1;
+        map->sector_count++;
+    }
+    Sector *sector = &map->sectors[slot];
+    *sector = (Sector){0};
+    sector->cx = cx;
+    sector->cy = cy;
+    sector->status = SECTOR_PENDING;
+    sector->mined = SectorMap_DirtyMask(map, cx, cy);
+    map->content[slot].count = 0;
+    map->active++;
+    return slot;
+}
+
+int SectorMap_Release(SectorMap *map, int slot)
+{
+    Sector *sector = &map->sectors[slot];
+    int ok = 1;
+    if (sector->mined != 0u)
+    {
+        // Masks only grow while a sector is active, so an existing record
+        // is simply overwritten.
+        int i = DirtyLowerBound(map, sector->cx, sector->cy);
+        if (i < map->dirty_count && map->dirty[i].cx == sector->cx && map->dirty[i].cy == sector->cy)
+        {
+            map->dirty[i].mined = sector->mined;
+        }
+        else if (Memory_GrowArray((void **)&map->dirty, &map->dirty_capacity, map->dirty_count + 1, sizeof(SectorDirty), 16))
+        {
+            memmove(&map->dirty[i + 1], &map->dirty[i], (size_t)(map->dirty_count - i) * sizeof(SectorDirty));
+            map->dirty[i] = (SectorDirty){ sector->cx, sector->cy, sector->mined };
+            map->dirty_count++;
+        }
+        else
+        {
+            ok = 0;
+        }
+    }
+    *sector = (Sector){0};
+    map->active--;
+    while (map->sector_count > 0 && map->sectors[map->sector_count - 1].status == SECTOR_FREE) map->sector_count--;
+    return ok;
+}
+
+int SectorMap_SetDirty(SectorMap *map, const SectorDirty *dirty, int count)
+{
+    if (!Memory_GrowArray((void **)&map->dirty, &map->dirty_capacity, count, sizeof(SectorDirty), 16)) return 0;
+    if (count > 0) memcpy(map->dirty, dirty, (size_t)count * sizeof(SectorDirty));
+    map->dirty_count = count;
+    return 1;
+}
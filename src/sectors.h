@@ -0,0 +1,113 @@
+#ifndef SECTORS_H
+#define SECTORS_H
+
+#include <stdint.h>
+
+#include "entity_pool.h"
+
+// World streaming bookkeeping: space is cut into square sectors keyed by
+// integer cell coordinates. A sector's content is a pure function of (seed,
+// cell), so a sector that leaves the active area is dropped as a whole and
+// regenerated identically when it comes back; the only thing remembered
+// about it is which of its rocks the player has mined.
+//
+// Each sector holds a SECTOR_GRID x SECTOR_GRID grid of sub-cells with at
+// most one rock each; a rock's sub-cell index is its identity within the
+// sector and its bit in the mined masks.
+//
+// The map only tracks sectors; the asteroid system decides what they contain
+// (see Asteroids_Update).
+
+#define SECTOR_SIZE 1024.0f
+#define SECTOR_GRID 4
+#define SECTOR_MAX_ROCKS (SECTOR_GRID * SECTOR_GRID)
+
+typedef enum SectorStatus
+{
+    SECTOR_FREE = 0,
+    // Requested; content is being generated, rocks not in the world yet.
+    SECTOR_PENDING,
+    SECTOR_LIVE
+} SectorStatus;
+
+// One active sector. Pointer-free, so the array saves as it is.
+typedef struct Sector
+{
+    int32_t cx;
+    int32_t cy;
+    int32_t status;
+    // Bit i: rock i was mined (destroyed by the player).
+    uint32_t mined;
+    // Rocks in the world, by sub-cell; null where there is none (or it has
+    // been destroyed since, in which case the handle is stale).
+    EntityHandle handles[SECTOR_MAX_ROCKS];
+} Sector;
+
+// Generated rock, before it enters the asteroid columns.
+typedef struct SectorRock
+{
+    float pos_x;
+    float pos_y;
+    float vel_x;
+    float vel_y;
+    float hp_max;
+    int32_t asset_index;
+    int32_t scale_bucket;
+    int32_t local;
+} SectorRock;
+
+// Output of a generation job, parallel to the sector array.
+typedef struct SectorContent
+{
+    int count;
+    SectorRock rocks[SECTOR_MAX_ROCKS];
+} SectorContent;
+
+// Mined mask of a sector that is not active, kept so it regenerates mined.
+typedef struct SectorDirty
+{
+    int32_t cx;
+    int32_t cy;
+    uint32_t mined;
+} SectorDirty;
+
+typedef struct SectorMap
+{
+    // Slots; freed ones are reused lowest first, so slot numbers (and the
+    // order sectors are handled in) only depend on the request order.
+    Sector *sectors;
+    SectorContent *content;
+    int sector_count;
+    int sector_capacity;
+    int active;
+    // Sorted by (cy, cx) for binary search.
+    SectorDirty *dirty;
+    int dirty_count;
+    int dirty_capacity;
+} SectorMap;
+
+void SectorMap_Init(SectorMap *map);
+void SectorMap_Free(SectorMap *map);
+// Drops every sector and dirty record; allocations are kept.
+void SectorMap_Clear(SectorMap *map);
+// Cell containing world coordinate x (either axis).
+int SectorMap_Cell(float x);
+// Squared distance from (x, y) to the cell's square (0 inside it).
+float SectorMap_CellDistanceSq(int cx, int cy, float x, float y);
+// Slot of the active sector at (cx, cy), or -1.
+int SectorMap_Find(const SectorMap *map, int cx, int cy);
+// Ensures `needed` slots exist without reallocating later. Generation jobs
+// write into the content array, so only call this with none in flight.
+int SectorMap_Reserve(SectorMap *map, int needed);
+// New pending sector in a free slot (reserved beforehand), its mined mask
+// taken from the dirty records. Returns the slot.
+int SectorMap_Acquire(SectorMap *map, int cx, int cy);
+// Frees the slot, moving its mined mask to the dirty records. Returns 0 if
+// a dirty record could not be allocated (the mask is then lost).
+int SectorMap_Release(SectorMap *map, int slot);
+uint32_t SectorMap_DirtyMask(const SectorMap *map, int cx, int cy);
+// Replaces the dirty records (for state restore). Returns 0 on allocation
+// failure.
+int SectorMap_SetDirty(SectorMap *map, const SectorDirty *dirty, int count);
+
+#endif
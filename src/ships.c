@@ -0,0 +1,261 @@
+#include "ships.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+#include "profiler.h"
+
+#define SHIPS_STEER_GRAIN 1024
+// Obstacle floats per rock: centre x, centre y, grown radius.
+#define SHIPS_OBSTACLE_STRIDE 3
+
+typedef struct SteerJob
+{
+    ShipSystem *ships;
+    float dt;
+} SteerJob;
+
+static Vector2 NormalizeSafe(Vector2 v)
+{
+    float len = sqrtf(v.x * v.x + v.y * v.y);
+    if (len < 0.0001f) return (Vector2){0.0f, 0.0f};
+    return (Vector2){ v.x / len, v.y / len };
+}
+
+Vector2 Ship_Move(Vector2 position, Vector2 dir, float speed, float dt)
+{
+    if (dir.x != 0.0f || dir.y != 0.0f)
+    {
+        dir = NormalizeSafe(dir);
+        position.x += dir.x * speed * dt;
+        position.y += dir.y * speed * dt;
+    }
+    return position;
+}
+
+Vector2 Ship_Clamp(Vector2 position, Vector2 half_size, Rectangle bounds)
+{
+    if (bounds.width <= 0.0f) return position;
+
+    if (position.x < bounds.x + half_size.x) position.x = bounds.x + half_size.x;
+    if (position.y < bounds.y + half_size.y) position.y = bounds.y + half_size.y;
+    if (position.x > bounds.x + bounds.width - half_size.x) position.x = bounds.x + bounds.width - half_size.x;
+    if (position.y > bounds.y + bounds.height - half_size.y) position.y = bounds.y + bounds.height - half_size.y;
+    return position;
+}
+
+void Ships_Init(ShipSystem *ships, Vector2 half_size, Rectangle map_bounds)
+{
+    memset(ships, 0, sizeof(*ships));
+    EntityPool_Init(&ships->pool);
+    ships->speed = 200.0f;
+    ships->boost_speed = 420.0f;
+    ships->half_size = half_size;
+    ships->map_bounds = map_bounds;
+    ships->arrive_radius = 2.0f * SHIPS_FIELD_CELL_SIZE;
+}
+
+int Ships_AddGoal(ShipSystem *ships, Vector2 goal, int width, int height)
+{
+    if (!Memory_GrowArray((void **)&ships->fields, &ships->field_capacity, ships->field_count + 1, sizeof(FlowField), 4))
+    {
+        return -1;
+    }
+    if (!FlowField_Init(&ships->fields[ships->field_count], goal, SHIPS_FIELD_CELL_SIZE, width, height)) return -1;
+    return ships->field_count++;
+}
+
+// Grows the pool and every per-ship column together, like the asteroids'.
+static int ReserveShips(ShipSystem *ships, int needed)
+{
+    if (!EntityPool_Reserve(&ships->pool, needed)) return 0;
+    int capacity = ships->pool.dense_capacity;
+    if (capacity <= ships->ship_capacity) return 1;
+
+    ShipColumns *c = &ships->columns;
+    void **float_columns[] = { (void **)&c->pos_x, (void **)&c->pos_y, (void **)&c->angle };
+    for (size_t i = 0; i < sizeof(float_columns) / sizeof(float_columns[0]); i++)
+    {
+        int column_capacity = ships->ship_capacity;
+        if (!Memory_GrowArray(float_columns[i], &column_capacity, capacity, sizeof(float), capacity)) return 0;
+    }
+    int goal_capacity = ships->ship_capacity;
+    if (!Memory_GrowArray((void **)&c->goal, &goal_capacity, capacity, sizeof(int), capacity)) return 0;
+    int boost_capacity = ships->ship_capacity;
+    if (!Memory_GrowArray((void **)&c->boosting, &boost_capacity, capacity, 1, capacity)) return 0;
+    ships->ship_capacity = capacity;
+    return 1;
+}
+
+ShipHandle Ships_Spawn(ShipSystem *ships, Vector2 position, int goal)
+{
+    if (goal < 0 || goal >= ships->field_count) return ENTITY_HANDLE_NULL;
+    if (!ReserveShips(ships, ships->pool.count + 1)) return ENTITY_HANDLE_NULL;
+    ShipHandle handle = EntityPool_Create(&ships->pool);
+    if (EntityHandle_IsNull(handle)) return handle;
+
+    int index = ships->pool.count - 1;
+    ShipColumns *c = &ships->columns;
+    const FlowField *field = &ships->fields[goal];
+    c->pos_x[index] = position.x;
+    c->pos_y[index] = position.y;
+    c->angle[index] = atan2f(field->goal.y - position.y, field->goal.x - position.x) * RAD2DEG + 90.0f;
+    c->goal[index] = goal;
+    c->boosting[index] = 0;
+    return handle;
+}
+
+int Ships_Remove(ShipSystem *ships, ShipHandle handle)
+{
+    int index = EntityPool_Resolve(&ships->pool, handle);
+    if (index < 0) return 0;
+    int moved = EntityPool_Remove(&ships->pool, index);
+    if (moved < 0) return 1;
+
+    ShipColumns *c = &ships->columns;
+    c->pos_x[index] = c->pos_x[moved];
+    c->pos_y[index] = c->pos_y[moved];
+    c->angle[index] = c->angle[moved];
+    c->goal[index] = c->goal[moved];
+    c->boosting[index] = c->boosting[moved];
+    return 1;
+}
+
+void Ships_SetBoost(ShipSystem *ships, ShipHandle handle, int boosting)
+{
+    int index = EntityPool_Resolve(&ships->pool, handle);
+    if (index >= 0) ships->columns.boosting[index] = (unsigned char)(boosting != 0);
+}
+
+int Ships_Count(const ShipSystem *ships)
+{
+    return ships->pool.count;
+}
+
+int Ships_GetPosition(const ShipSystem *ships, ShipHandle handle, Vector2 *out_pos)
+{
+    int index = EntityPool_Resolve(&ships->pool, handle);
+    if (index < 0) return 0;
+    *out_pos = (Vector2){ ships->columns.pos_x[index], ships->columns.pos_y[index] };
+    return 1;
+}
+
+// One field per job: every field reads the same gathered circles and owns
+// its grid and scratch.
+static void CommitFieldRange(void *user, int begin, int end)
+{
+    ShipSystem *ships = (ShipSystem *)user;
+    for (int f = begin; f < end; f++)
+    {
+        FlowField *field = &ships->fields[f];
+        FlowField_BeginObstacles(field);
+        for (int i = 0; i < ships->obstacle_count; i++)
+        {
+            const float *disk = &ships->obstacles[i * SHIPS_OBSTACLE_STRIDE];
+            FlowField_AddDisk(field, disk[0], disk[1], disk[2]);
+        }
+        FlowField_CommitObstacles(field, 0);
+    }
+}
+
+void Ships_UpdateNavigation(ShipSystem *ships, const AsteroidSystem *asteroids)
+{
+    PROFILE_BEGIN("ship_navigation");
+    int count = Asteroids_Count(asteroids);
+    ships->obstacle_count = 0;
+    if (!Memory_GrowArray((void **)&ships->obstacles, &ships->obstacle_capacity, count * SHIPS_OBSTACLE_STRIDE,
+                          sizeof(float), 256 * SHIPS_OBSTACLE_STRIDE))
+    {
+        // Keep last tick's obstacles rather than open every blocked cell.
+        PROFILE_END();
+        return;
+    }
+    float grow = (ships->half_size.x > ships->half_size.y) ? ships->half_size.x : ships->half_size.y;
+    for (int i = 0; i < count; i++)
+    {
+        Vector2 center;
+        float radius;
+        if (!Asteroids_GetInfo(asteroids, Asteroids_HandleAt(asteroids, i), &center, &radius)) continue;
+        float *disk = &ships->obstacles[ships->obstacle_count++ * SHIPS_OBSTACLE_STRIDE];
+        disk[0] = center.x;
+        disk[1] = center.y;
+        disk[2] = radius + grow;
+    }
+    JobSystem_ParallelFor(ships->jobs, ships->field_count, 1, CommitFieldRange, ships);
+    PROFILE_END();
+}
+
+// Steering job over ships [begin, end): each ship writes only its own
+// columns, stats go to the running thread's slot.
+static void SteerRange(void *user, int begin, int end)
+{
+    const SteerJob *job = (const SteerJob *)user;
+    ShipSystem *ships = job->ships;
+    int slot = JobSystem_ThreadIndex(ships->jobs);
+    ShipStats *stats = &ships->thread_stats[slot];
+    ShipColumns *c = &ships->columns;
+    float arrive_sq = ships->arrive_radius * ships->arrive_radius;
+    for (int i = begin; i < end; i++)
+    {
+        const FlowField *field = &ships->fields[c->goal[i]];
+        float x = c->pos_x[i];
+        float y = c->pos_y[i];
+        float dx = field->goal.x - x;
+        float dy = field->goal.y - y;
+        if (dx * dx + dy * dy <= arrive_sq)
+        {
+            stats->arrived++;
+            continue;
+        }
+        Vector2 dir = FlowField_Direction(field, x, y);
+        float speed = c->boosting[i] ? ships->boost_speed : ships->speed;
+        Vector2 next = Ship_Move((Vector2){ x, y }, dir, speed, job->dt);
+        next = Ship_Clamp(next, ships->half_size, ships->map_bounds);
+        stats->blocked += FlowField_BlockedAt(field, x, y);
+        if (next.x == x && next.y == y) continue;
+        c->angle[i] = atan2f(next.y - y, next.x - x) * RAD2DEG + 90.0f;
+        c->pos_x[i] = next.x;
+        c->pos_y[i] = next.y;
+        stats->moved++;
+    }
+}
+
+void Ships_Update(ShipSystem *ships, float dt)
+{
+    PROFILE_BEGIN("ship_steering");
+    ships->stats = (ShipStats){0};
+    int threads = JobSystem_ThreadCount(ships->jobs);
+    if (!Memory_GrowArray((void **)&ships->thread_stats, &ships->thread_stats_capacity, threads, sizeof(ShipStats), 1))
+    {
+        PROFILE_END();
+        return;
+    }
+    memset(ships->thread_stats, 0, (size_t)threads * sizeof(ShipStats));
+
+    SteerJob job = { ships, dt };
+    JobSystem_ParallelFor(ships->jobs, ships->pool.count, SHIPS_STEER_GRAIN, SteerRange, &job);
+    for (int t = 0; t < threads; t++)
+    {
+        ships->stats.moved += ships->thread_stats[t].moved;
+        ships->stats.blocked += ships->thread_stats[t].blocked;
+        ships->stats.arrived += ships->thread_stats[t].arrived;
+    }
+    PROFILE_END();
+}
+
+void Ships_Unload(ShipSystem *ships)
+{
+    for (int f = 0; f < ships->field_count; f++) FlowField_Free(&ships->fields[f]);
+    EntityPool_Free(&ships->pool);
+    free(ships->columns.pos_x);
+    free(ships->columns.pos_y);
+    free(ships->columns.angle);
+    free(ships->columns.goal);
+    free(ships->columns.boosting);
+    free(ships->fields);
+    free(ships->obstacles);
+    free(ships->thread_stats);
+    memset(ships, 0, sizeof(*ships));
+}
@@ -0,0 +1,94 @@
+#ifndef SHIPS_H
+#define SHIPS_H
+
+#include "raylib.h"
+#include "asteroids.h"
+#include "entity_pool.h"
+#include "flow_field.h"
+#include "job_system.h"
+
+// Flow field cells: a few per ship length, small enough to thread between
+// neighbouring rocks.
+#define SHIPS_FIELD_CELL_SIZE 32.0f
+
+typedef EntityHandle ShipHandle;
+
+// Per-ship components as structure-of-arrays columns, indexed like
+// AsteroidColumns through the pool.
+typedef struct ShipColumns
+{
+    float *pos_x;
+    float *pos_y;
+    // Heading in degrees (sprite convention: 0 is up), of the last move.
+    float *angle;
+    // Flow field (goal) each ship steers by.
+    int *goal;
+    unsigned char *boosting;
+} ShipColumns;
+
+typedef struct ShipStats
+{
+    // Ships that moved, that were inside a blocked cell and that have
+    // arrived, in the last Ships_Update.
+    int moved;
+    int blocked;
+    int arrived;
+} ShipStats;
+
+// AI ships: the player's kinematics (see Ship_Move) for any number of
+// entities, steered along flow fields shared by every ship seeking the same
+// goal. Columns, goals and scratch are heap arrays that grow geometrically.
+typedef struct ShipSystem
+{
+    EntityPool pool;
+    ShipColumns columns;
+    int ship_capacity;
+    float speed;
+    float boost_speed;
+    // Half the ship's size: obstacles are grown by it and the map clamp
+    // keeps it inside map_bounds (zero width: no clamp).
+    Vector2 half_size;
+    Rectangle map_bounds;
+    // Ships this close to their goal hold position.
+    float arrive_radius;
+    FlowField *fields;
+    int field_count;
+    int field_capacity;
+    // Rock collision circles (centre, grown radius) gathered once per
+    // navigation update and submitted to every field.
+    float *obstacles;
+    int obstacle_count;
+    int obstacle_capacity;
+    // Optional; NULL steers every ship on the calling thread.
+    JobSystem *jobs;
+    ShipStats *thread_stats;
+    int thread_stats_capacity;
+    ShipStats stats;
+} ShipSystem;
+
+// Moves position along dir (normalised here; zero holds still) at speed.
+// The player and every AI ship move through this and Ship_Clamp.
+Vector2 Ship_Move(Vector2 position, Vector2 dir, float speed, float dt);
+// Keeps a box of half_size around position inside bounds (zero width: no clamp).
+Vector2 Ship_Clamp(Vector2 position, Vector2 half_size, Rectangle bounds);
+
+void Ships_Init(ShipSystem *ships, Vector2 half_size, Rectangle map_bounds);
+// New goal with a width x height cell flow field around it; returns its
+// index, or -1 on allocation failure. Its costs are built by the next
+// Ships_UpdateNavigation.
+int Ships_AddGoal(ShipSystem *ships, Vector2 goal, int width, int height);
+// Returns ENTITY_HANDLE_NULL if goal is not a goal index or the pool cannot grow.
+ShipHandle Ships_Spawn(ShipSystem *ships, Vector2 position, int goal);
+int Ships_Remove(ShipSystem *ships, ShipHandle handle);
+void Ships_SetBoost(ShipSystem *ships, ShipHandle handle, int boosting);
+int Ships_Count(const ShipSystem *ships);
+int Ships_GetPosition(const ShipSystem *ships, ShipHandle handle, Vector2 *out_pos);
+// Resubmits every rock's collision circle, grown by the ship's half extent,
+// as obstacles of every goal's field and repairs the fields (once per tick,
+// after the asteroids moved).
+void Ships_UpdateNavigation(ShipSystem *ships, const AsteroidSystem *asteroids);
+// Steers every ship along its goal's field and moves it.
+void Ships_Update(ShipSystem *ships, float dt);
+void Ships_Unload(ShipSystem *ships);
+
+#endif
@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim_thread.h"
+
+#include <string.h>
+#include <time.h>
+
+#include "clock.h"
+#include "profiler.h"
+
+#define SIM_THREAD_FRESH 0x100u
+#define SIM_THREAD_SLOT_MASK 0xffu
+
+static void SleepSeconds(double seconds)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+}
+
+// Runs the next tick if it is due and publishes its snapshot. Returns 0
+// with *wait set to the time until it is due otherwise, or -1 once max_ticks
+// have run.
+static int RunDueTick(SimThread *sim, double *wait)
+{
+    if (sim->max_ticks > 0 && sim->published >= sim->max_ticks) return -1;
+    double due = Clock_NowSeconds();
+    if (sim->tick_seconds > 0.0)
+    {
+        if (due < sim->next_tick)
+        {
+            *wait = sim->next_tick - due;
+            return 0;
+        }
+        if (due - sim->next_tick > SIM_THREAD_MAX_LAG) sim->next_tick = due;
+        due = sim->next_tick;
+    }
+
+    pthread_mutex_lock(&sim->input_lock);
+    InputSnapshot input = sim->input;
+    pthread_mutex_unlock(&sim->input_lock);
+
+    PROFILE_BEGIN("sim_tick");
+    uint64_t step_start = Clock_NowNs();
+    World_Step(sim->world, &input, SIM_DT);
+    double step_ms = (double)(Clock_NowNs() - step_start) / 1e6;
+    if (sim->recorder != NULL) InputRecorder_Tick(sim->recorder, &input, SIM_DT, sim->world);
+    sim->step_ms_sum += step_ms;
+    if (step_ms > sim->step_ms_max) sim->step_ms_max = step_ms;
+
+    PROFILE_BEGIN("snapshot_capture");
+    RenderSnapshot *snapshot = &sim->slots[sim->back];
+    RenderSnapshot_Capture(snapshot, sim->world);
+    PROFILE_END();
+    snapshot->tick_time = due;
+    snapshot->step_ms = step_ms;
+    snapshot->published = ++sim->published;
+    snapshot->dropped = sim->dropped;
+    snapshot->publish_time = Clock_NowSeconds();
+    unsigned old = atomic_exchange_explicit(&sim->shared, (unsigned)sim->back | SIM_THREAD_FRESH, memory_order_acq_rel);
+    if (old & SIM_THREAD_FRESH) sim->dropped++;
+    sim->back = (int)(old & SIM_THREAD_SLOT_MASK);
+    PROFILE_END();
+
+    sim->next_tick += sim->tick_seconds;
+    return 1;
+}
+
+static void *SimMain(void *arg)
+{
+    SimThread *sim = (SimThread *)arg;
+    PROFILE_THREAD("sim", -1);
+    while (atomic_load_explicit(&sim->running, memory_order_relaxed))
+    {
+        double wait = 0.0;
+        int ran = RunDueTick(sim, &wait);
+        if (ran < 0) break;
+        if (ran == 0) SleepSeconds(wait);
+    }
+    atomic_store_explicit(&sim->running, 0, memory_order_release);
+    PROFILE_THREAD_EXIT();
+    return NULL;
+}
+
+int SimThread_Start(SimThread *sim, World *world, const InputSnapshot *input, double tick_seconds, uint64_t max_ticks,
+                    InputRecorder *recorder)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->world = world;
+    sim->recorder = recorder;
+    sim->tick_seconds = tick_seconds;
+    sim->max_ticks = max_ticks;
+    sim->input = *input;
+    pthread_mutex_init(&sim->input_lock, NULL);
+
+    // The renderer starts out holding two copies of the current state.
+    sim->start_time = Clock_NowSeconds();
+    sim->back = 0;
+    atomic_init(&sim->shared, 1u);
+    sim->prev = 2;
+    sim->cur = 3;
+    for (int s = sim->prev; s <= sim->cur; s++)
+    {
+        RenderSnapshot_Capture(&sim->slots[s], world);
+        sim->slots[s].tick_time = sim->start_time;
+        sim->slots[s].publish_time = sim->start_time;
+    }
+    SnapshotLinks_Build(&sim->links, &sim->slots[sim->prev], &sim->slots[sim->cur]);
+
+    sim->next_tick = sim->start_time + sim->tick_seconds;
+
+    // Without a thread the ticks run inline in SimThread_Acquire, like the
+    // job system's single-threaded fallback.
+    atomic_init(&sim->running, 1);
+    sim->started = pthread_create(&sim->thread, NULL, SimMain, sim) == 0;
+    return sim->started;
+}
+
+void SimThread_SetInput(SimThread *sim, const InputSnapshot *input)
+{
+    pthread_mutex_lock(&sim->input_lock);
+    sim->input = *input;
+    pthread_mutex_unlock(&sim->input_lock);
+}
+
+int SimThread_Acquire(SimThread *sim)
+{
+    sim->stats.frames++;
+    if (!sim->started && SimThread_Running(sim))
+    {
+        // Every due tick when paced, one per frame when not.
+        double wait = 0.0;
+        int ran = 0;
+        do
+        {
+            ran = RunDueTick(sim, &wait);
+        } while (ran > 0 && sim->tick_seconds > 0.0);
+        if (ran < 0) atomic_store_explicit(&sim->running, 0, memory_order_relaxed);
+    }
+    if (!(atomic_load_explicit(&sim->shared, memory_order_acquire) & SIM_THREAD_FRESH))
+    {
+        sim->stats.repeated++;
+        return 0;
+    }
+    // Only this thread clears the flag, so the slot is still fresh (or an
+    // even newer one is).
+    unsigned fresh = atomic_exchange_explicit(&sim->shared, (unsigned)sim->prev, memory_order_acq_rel);
+    sim->prev = sim->cur;
+    sim->cur = (int)(fresh & SIM_THREAD_SLOT_MASK);
+
+    const RenderSnapshot *prev = &sim->slots[sim->prev];
+    const RenderSnapshot *cur = &sim->slots[sim->cur];
+    double latency_ms = (Clock_NowSeconds() - cur->publish_time) * 1000.0;
+    sim->stats.consumed++;
+    sim->stats.latency_ms_sum += latency_ms;
+    if (latency_ms > sim->stats.latency_ms_max) sim->stats.latency_ms_max = latency_ms;
+    if (cur->tick > prev->tick + 1) sim->stats.skipped_ticks += cur->tick - prev->tick - 1;
+    SnapshotLinks_Build(&sim->links, prev, cur);
+    return 1;
+}
+
+const RenderSnapshot *SimThread_Prev(const SimThread *sim)
+{
+    return &sim->slots[sim->prev];
+}
+
+const RenderSnapshot *SimThread_Current(const SimThread *sim)
+{
+    return &sim->slots[sim->cur];
+}
+
+float SimThread_Alpha(const SimThread *sim, double now)
+{
+    if (sim->tick_seconds <= 0.0) return 1.0f;
+    float alpha = (float)((now - sim->slots[sim->cur].tick_time) / sim->tick_seconds);
+    if (alpha < 0.0f) return 0.0f;
+    if (alpha > 1.0f) return 1.0f;
+    return alpha;
+}
+
+int SimThread_Running(SimThread *sim)
+{
+    return atomic_load_explicit(&sim->running, memory_order_acquire);
+}
+
+void SimThread_Stop(SimThread *sim)
+{
+    atomic_store_explicit(&sim->running, 0, memory_order_relaxed);
+    if (!sim->started) return;
+    pthread_join(sim->thread, NULL);
+    sim->started = 0;
+}
+
+void SimThread_Free(SimThread *sim)
+{
+    SimThread_Stop(sim);
+    for (int s = 0; s < SIM_THREAD_SLOTS; s++) RenderSnapshot_Free(&sim->slots[s]);
+    SnapshotLinks_Free(&sim->links);
+    pthread_mutex_destroy(&sim->input_lock);
+    memset(sim, 0, sizeof(*sim));
+}
@@ -0,0 +1,100 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "input_record.h"
+#include "render_snapshot.h"
+#include "world.h"
+
+// Runs World_Step on its own thread at a fixed rate and hands the renderer
+// immutable RenderSnapshots, so a slow tick no longer stalls presentation
+// (and a slow frame no longer stalls the sim).
+//
+// Snapshots go through a lock-free triple buffer with one extra slot: the
+// sim writes its back slot and swaps it with the shared one; the renderer
+// swaps the shared slot (when fresh) for the older of the two it holds, so it
+// always has the latest two snapshots to interpolate between. A snapshot
+// replaced before the renderer took it is dropped; a frame that finds
+// nothing new redraws the same pair at a later alpha.
+//
+// While the thread runs it owns the World: the renderer only reads
+// snapshots, plus assets and textures, which do not change once loaded.
+
+#define SIM_THREAD_SLOTS 4
+// Behind the fixed timeline by more than this, the sim skips ahead instead
+// of running a burst of catch-up ticks.
+#define SIM_THREAD_MAX_LAG 0.25
+
+// Render-side instrumentation.
+typedef struct SimThreadStats
+{
+    uint64_t frames;
+    uint64_t consumed;
+    // Frames that found no new snapshot.
+    uint64_t repeated;
+    // Ticks never seen by the renderer (gaps between consecutive snapshots).
+    uint64_t skipped_ticks;
+    // Publish to pickup.
+    double latency_ms_sum;
+    double latency_ms_max;
+} SimThreadStats;
+
+typedef struct SimThread
+{
+    World *world;
+    double tick_seconds;
+    uint64_t max_ticks;
+    pthread_t thread;
+    // 0 if the thread could not be created: ticks then run inline.
+    int started;
+    atomic_int running;
+    double start_time;
+
+    pthread_mutex_t input_lock;
+    InputSnapshot input;
+    // Optional; written on the sim thread, one record per tick.
+    InputRecorder *recorder;
+
+    RenderSnapshot slots[SIM_THREAD_SLOTS];
+    // Slot index, plus SIM_THREAD_FRESH while the renderer has not taken it.
+    atomic_uint shared;
+    // Sim thread only.
+    int back;
+    double next_tick;
+    uint64_t published;
+    uint64_t dropped;
+    double step_ms_sum;
+    double step_ms_max;
+    // Render thread only.
+    int prev;
+    int cur;
+    SnapshotLinks links;
+    SimThreadStats stats;
+} SimThread;
+
+// Starts stepping world every tick_seconds of wall time (<= 0: as fast as
+// possible), feeding it the latest SimThread_SetInput. max_ticks > 0 stops
+// the thread after that many ticks. recorder (may be NULL) gets every tick's
+// input; it belongs to the sim until SimThread_Stop. Returns 0 if the thread
+// could not start; the sim then still runs, inline in SimThread_Acquire.
+int SimThread_Start(SimThread *sim, World *world, const InputSnapshot *input, double tick_seconds, uint64_t max_ticks,
+                    InputRecorder *recorder);
+void SimThread_SetInput(SimThread *sim, const InputSnapshot *input);
+// Render thread, once per frame: takes the newest snapshot if there is one.
+// Returns 1 if the pair changed.
+int SimThread_Acquire(SimThread *sim);
+const RenderSnapshot *SimThread_Prev(const SimThread *sim);
+const RenderSnapshot *SimThread_Current(const SimThread *sim);
+// Interpolation factor between Prev and Current at clock time now: the
+// renderer runs one tick behind the sim, so it is always in [0, 1].
+float SimThread_Alpha(const SimThread *sim, double now);
+int SimThread_Running(SimThread *sim);
+// Stops and joins the thread; the world belongs to the caller again. The
+// sim-side counters (published, dropped, step times) are final after this.
+void SimThread_Stop(SimThread *sim);
+void SimThread_Free(SimThread *sim);
+
+#endif
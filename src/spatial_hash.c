@@ -0,0 +1,243 @@
+#include "spatial_hash.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+static int NextPowerOfTwo(int value)
+{
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+static unsigned int HashCell(int cx, int cy, int table_size)
+{
+    unsigned int h = (unsigned int)cx * 73856093u ^ (unsigned int)cy * 19349663u;
+    return h & (unsigned int)(table_size - 1);
+}
+
+static int ReserveEntries(SpatialHash *hash, int needed)
+{
+    if (needed <= hash->entry_capacity) return 1;
+    int staging_capacity = hash->entry_capacity;
+    int entries_capacity = hash->entry_capacity;
+    if (!Memory_GrowArray((void **)&hash->staging, &staging_capacity, needed, sizeof(SpatialEntry), 256)) return 0;
+    if (!Memory_GrowArray((void **)&hash->entries, &entries_capacity, needed, sizeof(SpatialEntry), 256)) return 0;
+    hash->entry_capacity = (staging_capacity < entries_capacity) ? staging_capacity : entries_capacity;
+    return 1;
+}
+
+void SpatialHash_Init(SpatialHash *hash)
+{
+    *hash = (SpatialHash){0};
+}
+
+void SpatialHash_Begin(SpatialHash *hash, int expected_items, float cell_size)
+{
+    hash->cell_size = (cell_size > 1.0f) ? cell_size : 1.0f;
+    hash->inv_cell_size = 1.0f / hash->cell_size;
+    hash->entry_count = 0;
+    hash->pair_count = 0;
+    hash->stats = (SpatialHashStats){0};
+
+    ReserveEntries(hash, expected_items);
+}
+
+void SpatialHash_Insert(SpatialHash *hash, int item, float x, float y, float radius)
+{
+    if (!ReserveEntries(hash, hash->entry_count + 1)) return;
+
+    SpatialEntry *entry = &hash->staging[hash->entry_count++];
+    entry->item = item;
+    entry->cx = (int)floorf(x * hash->inv_cell_size);
+    entry->cy = (int)floorf(y * hash->inv_cell_size);
+    entry->x = x;
+    entry->y = y;
+    entry->radius = radius;
+}
+
+void SpatialHash_Finish(SpatialHash *hash)
+{
+    int table_size = NextPowerOfTwo(hash->entry_count * 2 + 1);
+    if (table_size != hash->table_size || hash->bucket_start == NULL)
+    {
+        int *starts = (int *)realloc(hash->bucket_start, (size_t)(table_size + 1) * sizeof(int));
+        if (starts == NULL) return;
+        hash->bucket_start = starts;
+        hash->table_size = table_size;
+    }
+
+    // Counting sort by bucket: count, inclusive prefix sum, then scatter in
+    // reverse so insertion order is preserved inside a bucket and pair output
+    // stays deterministic.
+    memset(hash->bucket_start, 0, (size_t)(table_size + 1) * sizeof(int));
+    for (int i = 0; i < hash->entry_count; i++)
+    {
+        hash->bucket_start[HashCell(hash->staging[i].cx, hash->staging[i].cy, table_size)]++;
+    }
+    for (int b = 1; b <= table_size; b++)
+    {
+        hash->bucket_start[b] += hash->bucket_start[b - 1];
+    }
+    for (int i = hash->entry_count - 1; i >= 0; i--)
+    {
+        const SpatialEntry *entry = &hash->staging[i];
+        int slot = --hash->bucket_start[HashCell(entry->cx, entry->cy, table_size)];
+        hash->entries[slot] = *entry;
+    }
+    hash->stats.items = hash->entry_count;
+
+    hash->min_cx = hash->min_cy = 0;
+    hash->max_cx = hash->max_cy = -1;
+    for (int i = 0; i < hash->entry_count; i++)
+    {
+        const SpatialEntry *entry = &hash->entries[i];
+        if (i == 0 || entry->cx < hash->min_cx) hash->min_cx = entry->cx;
+        if (i == 0 || entry->cy < hash->min_cy) hash->min_cy = entry->cy;
+        if (i == 0 || entry->cx > hash->max_cx) hash->max_cx = entry->cx;
+        if (i == 0 || entry->cy > hash->max_cy) hash->max_cy = entry->cy;
+    }
+}
+
+unsigned int SpatialHash_Bucket(const SpatialHash *hash, int cx, int cy)
+{
+    return HashCell(cx, cy, hash->table_size);
+}
+
+int SpatialHash_RemapItem(SpatialHash *hash, float x, float y, int item, int new_item)
+{
+    if (hash->entry_count == 0 || hash->bucket_start == NULL) return 0;
+
+    int cx = (int)floorf(x * hash->inv_cell_size);
+    int cy = (int)floorf(y * hash->inv_cell_size);
+    unsigned int bucket = HashCell(cx, cy, hash->table_size);
+    for (int i = hash->bucket_start[bucket]; i < hash->bucket_start[bucket + 1]; i++)
+    {
+        SpatialEntry *entry = &hash->entries[i];
+        if (entry->item != item || entry->cx != cx || entry->cy != cy) continue;
+        entry->item = new_item;
+        return 1;
+    }
+    return 0;
+}
+
+static void EmitPair(SpatialPairBatch *batch, const SpatialEntry *a, const SpatialEntry *b)
+{
+    batch->stats.candidate_pairs++;
+    float dx = a->x - b->x;
+    float dy = a->y - b->y;
+    float r = a->radius + b->radius;
+    if (dx * dx + dy * dy > r * r) return;
+
+    if (batch->count >= batch->capacity)
+    {
+        if (!Memory_GrowArray((void **)&batch->pairs, &batch->capacity, batch->count + 1, sizeof(SpatialPair), 256)) return;
+    }
+    SpatialPair *pair = &batch->pairs[batch->count++];
+    if (a->item < b->item)
+    {
+        pair->a = a->item;
+        pair->b = b->item;
+    }
+    else
+    {
+        pair->a = b->item;
+        pair->b = a->item;
+    }
+}
+
+// Job over buckets [begin, end); writes only to its own batch.
+static void FindPairsRange(void *user, int begin, int end)
+{
+    // Each entry checks its own cell (later entries only) plus four forward
+    // neighbours, so every unordered neighbouring pair is visited exactly once.
+    static const int forward[4][2] = { {1, 0}, {1, 1}, {0, 1}, {-1, 1} };
+
+    const SpatialHash *hash = (const SpatialHash *)user;
+    SpatialPairBatch *batch = &hash->batches[begin / hash->batch_grain];
+    batch->count = 0;
+    batch->stats = (SpatialHashStats){0};
+
+    for (int b = begin; b < end; b++)
+    {
+        int bucket_begin = hash->bucket_start[b];
+        int bucket_end = hash->bucket_start[b + 1];
+        for (int i = bucket_begin; i < bucket_end; i++)
+        {
+            const SpatialEntry *entry = &hash->entries[i];
+            for (int j = i + 1; j < bucket_end; j++)
+            {
+                const SpatialEntry *other = &hash->entries[j];
+                if (other->cx != entry->cx || other->cy != entry->cy) continue;
+                EmitPair(batch, entry, other);
+            }
+
+            for (int n = 0; n < 4; n++)
+            {
+                int cx = entry->cx + forward[n][0];
+                int cy = entry->cy + forward[n][1];
+                unsigned int bucket = HashCell(cx, cy, hash->table_size);
+                int nb_begin = hash->bucket_start[bucket];
+                int nb_end = hash->bucket_start[bucket + 1];
+                batch->stats.cells_visited++;
+                for (int j = nb_begin; j < nb_end; j++)
+                {
+                    const SpatialEntry *other = &hash->entries[j];
+                    if (other->cx != cx || other->cy != cy) continue;
+                    EmitPair(batch, entry, other);
+                }
+            }
+        }
+    }
+}
+
+int SpatialHash_FindPairs(SpatialHash *hash, JobSystem *jobs)
+{
+    hash->pair_count = 0;
+    if (hash->entry_count == 0 || hash->bucket_start == NULL) return 0;
+
+    // A few batches per thread so stealing can even out dense regions.
+    int threads = JobSystem_ThreadCount(jobs);
+    int grain = hash->table_size / (threads * 4);
+    if (grain < 1024) grain = 1024;
+    int batch_count = (hash->table_size + grain - 1) / grain;
+    if (batch_count > hash->batch_capacity)
+    {
+        SpatialPairBatch *batches = (SpatialPairBatch *)realloc(hash->batches, (size_t)batch_count * sizeof(SpatialPairBatch));
+        if (batches == NULL) return 0;
+        memset(batches + hash->batch_capacity, 0, (size_t)(batch_count - hash->batch_capacity) * sizeof(SpatialPairBatch));
+        hash->batches = batches;
+        hash->batch_capacity = batch_count;
+    }
+    hash->batch_grain = grain;
+    JobSystem_ParallelFor(jobs, hash->table_size, grain, FindPairsRange, hash);
+
+    int total = 0;
+    for (int b = 0; b < batch_count; b++) total += hash->batches[b].count;
+    if (!Memory_GrowArray((void **)&hash->pairs, &hash->pair_capacity, total, sizeof(SpatialPair), 256)) return 0;
+
+    for (int b = 0; b < batch_count; b++)
+    {
+        const SpatialPairBatch *batch = &hash->batches[b];
+        if (batch->count > 0) memcpy(hash->pairs + hash->pair_count, batch->pairs, (size_t)batch->count * sizeof(SpatialPair));
+        hash->pair_count += batch->count;
+        hash->stats.cells_visited += batch->stats.cells_visited;
+        hash->stats.candidate_pairs += batch->stats.candidate_pairs;
+    }
+    hash->stats.emitted_pairs = hash->pair_count;
+    return hash->pair_count;
+}
+
+void SpatialHash_Free(SpatialHash *hash)
+{
+    free(hash->bucket_start);
+    free(hash->staging);
+    free(hash->entries);
+    free(hash->pairs);
+    for (int b = 0; b < hash->batch_capacity; b++) free(hash->batches[b].pairs);
+    free(hash->batches);
+    *hash = (SpatialHash){0};
+}
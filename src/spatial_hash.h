@@ -0,0 +1,86 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "job_system.h"
+
+// Uniform-grid broadphase stored as a hash of cell coordinates.
+// Rebuilt once per tick with a counting sort (O(n), no per-item allocation);
+// storage grows to the high-water mark and is reused across ticks.
+// The cell size must be at least the largest item diameter so overlapping
+// items always land in the same or a neighbouring cell.
+
+typedef struct SpatialEntry
+{
+    int item;
+    int cx;
+    int cy;
+    float x;
+    float y;
+    float radius;
+} SpatialEntry;
+
+typedef struct SpatialPair
+{
+    int a;
+    int b;
+} SpatialPair;
+
+typedef struct SpatialHashStats
+{
+    int items;
+    int cells_visited;
+    int candidate_pairs;
+    int emitted_pairs;
+} SpatialHashStats;
+
+// Pairs found in one contiguous range of buckets. Ranges run in parallel and
+// are concatenated in bucket order, so the pair list does not depend on the
+// thread count.
+typedef struct SpatialPairBatch
+{
+    SpatialPair *pairs;
+    int count;
+    int capacity;
+    SpatialHashStats stats;
+} SpatialPairBatch;
+
+typedef struct SpatialHash
+{
+    float cell_size;
+    float inv_cell_size;
+    int table_size;
+    int *bucket_start;
+    SpatialEntry *staging;
+    SpatialEntry *entries;
+    int entry_count;
+    int entry_capacity;
+    SpatialPair *pairs;
+    int pair_count;
+    int pair_capacity;
+    SpatialPairBatch *batches;
+    int batch_capacity;
+    int batch_grain;
+    // Inclusive cell-coordinate bounds of the inserted items (valid when
+    // entry_count > 0), used by queries to clip their cell ranges.
+    int min_cx;
+    int min_cy;
+    int max_cx;
+    int max_cy;
+    SpatialHashStats stats;
+} SpatialHash;
+
+void SpatialHash_Init(SpatialHash *hash);
+void SpatialHash_Begin(SpatialHash *hash, int expected_items, float cell_size);
+void SpatialHash_Insert(SpatialHash *hash, int item, float x, float y, float radius);
+void SpatialHash_Finish(SpatialHash *hash);
+// Fills hash->pairs; jobs may be NULL to run on the caller.
+int SpatialHash_FindPairs(SpatialHash *hash, JobSystem *jobs);
+// Rewrites the entry for `item` (inserted at x, y) to `new_item` without a
+// rebuild; a negative new_item removes it from queries. Returns 0 if not found.
+int SpatialHash_RemapItem(SpatialHash *hash, float x, float y, int item, int new_item);
+// Bucket for a cell; entries [bucket_start[b], bucket_start[b + 1]) may hold
+// several cells that hash together, so callers must check cx/cy.
+unsigned int SpatialHash_Bucket(const SpatialHash *hash, int cx, int cy);
+void SpatialHash_Free(SpatialHash *hash);
+
+#endif
@@ -0,0 +1,240 @@
+#include "spatial_query.h"
+
+#include <math.h>
+#include <stddef.h>
+
+// Cell coordinate of a world coordinate, clamped so far-away queries cannot
+// overflow int arithmetic on the cell ranges below.
+static int CellOf(const SpatialHash *hash, float v)
+{
+    double c = floor((double)v * (double)hash->inv_cell_size);
+    if (c < -1.0e9) c = -1.0e9;
+    if (c > 1.0e9) c = 1.0e9;
+    return (int)c;
+}
+
+static int Min(int a, int b) { return (a < b) ? a : b; }
+static int Max(int a, int b) { return (a > b) ? a : b; }
+
+static float DistSq(const SpatialEntry *entry, float x, float y)
+{
+    float dx = entry->x - x;
+    float dy = entry->y - y;
+    return dx * dx + dy * dy;
+}
+
+static int IsQueryable(const SpatialHash *hash)
+{
+    return hash->entry_count > 0 && hash->bucket_start != NULL;
+}
+
+// Clips [lo, hi] on both axes to the occupied cell bounds. Returns the number
+// of cells left, or 0 when the range misses every item.
+static double ClipCells(const SpatialHash *hash, int *lo_x, int *lo_y, int *hi_x, int *hi_y)
+{
+    *lo_x = Max(*lo_x, hash->min_cx);
+    *lo_y = Max(*lo_y, hash->min_cy);
+    *hi_x = Min(*hi_x, hash->max_cx);
+    *hi_y = Min(*hi_y, hash->max_cy);
+    if (*lo_x > *hi_x || *lo_y > *hi_y) return 0.0;
+    return ((double)*hi_x - *lo_x + 1.0) * ((double)*hi_y - *lo_y + 1.0);
+}
+
+void SpatialQuery_Radius(const SpatialHash *hash, float x, float y, float radius,
+                         SpatialVisitFn visit, void *user)
+{
+    if (!IsQueryable(hash) || radius < 0.0f) return;
+    float radius_sq = radius * radius;
+
+    int lo_x = CellOf(hash, x - radius);
+    int lo_y = CellOf(hash, y - radius);
+    int hi_x = CellOf(hash, x + radius);
+    int hi_y = CellOf(hash, y + radius);
+    double cells = ClipCells(hash, &lo_x, &lo_y, &hi_x, &hi_y);
+    if (cells <= 0.0) return;
+
+    if (cells > (double)hash->entry_count)
+    {
+        for (int i = 0; i < hash->entry_count; i++)
+        {
+            const SpatialEntry *entry = &hash->entries[i];
+            if (entry->item < 0) continue;
+            float d2 = DistSq(entry, x, y);
+            if (d2 <= radius_sq) visit(user, entry->item, d2);
+        }
+        return;
+    }
+
+    for (int cy = lo_y; cy <= hi_y; cy++)
+    {
+        for (int cx = lo_x; cx <= hi_x; cx++)
+        {
+            unsigned int bucket = SpatialHash_Bucket(hash, cx, cy);
+            for (int i = hash->bucket_start[bucket]; i < hash->bucket_start[bucket + 1]; i++)
+            {
+                const SpatialEntry *entry = &hash->entries[i];
+                if (entry->item < 0 || entry->cx != cx || entry->cy != cy) continue;
+                float d2 = DistSq(entry, x, y);
+                if (d2 <= radius_sq) visit(user, entry->item, d2);
+            }
+        }
+    }
+}
+
+static void VisitInRect(const SpatialEntry *entry, float min_x, float min_y, float max_x, float max_y,
+                        SpatialVisitFn visit, void *user)
+{
+    if (entry->item < 0) return;
+    if (entry->x < min_x || entry->x > max_x || entry->y < min_y || entry->y > max_y) return;
+    visit(user, entry->item, DistSq(entry, 0.5f * (min_x + max_x), 0.5f * (min_y + max_y)));
+}
+
+void SpatialQuery_Rect(const SpatialHash *hash, float min_x, float min_y, float max_x, float max_y,
+                       SpatialVisitFn visit, void *user)
+{
+    if (!IsQueryable(hash) || min_x > max_x || min_y > max_y) return;
+
+    int lo_x = CellOf(hash, min_x);
+    int lo_y = CellOf(hash, min_y);
+    int hi_x = CellOf(hash, max_x);
+    int hi_y = CellOf(hash, max_y);
+    double cells = ClipCells(hash, &lo_x, &lo_y, &hi_x, &hi_y);
+    if (cells <= 0.0) return;
+
+    if (cells > (double)hash->entry_count)
+    {
+        for (int i = 0; i < hash->entry_count; i++)
+        {
+            VisitInRect(&hash->entries[i], min_x, min_y, max_x, max_y, visit, user);
+        }
+        return;
+    }
+
+    for (int cy = lo_y; cy <= hi_y; cy++)
+    {
+        for (int cx = lo_x; cx <= hi_x; cx++)
+        {
+            unsigned int bucket = SpatialHash_Bucket(hash, cx, cy);
+            for (int i = hash->bucket_start[bucket]; i < hash->bucket_start[bucket + 1]; i++)
+            {
+                const SpatialEntry *entry = &hash->entries[i];
+                if (entry->cx != cx || entry->cy != cy) continue;
+                VisitInRect(entry, min_x, min_y, max_x, max_y, visit, user);
+            }
+        }
+    }
+}
+
+// Cell edges are padded by this fraction of a cell so float rounding in the
+// cell assignment can never cull an entry that sits right on an edge.
+#define CELL_SLACK 1.0e-3f
+
+// Squared distance from (x, y) to the nearest point of (padded) cell (cx, cy).
+static float CellDistSq(const SpatialHash *hash, int cx, int cy, float x, float y)
+{
+    float pad = hash->cell_size * CELL_SLACK;
+    float left = (float)cx * hash->cell_size - pad;
+    float top = (float)cy * hash->cell_size - pad;
+    float size = hash->cell_size + 2.0f * pad;
+    float dx = 0.0f;
+    float dy = 0.0f;
+    if (x < left) dx = left - x;
+    else if (x > left + size) dx = x - (left + size);
+    if (y < top) dy = top - y;
+    else if (y > top + size) dy = y - (top + size);
+    return dx * dx + dy * dy;
+}
+
+static float NearestInCell(const SpatialHash *hash, int cx, int cy, float x, float y, float bound,
+                           SpatialNearestFn visit, void *user)
+{
+    if (cx < hash->min_cx || cx > hash->max_cx || cy < hash->min_cy || cy > hash->max_cy) return bound;
+    if (CellDistSq(hash, cx, cy, x, y) > bound) return bound;
+
+    unsigned int bucket = SpatialHash_Bucket(hash, cx, cy);
+    for (int i = hash->bucket_start[bucket]; i < hash->bucket_start[bucket + 1]; i++)
+    {
+        const SpatialEntry *entry = &hash->entries[i];
+        if (entry->item < 0 || entry->cx != cx || entry->cy != cy) continue;
+        float d2 = DistSq(entry, x, y);
+        if (d2 <= bound) bound = visit(user, entry->item, d2);
+    }
+    return bound;
+}
+
+void SpatialQuery_Nearest(const SpatialHash *hash, float x, float y, float max_dist_sq,
+                          SpatialNearestFn visit, void *user)
+{
+    if (!IsQueryable(hash) || max_dist_sq < 0.0f) return;
+
+    float bound = max_dist_sq;
+
+    // Sparse index (e.g. a few dozen items under a long range): walking the
+    // rings would mostly visit empty cells, so test every entry instead.
+    float max_dist = sqrtf(max_dist_sq);
+    int lo_x = CellOf(hash, x - max_dist);
+    int lo_y = CellOf(hash, y - max_dist);
+    int hi_x = CellOf(hash, x + max_dist);
+    int hi_y = CellOf(hash, y + max_dist);
+    double cells = ClipCells(hash, &lo_x, &lo_y, &hi_x, &hi_y);
+    if (cells <= 0.0) return;
+    if (cells > (double)hash->entry_count)
+    {
+        for (int i = 0; i < hash->entry_count; i++)
+        {
+            const SpatialEntry *entry = &hash->entries[i];
+            if (entry->item < 0) continue;
+            float d2 = DistSq(entry, x, y);
+            if (d2 <= bound) bound = visit(user, entry->item, d2);
+        }
+        return;
+    }
+
+    int cx0 = CellOf(hash, x);
+    int cy0 = CellOf(hash, y);
+
+    // Rings closer than the occupied bounds are empty; rings past all four
+    // bounds have nothing left to visit.
+    int first = Max(Max(hash->min_cx - cx0, cx0 - hash->max_cx), Max(hash->min_cy - cy0, cy0 - hash->max_cy));
+    int last = Max(Max(cx0 - hash->min_cx, hash->max_cx - cx0), Max(cy0 - hash->min_cy, hash->max_cy - cy0));
+    if (first < 0) first = 0;
+
+    for (int r = first; r <= last; r++)
+    {
+        // Everything in ring r lies outside the (2r - 1)^2 block of cells
+        // around (cx0, cy0); stop once that block's edge is past the bound.
+        if (r > 0)
+        {
+            float inner_left = (float)(cx0 - r + 1) * hash->cell_size;
+            float inner_top = (float)(cy0 - r + 1) * hash->cell_size;
+            float inner_right = (float)(cx0 + r) * hash->cell_size;
+            float inner_bottom = (float)(cy0 + r) * hash->cell_size;
+            float gap = fminf(fminf(x - inner_left, inner_right - x), fminf(y - inner_top, inner_bottom - y));
+            gap -= hash->cell_size * CELL_SLACK;
+            if (gap > 0.0f && gap * gap > bound) break;
+        }
+
+        if (r == 0)
+        {
+            bound = NearestInCell(hash, cx0, cy0, x, y, bound, visit, user);
+            continue;
+        }
+
+        // Top and bottom rows, then the left and right columns between them,
+        // clipped to the occupied bounds.
+        int row_lo = Max(cx0 - r, hash->min_cx);
+        int row_hi = Min(cx0 + r, hash->max_cx);
+        for (int cx = row_lo; cx <= row_hi; cx++)
+        {
+            bound = NearestInCell(hash, cx, cy0 - r, x, y, bound, visit, user);
+            bound = NearestInCell(hash, cx, cy0 + r, x, y, bound, visit, user);
+        }
+        int col_lo = Max(cy0 - r + 1, hash->min_cy);
+        int col_hi = Min(cy0 + r - 1, hash->max_cy);
+        for (int cy = col_lo; cy <= col_hi; cy++)
+        {
+            bound = NearestInCell(hash, cx0 - r, cy, x, y, bound, visit, user);
+            bound = NearestInCell(hash, cx0 + r, cy, x, y, bound, visit, user);
+        }
+    }
+}
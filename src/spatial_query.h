@@ -0,0 +1,35 @@
+#ifndef SPATIAL_QUERY_H
+#define SPATIAL_QUERY_H
+
+#include "spatial_hash.h"
+
+// Point queries over a finished SpatialHash (entry centres only, radii are
+// ignored). Nothing here allocates: hits are handed to a visitor, which writes
+// them wherever the caller wants. Cost scales with the cells covered by the
+// query, not with the number of items; when the covered cell range is larger
+// than the item count the entries are scanned directly instead.
+// Entries with a negative item (see SpatialHash_RemapItem) are skipped.
+
+typedef void (*SpatialVisitFn)(void *user, int item, float dist_sq);
+
+// Visits every entry with (x - cx)^2 + (y - cy)^2 <= radius^2.
+void SpatialQuery_Radius(const SpatialHash *hash, float x, float y, float radius,
+                         SpatialVisitFn visit, void *user);
+
+// Visits every entry with min <= centre <= max on both axes; dist_sq is
+// measured from the rectangle's centre.
+void SpatialQuery_Rect(const SpatialHash *hash, float min_x, float min_y, float max_x, float max_y,
+                       SpatialVisitFn visit, void *user);
+
+// Nearest-first search: cells are visited in rings around (x, y) and the
+// visitor is called for entries with dist_sq <= the current bound. The visitor
+// returns the new bound (e.g. the k-th best distance once it holds k hits);
+// the search stops when no unvisited cell can hold anything within it. When
+// the scan fallback above kicks in, entries arrive in storage order instead,
+// so visitors must not depend on visiting order beyond the bound they return.
+typedef float (*SpatialNearestFn)(void *user, int item, float dist_sq);
+
+void SpatialQuery_Nearest(const SpatialHash *hash, float x, float y, float max_dist_sq,
+                          SpatialNearestFn visit, void *user);
+
+#endif
@@ -0,0 +1,129 @@
+#include "sprite_atlas.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct PackItem
+{
+    int index;
+    int width;
+    int height;
+} PackItem;
+
+static int CompareTallestFirst(const void *a, const void *b)
+{
+    const PackItem *pa = (const PackItem *)a;
+    const PackItem *pb = (const PackItem *)b;
+    if (pa->height != pb->height) return pb->height - pa->height;
+    if (pa->width != pb->width) return pb->width - pa->width;
+    return pa->index - pb->index;
+}
+
+// Shelf layout at a fixed width. Returns the packed height, or -1 if an item
+// is wider than the atlas.
+static int PackShelves(const PackItem *items, int count, int padding, int width, Rectangle *out_regions)
+{
+    int x = 0;
+    int y = 0;
+    int shelf_height = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const PackItem *item = &items[i];
+        if (item->width > width) return -1;
+        if (x + item->width > width)
+        {
+            y += shelf_height + padding;
+            x = 0;
+            shelf_height = 0;
+        }
+        if (out_regions != NULL)
+        {
+            out_regions[item->index] = (Rectangle){ (float)x, (float)y, (float)item->width, (float)item->height };
+        }
+        x += item->width + padding;
+        if (item->height > shelf_height) shelf_height = item->height;
+    }
+    return y + shelf_height;
+}
+
+int SpriteAtlas_Pack(const int *widths, const int *heights, int count, int padding, int max_size,
+                     Rectangle *out_regions, int *out_width, int *out_height)
+{
+    if (count <= 0) return 0;
+    PackItem *items = malloc((size_t)count * sizeof(PackItem));
+    if (items == NULL) return 0;
+    for (int i = 0; i < count; i++)
+    {
+        items[i] = (PackItem){ i, widths[i], heights[i] };
+    }
+    qsort(items, (size_t)count, sizeof(PackItem), CompareTallestFirst);
+
+    int chosen = 0;
+    for (int width = 64; width <= max_size && chosen == 0; width *= 2)
+    {
+        int height = PackShelves(items, count, padding, width, NULL);
+        if (height < 0) continue;
+        if (height <= width || (width * 2 > max_size && height <= max_size)) chosen = width;
+    }
+    if (chosen > 0)
+    {
+        *out_height = PackShelves(items, count, padding, chosen, out_regions);
+        *out_width = chosen;
+    }
+    free(items);
+    return chosen > 0;
+}
+
+int SpriteAtlas_Build(SpriteAtlas *atlas, const Image *images, int count, Rectangle *out_regions)
+{
+    memset(atlas, 0, sizeof(*atlas));
+    if (count <= 0) return 0;
+
+    int *sizes = malloc((size_t)count * 2 * sizeof(int));
+    if (sizes == NULL) return 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (images[i].format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 || images[i].data == NULL)
+        {
+            free(sizes);
+            return 0;
+        }
+        sizes[i] = images[i].width;
+        sizes[count + i] = images[i].height;
+    }
+    int width = 0;
+    int height = 0;
+    int packed = SpriteAtlas_Pack(sizes, sizes + count, count, SPRITE_ATLAS_PADDING, SPRITE_ATLAS_MAX_SIZE,
+                                  out_regions, &width, &height);
+    free(sizes);
+    if (!packed) return 0;
+
+    // Zeroed, so padding stays transparent.
+    unsigned char *pixels = calloc((size_t)width * (size_t)height, 4);
+    if (pixels == NULL) return 0;
+    for (int i = 0; i < count; i++)
+    {
+        const unsigned char *src = (const unsigned char *)images[i].data;
+        size_t row_bytes = (size_t)images[i].width * 4;
+        int x = (int)out_regions[i].x;
+        int y = (int)out_regions[i].y;
+        for (int row = 0; row < images[i].height; row++)
+        {
+            memcpy(pixels + ((size_t)(y + row) * (size_t)width + (size_t)x) * 4, src + (size_t)row * row_bytes, row_bytes);
+        }
+    }
+
+    Image image = { pixels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    atlas->texture = LoadTextureFromImage(image);
+    free(pixels);
+    if (atlas->texture.id == 0) return 0;
+    atlas->width = width;
+    atlas->height = height;
+    return 1;
+}
+
+void SpriteAtlas_Unload(SpriteAtlas *atlas)
+{
+    if (atlas->texture.id != 0) UnloadTexture(atlas->texture);
+    memset(atlas, 0, sizeof(*atlas));
+}
@@ -0,0 +1,33 @@
+#ifndef SPRITE_ATLAS_H
+#define SPRITE_ATLAS_H
+
+#include "raylib.h"
+
+// Packs many small RGBA8 images into one texture so the sprites drawn from
+// them share a texture, and so a batch. Shelf packing, tallest first; images
+// are separated by transparent padding so point-filtered sampling never
+// bleeds across regions.
+
+#define SPRITE_ATLAS_PADDING 2
+#define SPRITE_ATLAS_MAX_SIZE 4096
+
+typedef struct SpriteAtlas
+{
+    Texture2D texture;
+    int width;
+    int height;
+} SpriteAtlas;
+
+// Layout only (no pixels, no GPU): fills out_regions[i] for a widths[i] x
+// heights[i] image and the atlas size. Picks the narrowest power-of-two width
+// whose packing is no taller than it is wide. Returns 0 if nothing fits in
+// max_size x max_size.
+int SpriteAtlas_Pack(const int *widths, const int *heights, int count, int padding, int max_size,
+                     Rectangle *out_regions, int *out_width, int *out_height);
+// Packs and uploads images (RGBA8). out_regions[i] is images[i]'s source
+// rectangle in atlas->texture. Returns 0 (atlas left empty) if they do not
+// fit or the upload fails.
+int SpriteAtlas_Build(SpriteAtlas *atlas, const Image *images, int count, Rectangle *out_regions);
+void SpriteAtlas_Unload(SpriteAtlas *atlas);
+
+#endif
@@ -0,0 +1,165 @@
+#include "sprite_batch.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+#define SPRITE_KEY_INDEX_BITS 32
+#define SPRITE_KEY_TEXTURE_MASK 0xffffffu
+
+void SpriteBatch_Init(SpriteBatch *batch, SpriteBackend backend)
+{
+    memset(batch, 0, sizeof(*batch));
+    batch->backend = backend;
+    batch->sort = 1;
+}
+
+void SpriteBatch_BeginFrame(SpriteBatch *batch)
+{
+    batch->sprite_count = 0;
+    batch->call_count = 0;
+    batch->stats = (SpriteBatchStats){0};
+}
+
+void SpriteBatch_SetView(SpriteBatch *batch, Rectangle view)
+{
+    batch->cull = 1;
+    batch->view = view;
+}
+
+void SpriteBatch_ClearView(SpriteBatch *batch)
+{
+    batch->cull = 0;
+}
+
+// Conservative test: the farthest corner from the pivot bounds the sprite at
+// any rotation, and far_x + far_y bounds that corner's distance without a
+// square root.
+static int OutsideView(const SpriteBatch *batch, Rectangle dest, Vector2 origin)
+{
+    float far_x = fmaxf(fabsf(origin.x), fabsf(dest.width - origin.x));
+    float far_y = fmaxf(fabsf(origin.y), fabsf(dest.height - origin.y));
+    float reach = far_x + far_y;
+    const Rectangle *view = &batch->view;
+    return dest.x + reach < view->x || dest.x - reach > view->x + view->width ||
+           dest.y + reach < view->y || dest.y - reach > view->y + view->height;
+}
+
+void SpriteBatch_Submit(SpriteBatch *batch, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin,
+                        float rotation, Color tint, int layer)
+{
+    if (texture.id == 0) return;
+    batch->stats.submitted++;
+    if (batch->cull && OutsideView(batch, dest, origin))
+    {
+        batch->stats.culled++;
+        return;
+    }
+    if (!Memory_GrowArray((void **)&batch->sprites, &batch->sprite_capacity, batch->sprite_count + 1,
+                          sizeof(Sprite), 256))
+    {
+        return;
+    }
+    batch->sprites[batch->sprite_count++] = (Sprite){ texture, source, dest, origin, rotation, tint, layer };
+}
+
+// Stable LSD radix sort on the (layer, texture) half of the keys, a byte per
+// pass; passes where every key shares the byte (usually the texture id's top
+// bytes) are skipped. The index half is already ascending, so equal keys stay
+// in submission order.
+static void SortKeys(uint64_t *keys, uint64_t *scratch, int count)
+{
+    uint64_t *src = keys;
+    uint64_t *dst = scratch;
+    for (int shift = SPRITE_KEY_INDEX_BITS; shift < 64; shift += 8)
+    {
+        int counts[256] = {0};
+        for (int i = 0; i < count; i++) counts[(src[i] >> shift) & 0xff]++;
+        if (counts[(src[0] >> shift) & 0xff] == count) continue;
+
+        int offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            int n = counts[b];
+            counts[b] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; i++) dst[counts[(src[i] >> shift) & 0xff]++] = src[i];
+        uint64_t *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys) memcpy(keys, src, (size_t)count * sizeof(uint64_t));
+}
+
+static void EmitBatch(SpriteBatch *batch, const Sprite *first, int count)
+{
+    batch->stats.batches++;
+    if (batch->backend != SPRITE_BACKEND_RECORD) return;
+    if (!Memory_GrowArray((void **)&batch->calls, &batch->call_capacity, batch->call_count + 1,
+                          sizeof(SpriteBatchCall), 64))
+    {
+        return;
+    }
+    batch->calls[batch->call_count++] = (SpriteBatchCall){ first->texture.id, first->layer, count };
+}
+
+void SpriteBatch_Flush(SpriteBatch *batch)
+{
+    int count = batch->sprite_count;
+    batch->stats.flushes++;
+    if (count == 0) return;
+
+    int capacity = batch->key_capacity;
+    if (!Memory_GrowArray((void **)&batch->keys, &capacity, count, sizeof(uint64_t), 256) ||
+        !Memory_GrowArray((void **)&batch->scratch, &batch->key_capacity, count, sizeof(uint64_t), 256))
+    {
+        batch->sprite_count = 0;
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        const Sprite *sprite = &batch->sprites[i];
+        uint64_t layer = (uint64_t)((unsigned)sprite->layer & 0xffu);
+        uint64_t texture = (uint64_t)(sprite->texture.id & SPRITE_KEY_TEXTURE_MASK);
+        batch->keys[i] = (layer << 56) | (texture << SPRITE_KEY_INDEX_BITS) | (uint64_t)i;
+    }
+    if (batch->sort) SortKeys(batch->keys, batch->scratch, count);
+
+    const Sprite *run = NULL;
+    int run_length = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const Sprite *sprite = &batch->sprites[batch->keys[i] & 0xffffffffu];
+        if (run != NULL && (sprite->texture.id != run->texture.id || sprite->layer != run->layer))
+        {
+            EmitBatch(batch, run, run_length);
+            run = NULL;
+        }
+        if (run == NULL)
+        {
+            run = sprite;
+            run_length = 0;
+        }
+        run_length++;
+        if (batch->backend == SPRITE_BACKEND_RAYLIB)
+        {
+            DrawTexturePro(sprite->texture, sprite->source, sprite->dest, sprite->origin, sprite->rotation, sprite->tint);
+        }
+    }
+    EmitBatch(batch, run, run_length);
+
+    batch->stats.drawn += count;
+    batch->sprite_count = 0;
+}
+
+void SpriteBatch_Free(SpriteBatch *batch)
+{
+    free(batch->sprites);
+    free(batch->keys);
+    free(batch->scratch);
+    free(batch->calls);
+    memset(batch, 0, sizeof(*batch));
+}
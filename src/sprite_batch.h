@@ -0,0 +1,101 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <stdint.h>
+
+#include "raylib.h"
+
+// Per-frame sprite buffer. Systems submit sprites (DrawTexturePro arguments
+// plus a layer) instead of drawing; SpriteBatch_Flush sorts them by layer,
+// then texture, and emits each run of equal (layer, texture) as one batch.
+// The sort is stable, so sprites sharing a layer and texture keep their
+// submission order; across textures only the layer order is guaranteed, so
+// anything that must overlap in a fixed order needs its own layer.
+//
+// Backends: RAYLIB draws through DrawTexturePro, whose rlgl batch only
+// issues a GPU draw when the texture changes (or its vertex buffer fills),
+// so one batch here is one draw call. RECORD keeps the batch list instead and
+// touches no GPU state, for benchmarks and headless checks.
+
+// World draw layers, back to front.
+enum
+{
+    SPRITE_LAYER_BACKGROUND,
+    SPRITE_LAYER_BEAM,
+    SPRITE_LAYER_BEAM_HEAD,
+    SPRITE_LAYER_PLANET,
+    SPRITE_LAYER_ASTEROIDS,
+    SPRITE_LAYER_ENGINE,
+    SPRITE_LAYER_SHIP,
+    SPRITE_LAYER_COUNT
+};
+
+typedef enum SpriteBackend
+{
+    SPRITE_BACKEND_RAYLIB,
+    SPRITE_BACKEND_RECORD
+} SpriteBackend;
+
+typedef struct Sprite
+{
+    Texture2D texture;
+    Rectangle source;
+    Rectangle dest;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+    int layer;
+} Sprite;
+
+typedef struct SpriteBatchCall
+{
+    unsigned int texture_id;
+    int layer;
+    int count;
+} SpriteBatchCall;
+
+typedef struct SpriteBatchStats
+{
+    int submitted;
+    int culled;
+    int drawn;
+    int batches;
+    int flushes;
+} SpriteBatchStats;
+
+typedef struct SpriteBatch
+{
+    SpriteBackend backend;
+    // 0 flushes in submission order (batches then split on every texture
+    // change); for comparison only.
+    int sort;
+    int cull;
+    Rectangle view;
+    Sprite *sprites;
+    int sprite_count;
+    int sprite_capacity;
+    // (layer, texture, index) sort keys and radix scratch.
+    uint64_t *keys;
+    uint64_t *scratch;
+    int key_capacity;
+    // RECORD backend: every batch flushed since SpriteBatch_BeginFrame.
+    SpriteBatchCall *calls;
+    int call_count;
+    int call_capacity;
+    SpriteBatchStats stats;
+} SpriteBatch;
+
+void SpriteBatch_Init(SpriteBatch *batch, SpriteBackend backend);
+// Clears stats, recorded calls and any unflushed sprites.
+void SpriteBatch_BeginFrame(SpriteBatch *batch);
+// Sprites entirely outside view (world space) are dropped at submit time.
+void SpriteBatch_SetView(SpriteBatch *batch, Rectangle view);
+void SpriteBatch_ClearView(SpriteBatch *batch);
+// Same arguments as DrawTexturePro. Sprites with no texture are ignored.
+void SpriteBatch_Submit(SpriteBatch *batch, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin,
+                        float rotation, Color tint, int layer);
+// Sorts and draws (or records) everything submitted since the last flush.
+void SpriteBatch_Flush(SpriteBatch *batch);
+void SpriteBatch_Free(SpriteBatch *batch);
+
+#endif
@@ -1,5 +1,17 @@
 #include "spritesheet.h"
+#include <math.h>
 #include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "asset_pack.h"
+
+// Clip time is counted in whole frames as floats; past 2^24 frames (a 0.1 s
+// clip after 19 days) it stops advancing rather than losing integer precision.
+#define SPRITE_CLIP_MAX_STEPS 16777216.0f
 
 static int ClampFrameCount(int value)
 {
@@ -7,10 +19,39 @@ static int ClampFrameCount(int value)
     return value;
 }
 
+static Rectangle GridFrame(const SpriteSheet *sheet, int index)
+{
+    int col = index % sheet->columns;
+    int row = index / sheet->columns;
+    return (Rectangle){ (float)col * sheet->frame_width, (float)row * sheet->frame_height,
+                        (float)sheet->frame_width, (float)sheet->frame_height };
+}
+
+// Fills in the frame table once the grid is known; only for loaded textures.
+static SpriteSheet BuildFrames(SpriteSheet sheet)
+{
+    sheet.frames = (Rectangle *)malloc((size_t)sheet.frame_count * sizeof(Rectangle));
+    if (sheet.frames == NULL) return sheet;
+    for (int i = 0; i < sheet.frame_count; i++) sheet.frames[i] = GridFrame(&sheet, i);
+    return sheet;
+}
+
 SpriteSheet SpriteSheet_LoadAuto(const char *path)
 {
     SpriteSheet sheet = {0};
-    sheet.texture = LoadTexture(path);
+    sheet.texture = AssetPack_LoadTexture(path);
+
+    // The cooker stores the frame table it worked out for this sheet.
+    const AssetPackEntry *entry = AssetPack_Lookup(path);
+    if (sheet.texture.width > 0 && entry != NULL && entry->frame_width > 0 && entry->frame_height > 0)
+    {
+        sheet.frame_width = entry->frame_width;
+        sheet.frame_height = entry->frame_height;
+        sheet.columns = ClampFrameCount(entry->frame_columns);
+        sheet.rows = ClampFrameCount(entry->frame_rows);
+        sheet.frame_count = sheet.columns * sheet.rows;
+        return BuildFrames(sheet);
+    }
 
     if (sheet.texture.width <= 0 || sheet.texture.height <= 0)
     {
@@ -29,13 +70,18 @@ SpriteSheet SpriteSheet_LoadAuto(const char *path)
     sheet.columns = ClampFrameCount(sheet.texture.width / sheet.frame_width);
     sheet.rows = 1;
     sheet.frame_count = sheet.columns * sheet.rows;
-    return sheet;
+    return BuildFrames(sheet);
 }
 
 SpriteSheet SpriteSheet_Load(const char *path, int frame_width, int frame_height)
+{
+    return SpriteSheet_FromTexture(AssetPack_LoadTexture(path), frame_width, frame_height);
+}
+
+SpriteSheet SpriteSheet_FromTexture(Texture2D texture, int frame_width, int frame_height)
 {
     SpriteSheet sheet = {0};
-    sheet.texture = LoadTexture(path);
+    sheet.texture = texture;
 
     if (sheet.texture.width <= 0 || sheet.texture.height <= 0)
     {
@@ -56,12 +102,98 @@ SpriteSheet SpriteSheet_Load(const char *path, int frame_width, int frame_height
     sheet.columns = ClampFrameCount(sheet.texture.width / sheet.frame_width);
     sheet.rows = ClampFrameCount(sheet.texture.height / sheet.frame_height);
     sheet.frame_count = sheet.columns * sheet.rows;
-    return sheet;
+    return BuildFrames(sheet);
 }
 
 void SpriteSheet_Unload(SpriteSheet *sheet)
 {
     UnloadTexture(sheet->texture);
+    free(sheet->frames);
+    sheet->frames = NULL;
+}
+
+Rectangle SpriteSheet_Frame(const SpriteSheet *sheet, int index)
+{
+    if (sheet->frame_count <= 0) return (Rectangle){ 0.0f, 0.0f, (float)sheet->frame_width, (float)sheet->frame_height };
+    if (index < 0) index = 0;
+    if (index >= sheet->frame_count) index = sheet->frame_count - 1;
+    if (sheet->frames != NULL) return sheet->frames[index];
+    return GridFrame(sheet, index);
+}
+
+SpriteClip SpriteClip_Make(const SpriteSheet *sheet, int first, int count, float frame_time, SpriteClipMode mode)
+{
+    return (SpriteClip){ sheet, (first > 0) ? first : 0, (count > 0) ? count : 0, frame_time, mode };
+}
+
+static int ClipFrameCount(const SpriteClip *clip)
+{
+    int count = clip->count;
+    if (count <= 0 && clip->sheet != NULL) count = clip->sheet->frame_count - clip->first;
+    return (count > 0) ? count : 1;
+}
+
+float SpriteClip_Duration(const SpriteClip *clip)
+{
+    return (clip->frame_time > 0.0f) ? clip->frame_time * (float)ClipFrameCount(clip) : 0.0f;
+}
+
+// Both paths below do the same float ops up to the whole number of frames
+// elapsed; from there the results are exact integers.
+int SpriteClip_FrameAt(const SpriteClip *clip, float elapsed)
+{
+    float inv_frame_time = (clip->frame_time > 0.0f) ? 1.0f / clip->frame_time : 0.0f;
+    int count = ClipFrameCount(clip);
+    float steps = ((elapsed > 0.0f) ? elapsed : 0.0f) * inv_frame_time;
+    if (steps > SPRITE_CLIP_MAX_STEPS) steps = SPRITE_CLIP_MAX_STEPS;
+    int step = (int)steps;
+    if (clip->mode == SPRITE_CLIP_ONCE) return clip->first + ((step < count) ? step : count - 1);
+    return clip->first + step % count;
+}
+
+Rectangle SpriteClip_Sample(const SpriteClip *clip, float elapsed)
+{
+    return SpriteSheet_Frame(clip->sheet, SpriteClip_FrameAt(clip, elapsed));
+}
+
+void SpriteClip_ResolveFrames(const SpriteClip *clip, float now, const float *start_times, int count,
+                              int *out_indices)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    float inv_frame_time = (clip->frame_time > 0.0f) ? 1.0f / clip->frame_time : 0.0f;
+    int frames = ClipFrameCount(clip);
+    const __m128 now4 = _mm_set1_ps(now);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 inv4 = _mm_set1_ps(inv_frame_time);
+    const __m128 max4 = _mm_set1_ps(SPRITE_CLIP_MAX_STEPS);
+    const __m128 frames4 = _mm_set1_ps((float)frames);
+    const __m128 inv_frames4 = _mm_set1_ps(1.0f / (float)frames);
+    const __m128 last4 = _mm_set1_ps((float)(frames - 1));
+    const __m128i first4 = _mm_set1_epi32(clip->first);
+    int once = clip->mode == SPRITE_CLIP_ONCE;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 elapsed = _mm_max_ps(_mm_sub_ps(now4, _mm_loadu_ps(start_times + i)), zero4);
+        __m128 steps = _mm_min_ps(_mm_mul_ps(elapsed, inv4), max4);
+        __m128 step = _mm_cvtepi32_ps(_mm_cvttps_epi32(steps));
+        __m128 frame;
+        if (once)
+        {
+            frame = _mm_min_ps(step, last4);
+        }
+        else
+        {
+            // step mod frames: the quotient estimate is off by at most one.
+            __m128 quotient = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(step, inv_frames4)));
+            frame = _mm_sub_ps(step, _mm_mul_ps(quotient, frames4));
+            frame = _mm_sub_ps(frame, _mm_and_ps(_mm_cmpge_ps(frame, frames4), frames4));
+            frame = _mm_add_ps(frame, _mm_and_ps(_mm_cmplt_ps(frame, zero4), frames4));
+        }
+        _mm_storeu_si128((__m128i *)(out_indices + i), _mm_add_epi32(_mm_cvttps_epi32(frame), first4));
+    }
+#endif
+    for (; i < count; i++) out_indices[i] = SpriteClip_FrameAt(clip, now - start_times[i]);
 }
 
 void SpriteAnim_Init(SpriteAnim *anim, SpriteSheet *sheet, float frame_time)
@@ -75,14 +207,10 @@ void SpriteAnim_Init(SpriteAnim *anim, SpriteSheet *sheet, float frame_time)
 void SpriteAnim_Update(SpriteAnim *anim, float dt)
 {
     if (anim->sheet == NULL || anim->sheet->frame_count <= 1) return;
+    SpriteClip clip = SpriteClip_Make(anim->sheet, 0, 0, anim->frame_time, SPRITE_CLIP_LOOP);
+    float loop = SpriteClip_Duration(&clip);
     anim->timer += dt;
-    if (anim->timer >= anim->frame_time)
-    {
-        anim->timer = 0.0f;
-        anim->index = (anim->index + 1) % anim->sheet->frame_count;
-        int col = anim->index % anim->sheet->columns;
-        int row = anim->index / anim->sheet->columns;
-        anim->frame.x = (float)col * anim->sheet->frame_width;
-        anim->frame.y = (float)row * anim->sheet->frame_height;
-    }
+    if (loop > 0.0f && anim->timer >= loop) anim->timer = fmodf(anim->timer, loop);
+    anim->index = SpriteClip_FrameAt(&clip, anim->timer);
+    anim->frame = SpriteSheet_Frame(anim->sheet, anim->index);
 }
@@ -11,12 +11,40 @@ typedef struct SpriteSheet
     int columns;
     int rows;
     int frame_count;
+    // Source rectangle of every frame, row-major; NULL if the texture did
+    // not load (SpriteSheet_Frame then works them out).
+    Rectangle *frames;
 } SpriteSheet;
 
+typedef enum SpriteClipMode
+{
+    SPRITE_CLIP_LOOP = 0,
+    // Plays once and holds the last frame.
+    SPRITE_CLIP_ONCE
+} SpriteClipMode;
+
+// A run of a sheet's frames at a fixed rate. Clips hold no playback state:
+// the frame shown is a function of the time since the clip started, so an
+// animated instance is just a start time and nothing needs updating per
+// tick. Times are float seconds on one shared clock (e.g. World::time).
+typedef struct SpriteClip
+{
+    const SpriteSheet *sheet;
+    int first;
+    // Frames from first; 0 plays to the end of the sheet. Read when
+    // sampling, so a clip can be made before its sheet has loaded.
+    int count;
+    float frame_time;
+    SpriteClipMode mode;
+} SpriteClip;
+
+// Single-instance animation with its own clock: a looping clip over the whole
+// sheet, advanced by SpriteAnim_Update.
 typedef struct SpriteAnim
 {
     SpriteSheet *sheet;
     Rectangle frame;
+    // Time into the current loop.
     float timer;
     float frame_time;
     int index;
@@ -24,9 +52,28 @@ typedef struct SpriteAnim
 
 SpriteSheet SpriteSheet_LoadAuto(const char *path);
 SpriteSheet SpriteSheet_Load(const char *path, int frame_width, int frame_height);
+// Frame table over an already loaded texture (same rules as SpriteSheet_Load).
+SpriteSheet SpriteSheet_FromTexture(Texture2D texture, int frame_width, int frame_height);
 void SpriteSheet_Unload(SpriteSheet *sheet);
+// Source rectangle of frame index (clamped to the sheet).
+Rectangle SpriteSheet_Frame(const SpriteSheet *sheet, int index);
+
+SpriteClip SpriteClip_Make(const SpriteSheet *sheet, int first, int count, float frame_time, SpriteClipMode mode);
+// Length of one play-through in seconds.
+float SpriteClip_Duration(const SpriteClip *clip);
+// Sheet frame index shown elapsed seconds after the clip started (the first
+// frame before it).
+int SpriteClip_FrameAt(const SpriteClip *clip, float elapsed);
+Rectangle SpriteClip_Sample(const SpriteClip *clip, float elapsed);
+// Sheet frame indices at time now of count instances started at
+// start_times, in one SSE2 pass; for drawing many instances of a clip. Gives
+// the same indices as SpriteClip_FrameAt(clip, now - start_times[i]).
+void SpriteClip_ResolveFrames(const SpriteClip *clip, float now, const float *start_times, int count,
+                              int *out_indices);
 
 void SpriteAnim_Init(SpriteAnim *anim, SpriteSheet *sheet, float frame_time);
+// Advances the clock by dt, keeping the remainder, so the frame rate does
+// not drift with the tick rate.
 void SpriteAnim_Update(SpriteAnim *anim, float dt);
 
 #endif
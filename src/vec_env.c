@@ -0,0 +1,195 @@
+#include "vec_env.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rng.h"
+
+#define VEC_ENV_STREAM_EPISODE 1u
+
+#define VEC_ENV_DAMAGE_REWARD 0.1f
+#define VEC_ENV_DESTROY_REWARD 1.0f
+
+// Worlds per job: a few jobs per thread so stealing can even out worlds that
+// happen to be busier, without paying queue traffic per world.
+#define VEC_ENV_JOBS_PER_THREAD 4
+
+static const Vector2 ACTION_DIRECTIONS[VEC_ENV_MOVE_ACTIONS] = {
+    { 0.0f, 0.0f },
+    { 0.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f },
+    { 0.0f, 1.0f }, { -1.0f, 1.0f }, { -1.0f, 0.0f }, { -1.0f, -1.0f },
+};
+
+typedef struct StepJob
+{
+    VecEnv *env;
+    const int *actions;
+    float *obs;
+    float *rewards;
+    float *dones;
+} StepJob;
+
+static unsigned int EpisodeSeed(const VecEnv *env, int world_index)
+{
+    Rng rng = Rng_Create(env->seed, VEC_ENV_STREAM_EPISODE);
+    return (unsigned int)Rng_At(&rng, ((uint64_t)world_index << 32) | env->episodes[world_index]);
+}
+
+static void StartEpisode(VecEnv *env, int world_index)
+{
+    World *world = &env->worlds[world_index];
+    World_Reset(world, EpisodeSeed(env, world_index));
+    if (env->field_asteroids > 0)
+    {
+        Asteroids_SpawnField(&world->asteroids, world->player.position, env->field_asteroids, VEC_ENV_SENSOR_RANGE);
+    }
+}
+
+// The ship faces where it moves; when idle it keeps its current heading.
+static InputSnapshot ActionInput(const World *world, int action)
+{
+    if (action < 0 || action >= VEC_ENV_ACTION_COUNT) action = 0;
+    Vector2 move = ACTION_DIRECTIONS[action % VEC_ENV_MOVE_ACTIONS];
+    Vector2 pos = world->player.position;
+    Vector2 facing = move;
+    if (move.x == 0.0f && move.y == 0.0f)
+    {
+        float heading = (world->player.angle - 90.0f) * DEG2RAD;
+        facing = (Vector2){ cosf(heading), sinf(heading) };
+    }
+
+    InputSnapshot input = Input_Neutral((Vector2){ pos.x + facing.x, pos.y + facing.y });
+    input.move = move;
+    input.boost = action >= VEC_ENV_MOVE_ACTIONS;
+    return input;
+}
+
+static void WriteObservation(const World *world, float *obs)
+{
+    const Player *player = &world->player;
+    const Rectangle *map = &world->map_bounds;
+    obs[0] = 2.0f * (player->position.x - map->x) / map->width - 1.0f;
+    obs[1] = 2.0f * (player->position.y - map->y) / map->height - 1.0f;
+    obs[2] = world->beam_active ? 1.0f : 0.0f;
+    obs[3] = world->beam_active ? world->beam_target_dist / world->beam_range : 0.0f;
+
+    AsteroidHandle handles[VEC_ENV_NEAREST];
+    float dist_sq[VEC_ENV_NEAREST];
+    int found = Asteroids_QueryNearest(&world->asteroids, player->position, VEC_ENV_SENSOR_RANGE,
+                                       VEC_ENV_NEAREST, handles, dist_sq);
+    const float inv_range = 1.0f / VEC_ENV_SENSOR_RANGE;
+    float *slot = obs + 4;
+    for (int k = 0; k < VEC_ENV_NEAREST; k++, slot += VEC_ENV_SLOT_DIM)
+    {
+        Vector2 pos;
+        float radius = 0.0f;
+        float hp = 0.0f;
+        float hp_max = 0.0f;
+        if (k >= found || !Asteroids_GetInfo(&world->asteroids, handles[k], &pos, &radius) ||
+            !Asteroids_GetHealth(&world->asteroids, handles[k], &hp, &hp_max))
+        {
+            memset(slot, 0, VEC_ENV_SLOT_DIM * sizeof(float));
+            continue;
+        }
+        slot[0] = 1.0f;
+        slot[1] = (pos.x - player->position.x) * inv_range;
+        slot[2] = (pos.y - player->position.y) * inv_range;
+        slot[3] = radius * inv_range;
+        slot[4] = (hp_max > 0.0f) ? hp / hp_max : 0.0f;
+    }
+}
+
+static void StepRange(void *user, int begin, int end)
+{
+    const StepJob *job = (const StepJob *)user;
+    VecEnv *env = job->env;
+    for (int i = begin; i < end; i++)
+    {
+        World *world = &env->worlds[i];
+        InputSnapshot input = ActionInput(world, job->actions[i]);
+        World_Step(world, &input, SIM_DT);
+
+        job->rewards[i] = world->step_damage * VEC_ENV_DAMAGE_REWARD +
+                          (float)world->step_destroyed * VEC_ENV_DESTROY_REWARD;
+        int done = world->tick >= (uint64_t)env->max_steps;
+        job->dones[i] = done ? 1.0f : 0.0f;
+        if (done)
+        {
+            env->episodes[i]++;
+            StartEpisode(env, i);
+        }
+        WriteObservation(world, job->obs + (size_t)i * VEC_ENV_OBS_DIM);
+    }
+}
+
+static void ResetRange(void *user, int begin, int end)
+{
+    const StepJob *job = (const StepJob *)user;
+    for (int i = begin; i < end; i++)
+    {
+        StartEpisode(job->env, i);
+        if (job->obs != NULL) WriteObservation(&job->env->worlds[i], job->obs + (size_t)i * VEC_ENV_OBS_DIM);
+    }
+}
+
+static int WorldGrain(const VecEnv *env)
+{
+    int jobs = JobSystem_ThreadCount(&env->jobs) * VEC_ENV_JOBS_PER_THREAD;
+    int grain = (env->world_count + jobs - 1) / jobs;
+    return (grain > 0) ? grain : 1;
+}
+
+int VecEnv_Create(VecEnv *env, const VecEnvConfig *config)
+{
+    memset(env, 0, sizeof(*env));
+    if (config->world_count <= 0) return 0;
+    env->max_steps = (config->max_steps > 0) ? config->max_steps : VEC_ENV_DEFAULT_MAX_STEPS;
+    env->field_asteroids = config->field_asteroids;
+    env->seed = config->seed;
+
+    World_Init(&env->assets, config->seed, 1, NULL);
+    env->worlds = (World *)calloc((size_t)config->world_count, sizeof(World));
+    env->episodes = (uint32_t *)calloc((size_t)config->world_count, sizeof(uint32_t));
+    if (env->assets.asteroids.asset_count <= 0 || env->worlds == NULL || env->episodes == NULL)
+    {
+        VecEnv_Destroy(env);
+        return 0;
+    }
+
+    for (int i = 0; i < config->world_count; i++)
+    {
+        World_InitShared(&env->worlds[i], 0u, &env->assets);
+    }
+    env->world_count = config->world_count;
+    JobSystem_Init(&env->jobs, config->threads);
+    VecEnv_Reset(env, config->seed, NULL);
+    return 1;
+}
+
+void VecEnv_Reset(VecEnv *env, unsigned int seed, float *obs)
+{
+    env->seed = seed;
+    memset(env->episodes, 0, (size_t)env->world_count * sizeof(uint32_t));
+    StepJob job = { env, NULL, obs, NULL, NULL };
+    JobSystem_ParallelFor(&env->jobs, env->world_count, WorldGrain(env), ResetRange, &job);
+}
+
+void VecEnv_Step(VecEnv *env, const int *actions, float *obs, float *rewards, float *dones)
+{
+    StepJob job = { env, actions, obs, rewards, dones };
+    JobSystem_ParallelFor(&env->jobs, env->world_count, WorldGrain(env), StepRange, &job);
+}
+
+void VecEnv_Destroy(VecEnv *env)
+{
+    for (int i = 0; i < env->world_count; i++)
+    {
+        World_Unload(&env->worlds[i]);
+    }
+    World_Unload(&env->assets);
+    if (env->world_count > 0) JobSystem_Shutdown(&env->jobs);
+    free(env->worlds);
+    free(env->episodes);
+    memset(env, 0, sizeof(*env));
+}
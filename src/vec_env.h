@@ -0,0 +1,70 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <stdint.h>
+
+#include "job_system.h"
+#include "world.h"
+
+// Vectorised RL environment: M independent headless worlds stepped together.
+// Each step takes one discrete action per world and writes observations,
+// rewards and done flags into caller-owned contiguous buffers:
+//   obs[M * VEC_ENV_OBS_DIM], rewards[M], dones[M]
+// Worlds are sharded across the env's job system, and each world is stepped
+// by exactly one thread, so results do not depend on the thread count.
+//
+// A world whose episode ends is reset inside the same step: its done flag is
+// 1, its reward belongs to the final tick, and its observation is already the
+// first one of the next episode.
+
+// Actions: 0 = idle, 1..8 = move N, NE, E, SE, S, SW, W, NW; add
+// VEC_ENV_MOVE_ACTIONS to boost. Out-of-range actions are treated as idle.
+#define VEC_ENV_MOVE_ACTIONS 9
+#define VEC_ENV_ACTION_COUNT (2 * VEC_ENV_MOVE_ACTIONS)
+
+// Observation: player x, y mapped to [-1, 1] over the map, beam active flag,
+// beam hit distance / beam range; then VEC_ENV_NEAREST asteroid slots,
+// nearest first, of (present, dx, dy, radius, hp / hp_max) with dx, dy and
+// radius divided by VEC_ENV_SENSOR_RANGE. Empty slots are all zero.
+#define VEC_ENV_NEAREST 8
+#define VEC_ENV_SLOT_DIM 5
+#define VEC_ENV_OBS_DIM (4 + VEC_ENV_NEAREST * VEC_ENV_SLOT_DIM)
+#define VEC_ENV_SENSOR_RANGE 1200.0f
+
+#define VEC_ENV_DEFAULT_MAX_STEPS 3600
+
+typedef struct VecEnvConfig
+{
+    int world_count;
+    // Job system size (including the calling thread).
+    int threads;
+    unsigned int seed;
+    // Episode length in ticks; <= 0 uses VEC_ENV_DEFAULT_MAX_STEPS.
+    int max_steps;
+    // Rocks spawned around the ship at the start of every episode.
+    int field_asteroids;
+} VecEnvConfig;
+
+typedef struct VecEnv
+{
+    // Loads the asteroid masks once for every world; never stepped.
+    World assets;
+    World *worlds;
+    uint32_t *episodes;
+    int world_count;
+    int max_steps;
+    int field_asteroids;
+    unsigned int seed;
+    JobSystem jobs;
+} VecEnv;
+
+// Returns 0 if the worlds could not be created (e.g. no asteroid masks found:
+// run from the repository root). Call VecEnv_Reset for the first observations.
+int VecEnv_Create(VecEnv *env, const VecEnvConfig *config);
+// Starts a fresh episode in every world. Episode e of world i is seeded from
+// (seed, i, e), so a run is reproducible from its seed alone. obs may be NULL.
+void VecEnv_Reset(VecEnv *env, unsigned int seed, float *obs);
+void VecEnv_Step(VecEnv *env, const int *actions, float *obs, float *rewards, float *dones);
+void VecEnv_Destroy(VecEnv *env);
+
+#endif
@@ -0,0 +1,161 @@
+#include "world.h"
+
+#include <string.h>
+
+#include "profiler.h"
+
+#define WORLD_MAP_WIDTH 5000.0f
+#define WORLD_MAP_HEIGHT 3000.0f
+
+static const Vector2 WORLD_PLAYER_START = { WORLD_MAP_WIDTH * 0.5f, WORLD_MAP_HEIGHT * 0.5f };
+
+static void InitState(World *world, unsigned int seed)
+{
+    *world = (World){0};
+    world->seed = seed;
+    world->map_bounds = (Rectangle){ 0.0f, 0.0f, WORLD_MAP_WIDTH, WORLD_MAP_HEIGHT };
+    world->beam_range = 180.0f;
+    world->beam_dps = 30.0f;
+    world->popup_interval = 0.18f;
+    Player_Init(&world->player, WORLD_PLAYER_START);
+}
+
+void World_Init(World *world, unsigned int seed, int headless, JobSystem *jobs)
+{
+    InitState(world, seed);
+    Asteroids_Init(&world->asteroids, ASTEROID_DEFAULT_DIRECTORY, !headless, seed);
+    world->asteroids.jobs = jobs;
+    if (!headless) Player_LoadAssets(&world->player);
+}
+
+void World_InitAsync(World *world, unsigned int seed, JobSystem *jobs, AssetLoader *loader)
+{
+    InitState(world, seed);
+    Asteroids_InitAsync(&world->asteroids, ASTEROID_DEFAULT_DIRECTORY, loader, seed);
+    world->asteroids.jobs = jobs;
+    Player_LoadAssetsAsync(&world->player, loader);
+}
+
+void World_InitShared(World *world, unsigned int seed, const World *source)
+{
+    InitState(world, seed);
+    Asteroids_InitShared(&world->asteroids, &source->asteroids, seed);
+}
+
+void World_Reset(World *world, unsigned int seed)
+{
+    world->seed = seed;
+    world->tick = 0;
+    world->time = 0.0;
+    world->popup_timer = 0.0f;
+    world->beam_active = 0;
+    world->beam_target = ENTITY_HANDLE_NULL;
+    world->step_damage = 0.0f;
+    world->step_destroyed = 0;
+    // Only the simulated part of the player; textures and clips stay.
+    world->player.position = WORLD_PLAYER_START;
+    world->player.angle = 0.0f;
+    world->player.boosting = false;
+    Asteroids_Reset(&world->asteroids, seed);
+}
+
+void World_Step(World *world, const InputSnapshot *input, float dt)
+{
+    PROFILE_BEGIN("world_step");
+    PROFILE_BEGIN("player_update");
+    Player_Update(&world->player, input, dt, world->map_bounds);
+    PROFILE_END();
+    PROFILE_BEGIN("asteroids_update");
+    Asteroids_Update(&world->asteroids, dt, world->player.position);
+    PROFILE_END();
+    world->popup_timer -= dt;
+
+    PROFILE_BEGIN("beam");
+
+    // Auto-aim at the closest rock, then let the beam hit whatever solid
+    // pixel is actually first along that line (possibly a nearer rock).
+    world->beam_active = 0;
+    world->beam_target = ENTITY_HANDLE_NULL;
+    world->step_damage = 0.0f;
+    world->step_destroyed = 0;
+    AsteroidHandle aim = Asteroids_FindClosest(&world->asteroids, world->player.position, world->beam_range, NULL);
+    Vector2 aim_pos;
+    AsteroidRayHit hit;
+    if (Asteroids_GetInfo(&world->asteroids, aim, &aim_pos, NULL))
+    {
+        Vector2 dir = { aim_pos.x - world->player.position.x, aim_pos.y - world->player.position.y };
+        world->beam_active = Asteroids_Raycast(&world->asteroids, world->player.position, dir, world->beam_range, &hit);
+    }
+    if (world->beam_active)
+    {
+        world->beam_target = hit.handle;
+        world->beam_target_pos = hit.point;
+        world->beam_target_dist = hit.distance;
+        float damage = world->beam_dps * dt;
+        int destroyed = Asteroids_ApplyDamage(&world->asteroids, world->beam_target, damage);
+        world->step_damage = damage;
+        world->step_destroyed = destroyed;
+
+        if (world->popup_timer <= 0.0f)
+        {
+            Asteroids_AddPopup(&world->asteroids, world->beam_target_pos, damage * 10.0f);
+            world->popup_timer = world->popup_interval;
+        }
+
+        if (destroyed) world->beam_active = 0;
+    }
+    PROFILE_END();
+
+    world->tick++;
+    world->time += dt;
+    PROFILE_END();
+}
+
+static uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t HashFloat(uint64_t hash, float value)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return HashBytes(hash, &bits, sizeof(bits));
+}
+
+uint64_t World_Checksum(const World *world)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = HashBytes(hash, &world->tick, sizeof(world->tick));
+    hash = HashFloat(hash, world->player.position.x);
+    hash = HashFloat(hash, world->player.position.y);
+    hash = HashBytes(hash, &world->beam_active, sizeof(world->beam_active));
+
+    const AsteroidSystem *system = &world->asteroids;
+    int count = Asteroids_Count(system);
+    hash = HashBytes(hash, &count, sizeof(count));
+    const AsteroidColumns *c = &system->columns;
+    for (int i = 0; i < count; i++)
+    {
+        hash = HashFloat(hash, c->pos_x[i]);
+        hash = HashFloat(hash, c->pos_y[i]);
+        hash = HashFloat(hash, c->vel_x[i]);
+        hash = HashFloat(hash, c->vel_y[i]);
+        hash = HashFloat(hash, c->scale[i]);
+        hash = HashFloat(hash, c->hp[i]);
+        hash = HashBytes(hash, &c->asset_index[i], sizeof(c->asset_index[i]));
+    }
+    return hash;
+}
+
+void World_Unload(World *world)
+{
+    Player_Unload(&world->player);
+    Asteroids_Unload(&world->asteroids);
+}
@@ -0,0 +1,55 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stdint.h>
+
+#include "raylib.h"
+#include "input.h"
+#include "player.h"
+#include "asteroids.h"
+
+#define SIM_DT (1.0f / 60.0f)
+
+// Everything the simulation owns. Systems step through World_Step only, so the
+// same code drives the windowed game and the headless runner.
+typedef struct World
+{
+    Player player;
+    AsteroidSystem asteroids;
+    Rectangle map_bounds;
+    unsigned int seed;
+    uint64_t tick;
+    // Simulated seconds since the start; the clock animations sample.
+    double time;
+
+    float beam_range;
+    float beam_dps;
+    float popup_timer;
+    float popup_interval;
+    int beam_active;
+    // Asteroid the beam hit this tick, the hit point on its mask and the
+    // distance from the player to it.
+    AsteroidHandle beam_target;
+    Vector2 beam_target_pos;
+    float beam_target_dist;
+    // Beam damage dealt and asteroids destroyed by the last step.
+    float step_damage;
+    int step_destroyed;
+} World;
+
+// jobs may be NULL (single-threaded); the world does not own it.
+void World_Init(World *world, unsigned int seed, int headless, JobSystem *jobs);
+// Windowed World_Init whose assets stream in through loader (see
+// Asteroids_InitAsync). world must stay in place until the loader is freed,
+// and the loader must be freed before World_Unload.
+void World_InitAsync(World *world, unsigned int seed, JobSystem *jobs, AssetLoader *loader);
+// Headless world that borrows source's asteroid assets (see
+// Asteroids_InitShared); source must outlive it.
+void World_InitShared(World *world, unsigned int seed, const World *source);
+// Restarts the simulation from seed without reloading or reallocating.
+void World_Reset(World *world, unsigned int seed);
+void World_Step(World *world, const InputSnapshot *input, float dt);
+uint64_t World_Checksum(const World *world);
+void World_Unload(World *world);
+
+#endif
@@ -0,0 +1,335 @@
+#include "world_state.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memory.h"
+
+#define WORLD_STATE_FILE_MAGIC 0x46445357u /* "WSDF" */
+#define WORLD_STATE_FILE_VERSION 1u
+#define WORLD_STATE_FILE_DELTA 1u
+// Shorter zero runs stay inside literals; a run costs two varints.
+#define WORLD_STATE_MIN_ZERO_RUN 4
+
+typedef struct WorldStateFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t state_version;
+    uint64_t state_size;
+    uint64_t state_hash;
+    uint64_t base_size;
+    uint64_t base_hash;
+} WorldStateFileHeader;
+
+int WorldState_Capture(WorldState *state, const World *world)
+{
+    const AsteroidSystem *asteroids = &world->asteroids;
+    AsteroidState lengths = {0};
+    lengths.count = asteroids->pool.count;
+    lengths.slot_count = asteroids->pool.slot_count;
+    lengths.free_count = asteroids->pool.free_count;
+    lengths.popup_count = asteroids->popup_count;
+    lengths.sector_count = asteroids->sectors.sector_count;
+    lengths.dirty_count = asteroids->sectors.dirty_count;
+    size_t size = sizeof(WorldStateHeader) + Asteroids_StateArraySize(&lengths);
+    if (size > state->capacity)
+    {
+        unsigned char *grown = (unsigned char *)realloc(state->data, size);
+        if (grown == NULL) return 0;
+        state->data = grown;
+        state->capacity = size;
+    }
+
+    const Player *player = &world->player;
+    WorldStateHeader header = {0};
+    header.magic = WORLD_STATE_MAGIC;
+    header.version = WORLD_STATE_VERSION;
+    header.size = size;
+    header.tick = world->tick;
+    header.time = world->time;
+    header.seed = world->seed;
+    header.player_position = player->position;
+    header.player_size = player->size;
+    header.player_speed = player->speed;
+    header.player_boost_speed = player->boost_speed;
+    header.player_angle = player->angle;
+    header.player_boosting = player->boosting;
+    header.beam_range = world->beam_range;
+    header.beam_dps = world->beam_dps;
+    header.popup_timer = world->popup_timer;
+    header.popup_interval = world->popup_interval;
+    header.beam_active = world->beam_active;
+    header.beam_target = world->beam_target;
+    header.beam_target_pos = world->beam_target_pos;
+    header.beam_target_dist = world->beam_target_dist;
+    header.step_damage = world->step_damage;
+    header.step_destroyed = world->step_destroyed;
+    Asteroids_SaveState(asteroids, &header.asteroids, state->data + sizeof(header));
+    memcpy(state->data, &header, sizeof(header));
+    state->size = size;
+    return 1;
+}
+
+int WorldState_Restore(World *world, const WorldState *state)
+{
+    WorldStateHeader header;
+    if (state->size < sizeof(header)) return 0;
+    memcpy(&header, state->data, sizeof(header));
+    if (header.magic != WORLD_STATE_MAGIC || header.version != WORLD_STATE_VERSION || header.size != state->size ||
+        header.asteroids.count < 0 || header.asteroids.slot_count < 0 || header.asteroids.free_count < 0 ||
+        header.asteroids.popup_count < 0 ||
+        sizeof(header) + Asteroids_StateArraySize(&header.asteroids) != state->size)
+    {
+        return 0;
+    }
+    if (!Asteroids_LoadState(&world->asteroids, &header.asteroids, state->data + sizeof(header))) return 0;
+
+    Player *player = &world->player;
+    world->tick = header.tick;
+    world->time = header.time;
+    world->seed = header.seed;
+    player->position = header.player_position;
+    player->size = header.player_size;
+    player->speed = header.player_speed;
+    player->boost_speed = header.player_boost_speed;
+    player->angle = header.player_angle;
+    player->boosting = header.player_boosting != 0;
+    world->beam_range = header.beam_range;
+    world->beam_dps = header.beam_dps;
+    world->popup_timer = header.popup_timer;
+    world->popup_interval = header.popup_interval;
+    world->beam_active = header.beam_active;
+    world->beam_target = header.beam_target;
+    world->beam_target_pos = header.beam_target_pos;
+    world->beam_target_dist = header.beam_target_dist;
+    world->step_damage = header.step_damage;
+    world->step_destroyed = header.step_destroyed;
+    return 1;
+}
+
+void WorldState_Free(WorldState *state)
+{
+    free(state->data);
+    *state = (WorldState){0};
+}
+
+static uint64_t HashBytes(const unsigned char *bytes, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static unsigned char BaseByte(const WorldState *base, size_t i)
+{
+    return (base != NULL && i < base->size) ? base->data[i] : 0;
+}
+
+// Byte offset in the state of position p in the coded stream. The stream
+// holds byte 0 of every 4-byte word, then byte 1, and so on (the tail past the
+// last whole word comes last), so the unchanged high bytes of floats and ints
+// that moved a little form long zero runs after the XOR.
+static size_t StreamOffset(size_t p, size_t size)
+{
+    size_t words = size / 4;
+    if (p >= words * 4) return p;
+    return (p % words) * 4 + p / words;
+}
+
+static unsigned char *PutVarint(unsigned char *out, uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        *out++ = (unsigned char)(value | 0x80u);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+static int GetVarint(const unsigned char **in, const unsigned char *end, uint64_t *value)
+{
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *in < end; shift += 7)
+    {
+        unsigned char byte = *(*in)++;
+        result |= (uint64_t)(byte & 0x7fu) << shift;
+        if ((byte & 0x80u) == 0)
+        {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static size_t ZeroRun(const unsigned char *diff, size_t i, size_t size)
+{
+    size_t start = i;
+    while (i < size && diff[i] == 0) i++;
+    return i - start;
+}
+
+size_t WorldState_Encode(const WorldState *state, const WorldState *base, unsigned char **out, size_t *out_capacity)
+{
+    // Worst case: every byte a literal, plus one varint pair per literal run.
+    size_t bound = sizeof(WorldStateFileHeader) + state->size + state->size / WORLD_STATE_MIN_ZERO_RUN * 2 + 32;
+    if (bound > *out_capacity)
+    {
+        unsigned char *grown = (unsigned char *)realloc(*out, bound);
+        if (grown == NULL) return 0;
+        *out = grown;
+        *out_capacity = bound;
+    }
+    unsigned char *diff = (unsigned char *)malloc(state->size > 0 ? state->size : 1);
+    if (diff == NULL) return 0;
+    for (size_t p = 0; p < state->size; p++)
+    {
+        size_t i = StreamOffset(p, state->size);
+        diff[p] = state->data[i] ^ BaseByte(base, i);
+    }
+
+    WorldStateFileHeader header = {0};
+    header.magic = WORLD_STATE_FILE_MAGIC;
+    header.version = WORLD_STATE_FILE_VERSION;
+    header.flags = (base != NULL) ? WORLD_STATE_FILE_DELTA : 0u;
+    header.state_version = WORLD_STATE_VERSION;
+    header.state_size = state->size;
+    header.state_hash = HashBytes(state->data, state->size);
+    if (base != NULL)
+    {
+        header.base_size = base->size;
+        header.base_hash = HashBytes(base->data, base->size);
+    }
+    memcpy(*out, &header, sizeof(header));
+
+    // Body: (zero run, literal length, literal bytes) until state->size.
+    unsigned char *cursor = *out + sizeof(header);
+    size_t p = 0;
+    while (p < state->size)
+    {
+        size_t zeros = ZeroRun(diff, p, state->size);
+        p += zeros;
+        size_t literal_start = p;
+        while (p < state->size)
+        {
+            size_t run = ZeroRun(diff, p, state->size);
+            if (run >= WORLD_STATE_MIN_ZERO_RUN || p + run == state->size) break;
+            p += (run > 0) ? run : 1;
+        }
+        cursor = PutVarint(cursor, zeros);
+        cursor = PutVarint(cursor, p - literal_start);
+        memcpy(cursor, diff + literal_start, p - literal_start);
+        cursor += p - literal_start;
+    }
+    free(diff);
+    return (size_t)(cursor - *out);
+}
+
+int WorldState_Decode(WorldState *state, const WorldState *base, const unsigned char *data, size_t size)
+{
+    WorldStateFileHeader header;
+    if (size < sizeof(header)) return 0;
+    memcpy(&header, data, sizeof(header));
+    int delta = (header.flags & WORLD_STATE_FILE_DELTA) != 0;
+    if (header.magic != WORLD_STATE_FILE_MAGIC || header.version != WORLD_STATE_FILE_VERSION ||
+        header.state_version != WORLD_STATE_VERSION || header.state_size > (uint64_t)SIZE_MAX)
+    {
+        return 0;
+    }
+    if (delta && (base == NULL || header.base_size != base->size ||
+                  header.base_hash != HashBytes(base->data, base->size)))
+    {
+        return 0;
+    }
+    if (!delta) base = NULL;
+
+    size_t state_size = (size_t)header.state_size;
+    unsigned char *diff = (unsigned char *)calloc(state_size > 0 ? state_size : 1, 1);
+    if (diff == NULL) return 0;
+    const unsigned char *in = data + sizeof(header);
+    const unsigned char *end = data + size;
+    size_t p = 0;
+    int ok = 1;
+    while (ok && p < state_size)
+    {
+        uint64_t zeros = 0;
+        uint64_t literal = 0;
+        if (!GetVarint(&in, end, &zeros) || !GetVarint(&in, end, &literal) || zeros > state_size - p ||
+            literal > state_size - p - zeros || literal > (uint64_t)(end - in))
+        {
+            ok = 0;
+            break;
+        }
+        p += zeros;
+        memcpy(diff + p, in, literal);
+        in += literal;
+        p += literal;
+    }
+    if (ok && state_size > state->capacity)
+    {
+        unsigned char *grown = (unsigned char *)realloc(state->data, state_size);
+        if (grown == NULL) ok = 0;
+        else
+        {
+            state->data = grown;
+            state->capacity = state_size;
+        }
+    }
+    if (ok)
+    {
+        for (p = 0; p < state_size; p++)
+        {
+            size_t i = StreamOffset(p, state_size);
+            state->data[i] = diff[p] ^ BaseByte(base, i);
+        }
+        state->size = state_size;
+        ok = HashBytes(state->data, state_size) == header.state_hash;
+    }
+    free(diff);
+    return ok;
+}
+
+int WorldState_Write(const WorldState *state, const WorldState *base, const char *path)
+{
+    unsigned char *encoded = NULL;
+    size_t capacity = 0;
+    size_t size = WorldState_Encode(state, base, &encoded, &capacity);
+    FILE *file = (size > 0) ? fopen(path, "wb") : NULL;
+    int ok = file != NULL && fwrite(encoded, 1, size, file) == size;
+    if (file != NULL && fclose(file) != 0) ok = 0;
+    free(encoded);
+    return ok;
+}
+
+int WorldState_Read(WorldState *state, const WorldState *base, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    unsigned char *data = NULL;
+    int capacity = 0;
+    size_t size = 0;
+    int ok = 1;
+    for (;;)
+    {
+        if (!Memory_GrowArray((void **)&data, &capacity, (int)size + 65536, 1, 65536))
+        {
+            ok = 0;
+            break;
+        }
+        size_t got = fread(data + size, 1, (size_t)capacity - size, file);
+        size += got;
+        if (got == 0) break;
+    }
+    fclose(file);
+    ok = ok && WorldState_Decode(state, base, data, size);
+    free(data);
+    return ok;
+}
@@ -0,0 +1,79 @@
+#ifndef WORLD_STATE_H
+#define WORLD_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "world.h"
+
+// Save states: the pure simulation state of a World (player kinematics,
+// asteroid columns and pool, popups, spawn/beam/popup timers, random
+// streams, tuning) in one flat, pointer-free buffer, so capturing or
+// restoring is a handful of memcpys. Assets, textures, the job system and
+// derived indexes are not part of it; a state restores into any world with
+// the same assets loaded.
+//
+// Buffer layout: WorldStateHeader, then the asteroid arrays
+// (Asteroids_SaveState). It is only valid within one build; the file format
+// below is versioned.
+
+#define WORLD_STATE_MAGIC 0x54535357u /* "WSST" */
+#define WORLD_STATE_VERSION 6u
+
+typedef struct WorldStateHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;
+    uint64_t tick;
+    double time;
+    uint32_t seed;
+
+    Vector2 player_position;
+    Vector2 player_size;
+    float player_speed;
+    float player_boost_speed;
+    float player_angle;
+    int32_t player_boosting;
+
+    float beam_range;
+    float beam_dps;
+    float popup_timer;
+    float popup_interval;
+    int32_t beam_active;
+    EntityHandle beam_target;
+    Vector2 beam_target_pos;
+    float beam_target_dist;
+    float step_damage;
+    int32_t step_destroyed;
+
+    AsteroidState asteroids;
+} WorldStateHeader;
+
+typedef struct WorldState
+{
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} WorldState;
+
+// Returns 0 on allocation failure. Does not allocate once state has held a
+// snapshot of this size.
+int WorldState_Capture(WorldState *state, const World *world);
+// Returns 0 (world unchanged) if state is not a valid snapshot or refers to
+// assets world does not have.
+int WorldState_Restore(World *world, const WorldState *state);
+void WorldState_Free(WorldState *state);
+
+// On disk: a small header, then the state XORed with base (or with nothing)
+// and run-length coded, so consecutive snapshots cost little more than what
+// changed between them. A delta file names its base by hash and only reads
+// back against that base. Both return 0 on I/O or format errors.
+int WorldState_Write(const WorldState *state, const WorldState *base, const char *path);
+int WorldState_Read(WorldState *state, const WorldState *base, const char *path);
+// In-memory versions of the above, for measuring and for callers that keep
+// deltas themselves. Encode returns the encoded size, 0 on failure.
+size_t WorldState_Encode(const WorldState *state, const WorldState *base, unsigned char **out, size_t *out_capacity);
+int WorldState_Decode(WorldState *state, const WorldState *base, const unsigned char *data, size_t size);
+
+#endif
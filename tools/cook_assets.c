@@ -0,0 +1,359 @@
+// Offline asset cooker: decodes every PNG under the asset root once and writes
+// a pack (see asset_pack.h) holding raw RGBA8 pixels, SpriteSheet frame tables
+// and the asteroid collision shapes and fracture tables, so startup only has
+// to mmap one file.
+// Run from the repository root.
+// Usage: cook_assets [--root DIR] [--out FILE]
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "asset_pack.h"
+#include "asteroids.h"
+#include "clock.h"
+#include "memory.h"
+
+#define COOK_PATH_MAX 512
+
+// Sheets whose frame size is not the "square frames, one row" default that
+// SpriteSheet_LoadAuto assumes.
+typedef struct CookSheet
+{
+    const char *path;
+    int frame_width;
+    int frame_height;
+} CookSheet;
+
+static const CookSheet COOK_SHEETS[] = {
+    { "Assets/Textures/Planets/PlanetSpriteSheet.png", 500, 500 },
+};
+
+typedef struct CookBuffer
+{
+    unsigned char *data;
+    int size;
+    int capacity;
+} CookBuffer;
+
+typedef struct CookList
+{
+    char (*paths)[COOK_PATH_MAX];
+    int count;
+    int capacity;
+} CookList;
+
+static int HasPngExtension(const char *name)
+{
+    size_t len = strlen(name);
+    return len >= 4 && strcmp(name + len - 4, ".png") == 0;
+}
+
+static int ComparePaths(const void *a, const void *b)
+{
+    return strcmp((const char *)a, (const char *)b);
+}
+
+static void CollectPngs(CookList *list, const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (dir == NULL) return;
+    struct dirent *entry = NULL;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.') continue;
+        char path[COOK_PATH_MAX];
+        if (snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name) >= (int)sizeof(path)) continue;
+
+        struct stat info;
+        if (stat(path, &info) != 0) continue;
+        if (S_ISDIR(info.st_mode))
+        {
+            CollectPngs(list, path);
+            continue;
+        }
+        if (!HasPngExtension(entry->d_name)) continue;
+        if (!Memory_GrowArray((void **)&list->paths, &list->capacity, list->count + 1, sizeof(list->paths[0]), 64)) break;
+        memcpy(list->paths[list->count++], path, sizeof(path));
+    }
+    closedir(dir);
+}
+
+// Appends size bytes at the next ASSET_PACK_ALIGN boundary; returns the
+// offset within the buffer, or -1 on allocation failure.
+static long long AppendAligned(CookBuffer *buffer, const void *data, size_t size)
+{
+    int start = (buffer->size + ASSET_PACK_ALIGN - 1) / ASSET_PACK_ALIGN * ASSET_PACK_ALIGN;
+    if (!Memory_GrowArray((void **)&buffer->data, &buffer->capacity, start + (int)size, 1, 1 << 20)) return -1;
+    memset(buffer->data + buffer->size, 0, (size_t)(start - buffer->size));
+    if (size > 0) memcpy(buffer->data + start, data, size);
+    buffer->size = start + (int)size;
+    return start;
+}
+
+static int WriteMask(CookBuffer *blobs, uint64_t blob_base, const BitMask *mask, int block, AssetPackMask *out)
+{
+    size_t bytes = (size_t)mask->words_per_row * (size_t)mask->height * sizeof(uint64_t);
+    long long offset = AppendAligned(blobs, mask->bits, bytes);
+    if (offset < 0) return 0;
+    *out = (AssetPackMask){ mask->width, mask->height, mask->words_per_row,
+                            mask->min_x, mask->min_y, mask->max_x, mask->max_y, block,
+                            (bytes > 0) ? blob_base + (uint64_t)offset : 0u };
+    return 1;
+}
+
+static int WriteShapes(CookBuffer *blobs, uint64_t blob_base, const CollisionShape *shapes, uint32_t *out_count,
+                       uint64_t *out_offset)
+{
+    AssetPackShape packed[ASTEROID_SCALE_BUCKETS];
+    memset(packed, 0, sizeof(packed));
+    for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++)
+    {
+        const CollisionShape *shape = &shapes[b];
+        if (!WriteMask(blobs, blob_base, &shape->fine, 1, &packed[b].fine)) return 0;
+        for (int l = 0; l < COLLISION_SHAPE_LEVELS; l++)
+        {
+            const CollisionLevel *level = &shape->levels[l];
+            if (!WriteMask(blobs, blob_base, &level->any, level->block, &packed[b].levels[l][0]) ||
+                !WriteMask(blobs, blob_base, &level->any_dilated, level->block, &packed[b].levels[l][1]) ||
+                !WriteMask(blobs, blob_base, &level->all, level->block, &packed[b].levels[l][2]))
+            {
+                return 0;
+            }
+        }
+        packed[b].circle_x = shape->circle_x;
+        packed[b].circle_y = shape->circle_y;
+        packed[b].circle_radius = shape->circle_radius;
+        packed[b].area = shape->area;
+        if (shape->sdf != NULL)
+        {
+            size_t bytes = (size_t)shape->sdf_width * (size_t)shape->sdf_height * sizeof(int16_t);
+            long long sdf_offset = AppendAligned(blobs, shape->sdf, bytes);
+            if (sdf_offset < 0) return 0;
+            packed[b].sdf = (AssetPackSdf){ shape->sdf_x, shape->sdf_y, shape->sdf_width, shape->sdf_height,
+                                            blob_base + (uint64_t)sdf_offset };
+        }
+        memcpy(packed[b].outline_x, shape->outline_x, sizeof(packed[b].outline_x));
+        memcpy(packed[b].outline_y, shape->outline_y, sizeof(packed[b].outline_y));
+        packed[b].outline_count = shape->outline_count;
+    }
+    long long offset = AppendAligned(blobs, packed, sizeof(packed));
+    if (offset < 0) return 0;
+    *out_count = ASTEROID_SCALE_BUCKETS;
+    *out_offset = blob_base + (uint64_t)offset;
+    return 1;
+}
+
+// Cuts an asteroid the way the loader would and appends every piece's pixels
+// and shapes, then the table. Pieces whose shapes fail to bake keep no
+// shapes (the loader skips them too). Adds the piece count to *pieces.
+static int WriteFracture(CookBuffer *blobs, uint64_t blob_base, const Image *image, AssetPackEntry *entry, int *pieces)
+{
+    FractureTable table;
+    if (!Fracture_Build(&table, image, ASTEROID_MASK_THRESHOLD)) return 1;
+
+    AssetPackFracture packed;
+    memset(&packed, 0, sizeof(packed));
+    packed.area = table.area;
+    packed.centroid_x = table.centroid_x;
+    packed.centroid_y = table.centroid_y;
+    packed.piece_count = table.piece_count;
+    int ok = 1;
+    for (int p = 0; p < table.piece_count && ok; p++)
+    {
+        const FracturePiece *piece = &table.pieces[p];
+        AssetPackFragment *fragment = &packed.pieces[p];
+        *fragment = (AssetPackFragment){ .x = piece->x, .y = piece->y, .width = piece->width,
+                                         .height = piece->height, .area = piece->area,
+                                         .centroid_x = piece->centroid_x, .centroid_y = piece->centroid_y };
+        Image cut = Fracture_PieceImage(&table, image, p);
+        if (cut.data == NULL)
+        {
+            ok = 0;
+            break;
+        }
+        long long offset = AppendAligned(blobs, cut.data, (size_t)cut.width * (size_t)cut.height * 4u);
+        ok = offset >= 0;
+        if (ok) fragment->pixels_offset = blob_base + (uint64_t)offset;
+
+        CollisionShape shapes[ASTEROID_SCALE_BUCKETS];
+        if (ok && Asteroids_BakeShapes(shapes, &cut))
+        {
+            ok = WriteShapes(blobs, blob_base, shapes, &fragment->shape_count, &fragment->shapes_offset);
+            for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++) CollisionShape_Free(&shapes[b]);
+        }
+        UnloadImage(cut);
+    }
+    Fracture_Free(&table);
+    if (!ok) return 0;
+
+    long long offset = AppendAligned(blobs, &packed, sizeof(packed));
+    if (offset < 0) return 0;
+    entry->fracture_offset = blob_base + (uint64_t)offset;
+    *pieces += packed.piece_count;
+    return 1;
+}
+
+static void SetFrameTable(AssetPackEntry *entry, const char *path)
+{
+    int frame_width = entry->height;
+    int frame_height = entry->height;
+    for (size_t i = 0; i < sizeof(COOK_SHEETS) / sizeof(COOK_SHEETS[0]); i++)
+    {
+        if (strcmp(COOK_SHEETS[i].path, path) != 0) continue;
+        frame_width = COOK_SHEETS[i].frame_width;
+        frame_height = COOK_SHEETS[i].frame_height;
+    }
+    if (frame_width <= 0 || frame_height <= 0) return;
+    entry->frame_width = frame_width;
+    entry->frame_height = frame_height;
+    entry->frame_columns = (entry->width / frame_width > 0) ? entry->width / frame_width : 1;
+    entry->frame_rows = (entry->height / frame_height > 0) ? entry->height / frame_height : 1;
+}
+
+// Only PNGs directly inside the asteroid directory get collision shapes.
+static int IsAsteroidAsset(const char *path)
+{
+    size_t dir_len = strlen(ASTEROID_DEFAULT_DIRECTORY);
+    return strncmp(path, ASTEROID_DEFAULT_DIRECTORY, dir_len) == 0 && path[dir_len] == '/' &&
+           strchr(path + dir_len + 1, '/') == NULL;
+}
+
+// entry_slots >= header->entry_count: the string table was placed after that
+// many entries; the spare slots are written as zeros.
+static int WritePack(const char *out_path, const AssetPackHeader *header, const AssetPackEntry *entries, int entry_slots,
+                     const char *strings, const CookBuffer *blobs, uint64_t blob_base)
+{
+    FILE *file = fopen(out_path, "wb");
+    if (file == NULL) return 0;
+    static const unsigned char zeros[ASSET_PACK_ALIGN] = {0};
+    int ok = fwrite(header, sizeof(*header), 1, file) == 1;
+    ok = ok && fwrite(zeros, 1, (size_t)(header->entries_offset - sizeof(*header)), file) == header->entries_offset - sizeof(*header);
+    ok = ok && fwrite(entries, sizeof(AssetPackEntry), (size_t)entry_slots, file) == (size_t)entry_slots;
+    ok = ok && fwrite(strings, 1, header->strings_size, file) == header->strings_size;
+    uint64_t written = header->strings_offset + header->strings_size;
+    ok = ok && fwrite(zeros, 1, (size_t)(blob_base - written), file) == blob_base - written;
+    ok = ok && (blobs->size == 0 || fwrite(blobs->data, 1, (size_t)blobs->size, file) == (size_t)blobs->size);
+    ok = (fclose(file) == 0) && ok;
+    return ok;
+}
+
+static uint64_t AlignUp(uint64_t value)
+{
+    return (value + ASSET_PACK_ALIGN - 1) / ASSET_PACK_ALIGN * ASSET_PACK_ALIGN;
+}
+
+int main(int argc, char **argv)
+{
+    const char *root = "Assets/Textures";
+    const char *out_path = ASSET_PACK_DEFAULT_PATH;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--root") == 0 && i + 1 < argc) root = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--root DIR] [--out FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    SetTraceLogLevel(LOG_WARNING);
+    double start = Clock_NowSeconds();
+
+    CookList list = {0};
+    CollectPngs(&list, root);
+    if (list.count > 0) qsort(list.paths, (size_t)list.count, sizeof(list.paths[0]), ComparePaths);
+
+    AssetPackEntry *entries = (AssetPackEntry *)calloc((size_t)(list.count > 0 ? list.count : 1), sizeof(AssetPackEntry));
+    char *strings = NULL;
+    int strings_size = 0;
+    int strings_capacity = 0;
+    if (entries == NULL) return 1;
+
+    // Layout up to the blobs depends only on the names, so lay that out
+    // first; blob offsets are then final as they are appended.
+    for (int i = 0; i < list.count; i++)
+    {
+        int length = (int)strlen(list.paths[i]);
+        if (!Memory_GrowArray((void **)&strings, &strings_capacity, strings_size + length + 1, 1, 4096)) return 1;
+        entries[i].name_offset = (uint32_t)strings_size;
+        entries[i].name_length = (uint32_t)length;
+        memcpy(strings + strings_size, list.paths[i], (size_t)length + 1);
+        strings_size += length + 1;
+    }
+    if (strings_size == 0)
+    {
+        fprintf(stderr, "cook_assets: no PNGs under %s\n", root);
+        return 1;
+    }
+
+    AssetPackHeader header = {0};
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.shape_key = Asteroids_ShapeKey();
+    header.entries_offset = AlignUp(sizeof(header));
+    header.strings_offset = header.entries_offset + (uint64_t)list.count * sizeof(AssetPackEntry);
+    header.strings_size = (uint64_t)strings_size;
+    uint64_t blob_base = AlignUp(header.strings_offset + header.strings_size);
+
+    CookBuffer blobs = {0};
+    int cooked = 0;
+    int shaped = 0;
+    int fragments = 0;
+    for (int i = 0; i < list.count; i++)
+    {
+        const char *path = list.paths[i];
+        AssetPackEntry *entry = &entries[cooked];
+        Image image = LoadImage(path);
+        if (image.data == NULL)
+        {
+            fprintf(stderr, "cook_assets: skipping %s (could not decode)\n", path);
+            continue;
+        }
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        *entry = (AssetPackEntry){ .name_offset = entries[i].name_offset, .name_length = entries[i].name_length,
+                                   .width = image.width, .height = image.height, .pixels_offset = 0 };
+        long long offset = AppendAligned(&blobs, image.data, (size_t)image.width * (size_t)image.height * 4u);
+        if (offset < 0) return 1;
+        entry->pixels_offset = blob_base + (uint64_t)offset;
+        SetFrameTable(entry, path);
+
+        if (IsAsteroidAsset(path))
+        {
+            CollisionShape shapes[ASTEROID_SCALE_BUCKETS];
+            if (Asteroids_BakeShapes(shapes, &image))
+            {
+                int written = WriteShapes(&blobs, blob_base, shapes, &entry->shape_count, &entry->shapes_offset);
+                for (int b = 0; b < ASTEROID_SCALE_BUCKETS; b++) CollisionShape_Free(&shapes[b]);
+                if (!written || !WriteFracture(&blobs, blob_base, &image, entry, &fragments)) return 1;
+                shaped++;
+            }
+        }
+        UnloadImage(image);
+        cooked++;
+    }
+
+    // Skipped files leave their names in the string table and a zeroed slot
+    // after the real entries; harmless, and those stay in name order.
+    memset(entries + cooked, 0, (size_t)(list.count - cooked) * sizeof(AssetPackEntry));
+    header.entry_count = (uint32_t)cooked;
+    header.file_size = blob_base + (uint64_t)blobs.size;
+    if (!WritePack(out_path, &header, entries, list.count, strings, &blobs, blob_base))
+    {
+        fprintf(stderr, "cook_assets: could not write %s\n", out_path);
+        return 1;
+    }
+
+    printf("cooked %d textures (%d with collision shapes, %d fragments) into %s: %.1f MB in %.0f ms\n",
+           cooked, shaped, fragments, out_path, (double)header.file_size / (1024.0 * 1024.0),
+           (Clock_NowSeconds() - start) * 1000.0);
+
+    free(blobs.data);
+    free(strings);
+    free(entries);
+    free(list.paths);
+    return 0;
+}